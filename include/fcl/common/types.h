@@ -53,6 +53,7 @@
 #include "fcl/cvx_collide/gjk.h"
 #include "fcl/cvx_collide/gjk_shape.h"
 #include "fcl/cvx_collide/mpr.h"
+#include "fcl/cvx_collide/mpr_batch.h"
 
 namespace fcl {
 
@@ -201,6 +202,8 @@ using MinkowskiDiff = ::fcl::cvx_collide::MinkowskiDiff<T>;
 
 template <typename T>
 using MPR = ::fcl::cvx_collide::MPR<T>;
+template <typename T, std::size_t N>
+using MPRBatch = ::fcl::cvx_collide::MPRBatch<T, N>;
 
 // EPA2 and GJK2 imply we are using the new algorithm implementation
 using ::fcl::cvx_collide::GJK_Status;
@@ -212,6 +215,8 @@ using GJK2 = ::fcl::cvx_collide::GJK<T>;
 using ::fcl::cvx_collide::EPA_Status;
 template <typename T>
 using EPA2 = ::fcl::cvx_collide::EPA<T>;
+template <typename T>
+using Polytope = ::fcl::cvx_collide::Polytope<T>;
 
 }  // namespace detail
 
@@ -31,14 +31,16 @@ class EPA {
   // The simplex (or gjk.simplex()) must contain the origin
   // The p_on_shape_0 and p_on_shape_1 are BOTH expressed IN SHAPE_0 frame
   // depth_if_penetration is POSITIVE
+  template <typename MinkowskiDiffT>
   EPA_Status Evaluate(const GJKSimplex<T>& simplex,
-                      const MinkowskiDiff<T>& shape, T* depth_if_penetration,
+                      const MinkowskiDiffT& shape, T* depth_if_penetration,
                       Vector3<T>* p_on_shape_0, Vector3<T>* p_on_shape_1,
                       Polytope<T>* external_polytope_cache = nullptr) const;
 
   // Testing method
+  template <typename MinkowskiDiffT>
   EPA_Status Test_EvaluateFromInitializedPolytope(
-      Polytope<T>& polytope, const MinkowskiDiff<T>& shape,
+      Polytope<T>& polytope, const MinkowskiDiffT& shape,
       T* depth_if_penetration, Vector3<T>* p_on_shape_0,
       Vector3<T>* p_on_shape_1) const;
 
@@ -49,22 +51,25 @@ class EPA {
 
  private:
   // Internal evaluation interface
+  template <typename MinkowskiDiffT>
   EPA_Status evaluateFromInitializedPolytope(Polytope<T>& polytope,
-                                             const MinkowskiDiff<T>& shape,
+                                             const MinkowskiDiffT& shape,
                                              T* depth_if_penetration,
                                              Vector3<T>* p_on_shape_0,
                                              Vector3<T>* p_on_shape_1) const;
+  template <typename MinkowskiDiffT>
   EPA_Status evaluateFromUnInitializedPolytope(const GJKSimplex<T>& simplex,
                                                Polytope<T>& polytope,
-                                               const MinkowskiDiff<T>& shape,
+                                               const MinkowskiDiffT& shape,
                                                T* depth_if_penetration,
                                                Vector3<T>* p_on_shape_0,
                                                Vector3<T>* p_on_shape_1) const;
 
   // Determine the explore direction
   enum class FindNextDirectionStatus { OK, Failed, Converge };
+  template <typename MinkowskiDiffT>
   FindNextDirectionStatus findNextSupportDirection(
-      const Polytope<T>& polytope, const MinkowskiDiff<T>& shape,
+      const Polytope<T>& polytope, const MinkowskiDiffT& shape,
       PolytopeElementBase* nearest_feature, T tolerance, Vector3<T>& next_d,
       Vector3<T>& next_v, PolytopeFace<T>** start_face) const;
 
@@ -76,21 +81,25 @@ class EPA {
   };
   static bool transformToRawFeature(const PolytopeElementBase* feature,
                                     RawFeature& raw_feature);
-  bool checkTerminateCondition(const MinkowskiDiff<T>& shape,
+  template <typename MinkowskiDiffT>
+  bool checkTerminateCondition(const MinkowskiDiffT& shape,
                                const RawFeature& nearest_feature,
                                const Vector3<T>& d, const Vector3<T>& new_v,
                                T tolerance) const;
-  void assignPenetrationPair(const MinkowskiDiff<T>& shape,
+  template <typename MinkowskiDiffT>
+  void assignPenetrationPair(const MinkowskiDiffT& shape,
                              const MinkowskiDiffVertex<T>& candidate_next_v,
                              const RawFeature& nearest_feature,
                              T* depth_if_penetration, Vector3<T>* p_on_shape_0,
                              Vector3<T>* p_on_shape_1) const;
-  bool assignPenetrationPairFromSegment(const MinkowskiDiff<T>& shape,
+  template <typename MinkowskiDiffT>
+  bool assignPenetrationPairFromSegment(const MinkowskiDiffT& shape,
                                         const RawFeature& nearest_edge_feature,
                                         T* depth_if_penetration,
                                         Vector3<T>* p_on_shape_0,
                                         Vector3<T>* p_on_shape_1) const;
-  bool assignPenetrationPairFromFace(const MinkowskiDiff<T>& shape,
+  template <typename MinkowskiDiffT>
+  bool assignPenetrationPairFromFace(const MinkowskiDiffT& shape,
                                      const RawFeature& nearest_face_feature,
                                      T* depth_if_penetration,
                                      Vector3<T>* p_on_shape_0,
@@ -8,8 +8,9 @@ namespace fcl {
 namespace cvx_collide {
 
 template <typename T>
+template <typename MinkowskiDiffT>
 typename EPA<T>::FindNextDirectionStatus EPA<T>::findNextSupportDirection(
-    const Polytope<T>& polytope, const MinkowskiDiff<T>& shape,
+    const Polytope<T>& polytope, const MinkowskiDiffT& shape,
     PolytopeElementBase* nearest_feature, T tolerance, Vector3<T>& next_d,
     Vector3<T>& next_v, PolytopeFace<T>** start_face) const {
   auto feature_type = nearest_feature->type;
@@ -113,9 +114,10 @@ typename EPA<T>::FindNextDirectionStatus EPA<T>::findNextSupportDirection(
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 EPA_Status EPA<T>::evaluateFromUnInitializedPolytope(
     const GJKSimplex<T>& simplex, Polytope<T>& polytope,
-    const MinkowskiDiff<T>& shape, T* depth_if_penetration,
+    const MinkowskiDiffT& shape, T* depth_if_penetration,
     Vector3<T>* p_on_shape_0, Vector3<T>* p_on_shape_1) const {
   auto simple2polytope_status = simplexToPolytope(
       simplex, shape, polytope, p_on_shape_0, p_on_shape_1, tolerance_);
@@ -134,8 +136,9 @@ EPA_Status EPA<T>::evaluateFromUnInitializedPolytope(
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 EPA_Status EPA<T>::evaluateFromInitializedPolytope(
-    Polytope<T>& polytope, const MinkowskiDiff<T>& shape,
+    Polytope<T>& polytope, const MinkowskiDiffT& shape,
     T* depth_if_penetration, Vector3<T>* p_on_shape_0,
     Vector3<T>* p_on_shape_1) const {
   // The iterations
@@ -237,8 +240,9 @@ EPA_Status EPA<T>::evaluateFromInitializedPolytope(
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 EPA_Status EPA<T>::Evaluate(const GJKSimplex<T>& simplex,
-                            const MinkowskiDiff<T>& shape,
+                            const MinkowskiDiffT& shape,
                             T* depth_if_penetration, Vector3<T>* p_on_shape_0,
                             Vector3<T>* p_on_shape_1,
                             Polytope<T>* external_polytope) const {
@@ -257,8 +261,9 @@ EPA_Status EPA<T>::Evaluate(const GJKSimplex<T>& simplex,
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 EPA_Status EPA<T>::Test_EvaluateFromInitializedPolytope(
-    Polytope<T>& polytope, const MinkowskiDiff<T>& shape,
+    Polytope<T>& polytope, const MinkowskiDiffT& shape,
     T* depth_if_penetration, Vector3<T>* p_on_shape_0,
     Vector3<T>* p_on_shape_1) const {
   return evaluateFromInitializedPolytope(polytope, shape, depth_if_penetration,
@@ -266,7 +271,8 @@ EPA_Status EPA<T>::Test_EvaluateFromInitializedPolytope(
 }
 
 template <typename T>
-bool EPA<T>::checkTerminateCondition(const MinkowskiDiff<T>& shape,
+template <typename MinkowskiDiffT>
+bool EPA<T>::checkTerminateCondition(const MinkowskiDiffT& shape,
                                      const RawFeature& nearest_feature,
                                      const Vector3<T>& d,
                                      const Vector3<T>& new_v,
@@ -338,8 +344,9 @@ bool EPA<T>::transformToRawFeature(const PolytopeElementBase* feature,
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 void EPA<T>::assignPenetrationPair(
-    const MinkowskiDiff<T>& shape,
+    const MinkowskiDiffT& shape,
     const MinkowskiDiffVertex<T>& candidate_next_v,
     const RawFeature& nearest_feature, T* depth_if_penetration,
     Vector3<T>* p_on_shape_0, Vector3<T>* p_on_shape_1) const {
@@ -374,8 +381,9 @@ void EPA<T>::assignPenetrationPair(
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 bool EPA<T>::assignPenetrationPairFromSegment(
-    const MinkowskiDiff<T>& shape, const RawFeature& nearest_edge_feature,
+    const MinkowskiDiffT& shape, const RawFeature& nearest_edge_feature,
     T* depth_if_penetration, Vector3<T>* p_on_shape_0,
     Vector3<T>* p_on_shape_1) const {
   // The distance is rather simple
@@ -433,8 +441,9 @@ bool EPA<T>::assignPenetrationPairFromSegment(
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 bool EPA<T>::assignPenetrationPairFromFace(
-    const MinkowskiDiff<T>& shape, const RawFeature& nearest_face_feature,
+    const MinkowskiDiffT& shape, const RawFeature& nearest_face_feature,
     T* depth_if_penetration, Vector3<T>* p_on_shape_0,
     Vector3<T>* p_on_shape_1) const {
   // The distance is rather simple
@@ -7,8 +7,8 @@
 namespace fcl {
 namespace cvx_collide {
 
-template <typename T>
-void extractTouchingPoint(const MinkowskiDiff<T>& shape,
+template <typename T, typename MinkowskiDiffT>
+void extractTouchingPoint(const MinkowskiDiffT& shape,
                           const Vector3<T>& direction,
                           Vector3<T>* p0_if_touching,
                           Vector3<T>* p1_if_touching) {
@@ -42,9 +42,9 @@ void extractTouchingPoint(const MinkowskiDiff<T>& shape,
   // if (p1_if_touching) *p1_if_touching = shape.support1(-direction);
 }
 
-template <typename T>
+template <typename T, typename MinkowskiDiffT>
 Simplex2PolytopeStatus simplexToPolytope(const GJKSimplex<T>& simplex,
-                                         const MinkowskiDiff<T>& shape,
+                                         const MinkowskiDiffT& shape,
                                          Polytope<T>& polytope,
                                          Vector3<T>* p0_if_touching,
                                          Vector3<T>* p1_if_touching,
@@ -92,11 +92,11 @@ Simplex2PolytopeStatus simplexToPolytope(const GJKSimplex<T>& simplex,
   }
 }
 
-template <typename T>
+template <typename T, typename MinkowskiDiffT>
 Simplex2PolytopeStatus simplexToPolytope4(
     const MinkowskiDiffVertex<T>& a, const MinkowskiDiffVertex<T>& b,
     const MinkowskiDiffVertex<T>& c, const MinkowskiDiffVertex<T>& d,
-    const MinkowskiDiff<T>& shape, Polytope<T>& polytope,
+    const MinkowskiDiffT& shape, Polytope<T>& polytope,
     Vector3<T>* p0_if_touching, Vector3<T>* p1_if_touching,
     T touching_threshold) {
   // The origin
@@ -131,10 +131,10 @@ Simplex2PolytopeStatus simplexToPolytope4(
   return formNewTetrahedronPolytope(a, b, c, d, polytope);
 }
 
-template <typename T>
+template <typename T, typename MinkowskiDiffT>
 Simplex2PolytopeStatus simplexToPolytope3(
     const MinkowskiDiffVertex<T>& a, const MinkowskiDiffVertex<T>& b,
-    const MinkowskiDiffVertex<T>& c, const MinkowskiDiff<T>& shape,
+    const MinkowskiDiffVertex<T>& c, const MinkowskiDiffT& shape,
     Polytope<T>& polytope, Vector3<T>* p0_if_touching,
     Vector3<T>* p1_if_touching, T touching_threshold) {
   const Vector3<T> ab = b.vertex - a.vertex;
@@ -214,10 +214,10 @@ Simplex2PolytopeStatus formNewTetrahedronPolytope(
   return Simplex2PolytopeStatus::OK;
 }
 
-template <typename T>
+template <typename T, typename MinkowskiDiffT>
 Simplex2PolytopeStatus simplexToPolytope2(const MinkowskiDiffVertex<T>& a,
                                           const MinkowskiDiffVertex<T>& b,
-                                          const MinkowskiDiff<T>& shape,
+                                          const MinkowskiDiffT& shape,
                                           Polytope<T>& polytope,
                                           Vector3<T>* p0_if_touching,
                                           Vector3<T>* p1_if_touching,
@@ -32,6 +32,10 @@ struct GJKSimplex {
   MinkowskiDiffVertex<T> vertices[4];
   int rank{-1};
 
+  // The direction d that certifies separation, dot(d, support(d)) < 0
+  // Only meaningful if GJK returns GJK_Status::Separated
+  Vector3<T> separating_direction;
+
   // Access
   void reset() { rank = -1; }
   bool is_valid() const { return rank > 0; }
@@ -83,7 +87,8 @@ class GJK {
   // If status == Intersect, then simplex contains the origin
   // Note that there might be touching containment
   // If status == Separated, the simplex is the converging one
-  GJK_Status Evaluate(const MinkowskiDiff<T>& shape, GJKSimplex<T>& simplex,
+  template <typename MinkowskiDiffT>
+  GJK_Status Evaluate(const MinkowskiDiffT& shape, GJKSimplex<T>& simplex,
                       const Vector3<T>& guess = Vector3<T>::UnitX(),
                       MinSeparationDistanceOutput*
                           min_distance_output_if_separated = nullptr) const;
@@ -113,8 +118,9 @@ class GJK {
   // simplex is both input and output, as input it contains ONE vertex
   // that witness the separation of the point
   // return:
+  template <typename MinkowskiDiffT>
   bool findMinimumDistancePointsWithSeparatedVertexInit(
-      const MinkowskiDiff<T>& shape, GJKSimplex<T>& simplex,
+      const MinkowskiDiffT& shape, GJKSimplex<T>& simplex,
       std::pair<Vector3<T>, Vector3<T>>& p0p1_in_frame0) const;
 
   // The functions for update the min-distance simplex, although
@@ -146,11 +152,13 @@ class GJK {
   // However, to ease the implementation when simplex.size == 2
   // (segment simplex) the min distance point is always write into the
   // output (even if the min distance is not achieved on segment, but on vertex)
+  template <typename MinkowskiDiffT>
   bool extractSeparationPointNoSubSimplex(
-      const MinkowskiDiff<T>& shape, const GJKSimplex<T>& simplex,
+      const MinkowskiDiffT& shape, const GJKSimplex<T>& simplex,
       std::pair<Vector3<T>, Vector3<T>>& p0p1_in_frame0) const;
+  template <typename MinkowskiDiffT>
   bool extractSeparationPointTrySubSimplex(
-      const MinkowskiDiff<T>& shape, const GJKSimplex<T>& simplex,
+      const MinkowskiDiffT& shape, const GJKSimplex<T>& simplex,
       std::pair<Vector3<T>, Vector3<T>>& p0p1_in_frame0) const;
 };
 
@@ -8,8 +8,9 @@ namespace fcl {
 namespace cvx_collide {
 
 template <typename T>
+template <typename MinkowskiDiffT>
 GJK_Status GJK<T>::Evaluate(
-    const MinkowskiDiff<T>& shape, GJKSimplex<T>& simplex,
+    const MinkowskiDiffT& shape, GJKSimplex<T>& simplex,
     const Vector3<T>& guess,
     MinSeparationDistanceOutput* min_distance_output_if_separated) const {
   // The initial guess
@@ -21,6 +22,8 @@ GJK_Status GJK<T>::Evaluate(
   auto process_separated_vertex =
       [this, &shape, &min_distance_output_if_separated,
        &simplex](const MinkowskiDiffVertex<T>& separated_v) -> GJK_Status {
+    simplex.separating_direction = separated_v.direction;
+
     // Do not require distance, just return
     if (min_distance_output_if_separated == nullptr)
       return GJK_Status::Separated;
@@ -8,8 +8,9 @@ namespace fcl {
 namespace cvx_collide {
 
 template <typename T>
+template <typename MinkowskiDiffT>
 bool GJK<T>::findMinimumDistancePointsWithSeparatedVertexInit(
-    const MinkowskiDiff<T>& shape, GJKSimplex<T>& simplex,
+    const MinkowskiDiffT& shape, GJKSimplex<T>& simplex,
     std::pair<Vector3<T>, Vector3<T>>& p0p1_in_frame0) const {
   // Contains the witness point
   assert(simplex.rank == 1);
@@ -373,8 +374,9 @@ GJK<T>::computeMinDistanceAndUpdateSimplex4(
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 bool GJK<T>::extractSeparationPointNoSubSimplex(
-    const MinkowskiDiff<T>& shape, const GJKSimplex<T>& simplex,
+    const MinkowskiDiffT& shape, const GJKSimplex<T>& simplex,
     std::pair<Vector3<T>, Vector3<T>>& output) const {
   // The ordering (old/new) of vertices does NOT matter in this method
   if ((simplex.rank == 4) || (!simplex.is_valid())) {
@@ -470,8 +472,9 @@ bool GJK<T>::extractSeparationPointNoSubSimplex(
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 bool GJK<T>::extractSeparationPointTrySubSimplex(
-    const MinkowskiDiff<T>& shape, const GJKSimplex<T>& simplex,
+    const MinkowskiDiffT& shape, const GJKSimplex<T>& simplex,
     std::pair<Vector3<T>, Vector3<T>>& output) const {
   if (simplex.rank >= 4) {
     return false;
@@ -94,6 +94,37 @@ template <typename T>
 Vector3<T> cylinderSupport(const GJKGeometryData<T>& geometry_data,
                            const Vector3<T>& direction);
 
+// The support policy of a shape type that is known at compile time, which
+// is used by StaticMinkowskiDiff. The function pointers are template
+// arguments, so the calls are resolved (and usually inlined) statically.
+template <typename T,
+          Vector3<T> (*SupportFunc)(const GJKGeometryData<T>&,
+                                    const Vector3<T>&),
+          Vector3<T> (*InteriorFunc)(const GJKGeometryData<T>&) =
+              basicGeometryInterior<T>>
+struct GJKSupportPolicy {
+  static Vector3<T> support(const GJKGeometryData<T>& geometry_data,
+                            const Vector3<T>& direction) {
+    return SupportFunc(geometry_data, direction);
+  }
+  static Vector3<T> interior(const GJKGeometryData<T>& geometry_data) {
+    return InteriorFunc(geometry_data);
+  }
+};
+
+template <typename T>
+using BoxGJKSupport = GJKSupportPolicy<T, boxSupport<T>>;
+template <typename T>
+using SphereGJKSupport = GJKSupportPolicy<T, sphereSupport<T>>;
+template <typename T>
+using EllipsoidGJKSupport = GJKSupportPolicy<T, ellipsoidSupport<T>>;
+template <typename T>
+using CapsuleGJKSupport = GJKSupportPolicy<T, capsuleSupport<T>>;
+template <typename T>
+using ConeGJKSupport = GJKSupportPolicy<T, coneSupport<T>>;
+template <typename T>
+using CylinderGJKSupport = GJKSupportPolicy<T, cylinderSupport<T>>;
+
 }  // namespace cvx_collide
 }  // namespace fcl
 
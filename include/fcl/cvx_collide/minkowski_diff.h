@@ -49,6 +49,60 @@ struct MinkowskiDiff {
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
 
+/// @brief Minkowski difference class of two shapes whose types are known
+/// at compile time. Shape0Support and Shape1Support are policies (such as
+/// BoxGJKSupport<T>) with the static members
+///   Vector3<T> support(const GJKGeometryData<T>&, const Vector3<T>&);
+///   Vector3<T> interior(const GJKGeometryData<T>&);
+/// It has the same interface as MinkowskiDiff<T>, which GJK/MPR/EPA are
+/// templated on. Thus, the support calls are inlined instead of passing
+/// through std::function and the switch on shape type. MinkowskiDiff<T>
+/// is still the one for shapes that are only known at run time.
+template <typename T, typename Shape0Support, typename Shape1Support>
+struct StaticMinkowskiDiff {
+  /// @brief points to two shapes
+  GJKGeometryData<T> shapes[2];
+
+  /// @brief rotation from shape0 to shape1
+  Matrix3<T> toshape1;
+
+  /// @brief transform from shape1 to shape0
+  Transform3<T> toshape0;
+
+  /// The same as MinkowskiDiff<T>
+  Vector3<T> support0(const Vector3<T>& d) const;
+  Vector3<T> support1(const Vector3<T>& d) const;
+  Vector3<T> support(const Vector3<T>& d) const;
+  MinkowskiDiffVertex<T> supportVertex(const Vector3<T>& d) const;
+  Vector3<T> support(const Vector3<T>& d, size_t index) const;
+  Vector3<T> interior() const;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+/// @brief The Minkowski difference of shape0 inflated by margin (its
+/// Minkowski sum with a ball of radius margin) and shape1, where the
+/// original difference is BaseMinkowskiDiff. The support is the one of
+/// BaseMinkowskiDiff shifted by margin along the normalized direction, thus
+/// GJK on it reports intersection iff the distance between the original
+/// shapes is less than margin, and terminates as soon as a separating
+/// direction is found without computing the distance.
+template <typename T, typename BaseMinkowskiDiff>
+struct MarginMinkowskiDiff {
+  BaseMinkowskiDiff base;
+  T margin{0};
+
+  /// The same as MinkowskiDiff<T>
+  Vector3<T> support0(const Vector3<T>& d) const;
+  Vector3<T> support1(const Vector3<T>& d) const;
+  Vector3<T> support(const Vector3<T>& d) const;
+  MinkowskiDiffVertex<T> supportVertex(const Vector3<T>& d) const;
+  Vector3<T> support(const Vector3<T>& d, size_t index) const;
+  Vector3<T> interior() const;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
 }  // namespace cvx_collide
 }  // namespace fcl
 
@@ -4,20 +4,13 @@ namespace fcl {
 namespace cvx_collide {
 
 //==============================================================================
-template <typename T>
-MinkowskiDiff<T>::MinkowskiDiff()
-    : support_function(basicGeometrySupport<T>),
-      interior_function(basicGeometryInterior<T>) {}
-
-//==============================================================================
-template <typename T>
-Vector3<T> MinkowskiDiff<T>::support0(const Vector3<T>& d) const {
-  return support_function(shapes[0], d);
-}
-
-//==============================================================================
-template <typename T>
-Vector3<T> MinkowskiDiff<T>::support1(const Vector3<T>& d) const {
+/// Evaluate the support of shape1 on direction d (in the frame of shape0)
+/// and express the result in the frame of shape0
+template <typename T, typename Shape1SupportFunc>
+Vector3<T> transformedSupport1(const Matrix3<T>& toshape1,
+                               const Transform3<T>& toshape0,
+                               const Shape1SupportFunc& support_in_1_func,
+                               const Vector3<T>& d) {
 #ifdef WIN32
   // Convert direction to 1
   const T direction_in_1_x =
@@ -28,7 +21,7 @@ Vector3<T> MinkowskiDiff<T>::support1(const Vector3<T>& d) const {
       toshape1(2, 0) * d[0] + toshape1(2, 1) * d[1] + toshape1(2, 2) * d[2];
   const Vector3<T> direction_in_1(direction_in_1_x, direction_in_1_y,
                                   direction_in_1_z);
-  const Vector3<T> support_in_1 = support_function(shapes[1], direction_in_1);
+  const Vector3<T> support_in_1 = support_in_1_func(direction_in_1);
 
   // Convert back to 0
   const auto& to_shape0_matrix = toshape0.matrix();
@@ -47,10 +40,33 @@ Vector3<T> MinkowskiDiff<T>::support1(const Vector3<T>& d) const {
   return Vector3<T>(support_in_0_x, support_in_0_y, support_in_0_z);
 #else
   const Vector3<T> dir_in_1 = toshape1 * d;
-  return toshape0 * support_function(shapes[1], dir_in_1);
+  return toshape0 * support_in_1_func(dir_in_1);
 #endif
 }
 
+//==============================================================================
+template <typename T>
+MinkowskiDiff<T>::MinkowskiDiff()
+    : support_function(basicGeometrySupport<T>),
+      interior_function(basicGeometryInterior<T>) {}
+
+//==============================================================================
+template <typename T>
+Vector3<T> MinkowskiDiff<T>::support0(const Vector3<T>& d) const {
+  return support_function(shapes[0], d);
+}
+
+//==============================================================================
+template <typename T>
+Vector3<T> MinkowskiDiff<T>::support1(const Vector3<T>& d) const {
+  return transformedSupport1(
+      toshape1, toshape0,
+      [this](const Vector3<T>& dir_in_1) -> Vector3<T> {
+        return support_function(shapes[1], dir_in_1);
+      },
+      d);
+}
+
 //==============================================================================
 template <typename T>
 Vector3<T> MinkowskiDiff<T>::support(const Vector3<T>& d) const {
@@ -84,5 +100,111 @@ Vector3<T> MinkowskiDiff<T>::interior() const {
   return shape_0_interior - toshape0 * shape_1_interior;
 }
 
+//==============================================================================
+template <typename T, typename Shape0Support, typename Shape1Support>
+Vector3<T> StaticMinkowskiDiff<T, Shape0Support, Shape1Support>::support0(
+    const Vector3<T>& d) const {
+  return Shape0Support::support(shapes[0], d);
+}
+
+//==============================================================================
+template <typename T, typename Shape0Support, typename Shape1Support>
+Vector3<T> StaticMinkowskiDiff<T, Shape0Support, Shape1Support>::support1(
+    const Vector3<T>& d) const {
+  return transformedSupport1(
+      toshape1, toshape0,
+      [this](const Vector3<T>& dir_in_1) -> Vector3<T> {
+        return Shape1Support::support(shapes[1], dir_in_1);
+      },
+      d);
+}
+
+//==============================================================================
+template <typename T, typename Shape0Support, typename Shape1Support>
+Vector3<T> StaticMinkowskiDiff<T, Shape0Support, Shape1Support>::support(
+    const Vector3<T>& d) const {
+  return support0(d) - support1(-d);
+}
+
+//==============================================================================
+template <typename T, typename Shape0Support, typename Shape1Support>
+MinkowskiDiffVertex<T>
+StaticMinkowskiDiff<T, Shape0Support, Shape1Support>::supportVertex(
+    const Vector3<T>& d) const {
+  MinkowskiDiffVertex<T> v;
+  v.direction = d;
+  v.vertex = support0(d) - support1(-d);
+  return v;
+}
+
+//==============================================================================
+template <typename T, typename Shape0Support, typename Shape1Support>
+Vector3<T> StaticMinkowskiDiff<T, Shape0Support, Shape1Support>::support(
+    const Vector3<T>& d, size_t index) const {
+  if (index)
+    return support1(d);
+  else
+    return support0(d);
+}
+
+//==============================================================================
+template <typename T, typename Shape0Support, typename Shape1Support>
+Vector3<T> StaticMinkowskiDiff<T, Shape0Support, Shape1Support>::interior()
+    const {
+  Vector3<T> shape_0_interior = Shape0Support::interior(shapes[0]);
+  Vector3<T> shape_1_interior = Shape1Support::interior(shapes[1]);
+  return shape_0_interior - toshape0 * shape_1_interior;
+}
+
+//==============================================================================
+template <typename T, typename BaseMinkowskiDiff>
+Vector3<T> MarginMinkowskiDiff<T, BaseMinkowskiDiff>::support0(
+    const Vector3<T>& d) const {
+  const T d_norm = d.norm();
+  if (d_norm <= T(0)) return base.support0(d);
+  return base.support0(d) + (margin / d_norm) * d;
+}
+
+//==============================================================================
+template <typename T, typename BaseMinkowskiDiff>
+Vector3<T> MarginMinkowskiDiff<T, BaseMinkowskiDiff>::support1(
+    const Vector3<T>& d) const {
+  return base.support1(d);
+}
+
+//==============================================================================
+template <typename T, typename BaseMinkowskiDiff>
+Vector3<T> MarginMinkowskiDiff<T, BaseMinkowskiDiff>::support(
+    const Vector3<T>& d) const {
+  return support0(d) - support1(-d);
+}
+
+//==============================================================================
+template <typename T, typename BaseMinkowskiDiff>
+MinkowskiDiffVertex<T> MarginMinkowskiDiff<T, BaseMinkowskiDiff>::supportVertex(
+    const Vector3<T>& d) const {
+  MinkowskiDiffVertex<T> v;
+  v.direction = d;
+  v.vertex = support0(d) - support1(-d);
+  return v;
+}
+
+//==============================================================================
+template <typename T, typename BaseMinkowskiDiff>
+Vector3<T> MarginMinkowskiDiff<T, BaseMinkowskiDiff>::support(
+    const Vector3<T>& d, size_t index) const {
+  if (index)
+    return support1(d);
+  else
+    return support0(d);
+}
+
+//==============================================================================
+template <typename T, typename BaseMinkowskiDiff>
+Vector3<T> MarginMinkowskiDiff<T, BaseMinkowskiDiff>::interior() const {
+  // The interior of shape0 is also in the inflated one
+  return base.interior();
+}
+
 }  // namespace cvx_collide
 }  // namespace fcl
\ No newline at end of file
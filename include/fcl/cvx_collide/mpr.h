@@ -33,12 +33,31 @@ struct MPR {
   };
 
   // The evaluation interface with only binary flag output
-  static IntersectStatus RunIntersect(const MinkowskiDiff<T>& shape,
+  template <typename MinkowskiDiffT>
+  static IntersectStatus RunIntersect(const MinkowskiDiffT& shape,
                                       IntersectData& intersect_data,
                                       int max_iterations, T tolerance);
-  IntersectStatus Intersect(const MinkowskiDiff<T>& shape,
+  template <typename MinkowskiDiffT>
+  IntersectStatus Intersect(const MinkowskiDiffT& shape,
                             IntersectData* intersect_data = nullptr) const;
-  bool IsOriginEnclosedDebug(const MinkowskiDiff<T>& shape,
+
+  // The evaluation warm started from the portal of a previous query, such as
+  // the same pair of shapes in the last frame. intersect_data is both the
+  // input (v1/v2/v3_dir_in_support, which must be finite) and the output.
+  // If the shapes moved a little, the supports on these directions are
+  // usually a portal (or certify separation) that requires much fewer
+  // iterations. The result is certified the same as RunIntersect.
+  template <typename MinkowskiDiffT>
+  static IntersectStatus RunIntersectWarmStart(const MinkowskiDiffT& shape,
+                                               IntersectData& intersect_data,
+                                               int max_iterations,
+                                               T tolerance);
+  template <typename MinkowskiDiffT>
+  IntersectStatus IntersectWarmStart(const MinkowskiDiffT& shape,
+                                     IntersectData& intersect_data) const;
+
+  template <typename MinkowskiDiffT>
+  bool IsOriginEnclosedDebug(const MinkowskiDiffT& shape,
                              const IntersectData& intersect_data) const;
 
   // The data for penetration
@@ -64,12 +83,14 @@ struct MPR {
     Vector3<T> p0_in_shape0_frame;
     Vector3<T> p1_in_shape0_frame;
   };
+  template <typename MinkowskiDiffT>
   static DirectedPenetrationStatus RunDirectedPenetration(
-      const MinkowskiDiff<T>& shape, const Vector3<T>& unit_direction,
+      const MinkowskiDiffT& shape, const Vector3<T>& unit_direction,
       DirectedPenetrationData& penetration_data, int max_iterations,
       T tolerance);
+  template <typename MinkowskiDiffT>
   DirectedPenetrationStatus DirectedPenetration(
-      const MinkowskiDiff<T>& shape, const Vector3<T>& unit_direction,
+      const MinkowskiDiffT& shape, const Vector3<T>& unit_direction,
       DirectedPenetrationData& penetration_data) const;
 
   // The data for local refinement minimum penetration
@@ -87,12 +108,14 @@ struct MPR {
     Vector3<T> p0_in_shape0_frame;
     Vector3<T> p1_in_shape0_frame;
   };
+  template <typename MinkowskiDiffT>
   static IncrementalPenetrationStatus RunIncrementalMinimumPenetrationDistance(
-      const MinkowskiDiff<T>& shape, const Vector3<T>& init_direction,
+      const MinkowskiDiffT& shape, const Vector3<T>& init_direction,
       IncrementalMinimumPenetrationData& refine_data, int max_iteration,
       T tolerance, bool return_on_subroutine_converge = true);
+  template <typename MinkowskiDiffT>
   IncrementalPenetrationStatus IncrementalMinimumPenetrationDistance(
-      const MinkowskiDiff<T>& shape, const Vector3<T>& init_direction,
+      const MinkowskiDiffT& shape, const Vector3<T>& init_direction,
       IncrementalMinimumPenetrationData& refine_data,
       bool return_on_subroutine_converge = true) const;
 
@@ -105,7 +128,8 @@ struct MPR {
   // Helpers
   // Sometimes we need to normalize the direction (sphere, capsule, cylinder)
   // Sometimes we do not.
-  static Vector3<T> computeShapeSupport(const MinkowskiDiff<T>& shape,
+  template <typename MinkowskiDiffT>
+  static Vector3<T> computeShapeSupport(const MinkowskiDiffT& shape,
                                         Vector3<T>& direction);
   static inline T computeAbsNorm(const Vector3<T>& v);
 
@@ -113,11 +137,20 @@ struct MPR {
   // v0 to O intersects with the triangle formed by v1/v2/v3.
   // v1/v2/v3 must be on the shape
   enum class FindPortalStatus { IterationLimit, DetectSeperated, PortalFound };
+  template <typename MinkowskiDiffT>
   static FindPortalStatus findPortal(
-      const MinkowskiDiff<T>& shape, const Vector3<T>& v0, Vector3<T>& v1,
+      const MinkowskiDiffT& shape, const Vector3<T>& v0, Vector3<T>& v1,
       Vector3<T>& v2, Vector3<T>& v3,
       std::array<Vector3<T>*, 3> v1_v2_v3_dir_in_support, int max_iterations);
 
+  // Find the portal from the v0/v1/v2/v3 in intersect_data, then refine it
+  // until the intersection or separation is certified
+  template <typename MinkowskiDiffT>
+  static IntersectStatus refineIntersectPortal(const MinkowskiDiffT& shape,
+                                               IntersectData& intersect_data,
+                                               int max_iterations,
+                                               T tolerance);
+
   // Helpers for findPortal
   static void updatePortal(const Vector3<T>& v0, const Vector3<T>& v4,
                            const Vector3<T>& v4_dir_in_support, Vector3<T>& v1,
@@ -132,13 +165,15 @@ struct MPR {
   // This ray intersects with the triangle v1v2v3, and the normal v123.dot(d)
   // cannot be negative. ray_direction/v123_normal is a unit vector.
   // Compute the distance from the origin to the intersecting point on v1v2v3.
+  template <typename MinkowskiDiffT>
   static void finalizeDirectedPenetrationResult(
-      const MinkowskiDiff<T>& shape, const Vector3<T>& ray_direction,
+      const MinkowskiDiffT& shape, const Vector3<T>& ray_direction,
       const Vector3<T>& v123_normal_arg,
       DirectedPenetrationData& penetration_data,
       const Vector3<T>* v4_optional = nullptr);
+  template <typename MinkowskiDiffT>
   static void finalizeIncrementalPenetrationResult(
-      const MinkowskiDiff<T>& shape, const Vector3<T>& ray_direction,
+      const MinkowskiDiffT& shape, const Vector3<T>& ray_direction,
       const Vector3<T>& v1, const Vector3<T>& v2, const Vector3<T>& v3,
       const Vector3<T>& v1_dir, const Vector3<T>& v2_dir,
       const Vector3<T>& v3_dir, const Vector3<T>& v123_normal_arg,
@@ -153,9 +188,10 @@ struct MPR {
     Failed,
     FailedNoIntersect
   };
+  template <typename MinkowskiDiffT>
   static IncrementalMinDistanceSubroutineStatus
   incrementalMinimumDistanceExploreDirection(
-      const MinkowskiDiff<T>& shape, const Vector3<T>& direction_to_explore,
+      const MinkowskiDiffT& shape, const Vector3<T>& direction_to_explore,
       // Both input/output
       Vector3<T>& v1, Vector3<T>& v2, Vector3<T>& v3, Vector3<T>& v1_dir,
       Vector3<T>& v2_dir, Vector3<T>& v3_dir,
@@ -8,7 +8,8 @@ MPR<T>::MPR(int max_iterations_in, T tolerance_in)
     : max_iterations(max_iterations_in), tolerance(tolerance_in) {}
 
 template <typename T>
-Vector3<T> MPR<T>::computeShapeSupport(const MinkowskiDiff<T>& shape,
+template <typename MinkowskiDiffT>
+Vector3<T> MPR<T>::computeShapeSupport(const MinkowskiDiffT& shape,
                                        Vector3<T>& direction) {
   direction.normalize();
   return shape.support(direction);
@@ -20,8 +21,9 @@ T MPR<T>::computeAbsNorm(const Vector3<T>& v) {
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 typename MPR<T>::IntersectStatus MPR<T>::Intersect(
-    const MinkowskiDiff<T>& shape, IntersectData* intersect_data) const {
+    const MinkowskiDiffT& shape, IntersectData* intersect_data) const {
   if (intersect_data != nullptr) {
     return RunIntersect(shape, *intersect_data, max_iterations, tolerance);
   } else {
@@ -31,8 +33,9 @@ typename MPR<T>::IntersectStatus MPR<T>::Intersect(
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 typename MPR<T>::IntersectStatus MPR<T>::RunIntersect(
-    const MinkowskiDiff<T>& shape, IntersectData& intersect_data,
+    const MinkowskiDiffT& shape, IntersectData& intersect_data,
     int max_iterations, T tolerance) {
   // Gather the data
   using std::swap;
@@ -110,6 +113,92 @@ typename MPR<T>::IntersectStatus MPR<T>::RunIntersect(
     return IntersectStatus::Separated;
   }
 
+  // Find and refine the portal
+  return refineIntersectPortal(shape, intersect_data, max_iterations,
+                               tolerance);
+}
+
+template <typename T>
+template <typename MinkowskiDiffT>
+typename MPR<T>::IntersectStatus MPR<T>::IntersectWarmStart(
+    const MinkowskiDiffT& shape, IntersectData& intersect_data) const {
+  return RunIntersectWarmStart(shape, intersect_data, max_iterations,
+                               tolerance);
+}
+
+template <typename T>
+template <typename MinkowskiDiffT>
+typename MPR<T>::IntersectStatus MPR<T>::RunIntersectWarmStart(
+    const MinkowskiDiffT& shape, IntersectData& intersect_data,
+    int max_iterations, T tolerance) {
+  // The directions of the previous portal are the input
+  Vector3<T>& v0_interior = intersect_data.v0_interior;
+  Vector3<T>& v1 = intersect_data.v1;
+  Vector3<T>& v2 = intersect_data.v2;
+  Vector3<T>& v3 = intersect_data.v3;
+  Vector3<T>& v1_dir_in_support = intersect_data.v1_dir_in_support;
+  Vector3<T>& v2_dir_in_support = intersect_data.v2_dir_in_support;
+  Vector3<T>& v3_dir_in_support = intersect_data.v3_dir_in_support;
+
+  // Compute the interior point
+  v0_interior = shape.interior();
+
+  // Distance is smaller than a threshold, then must intersect
+  if (v0_interior.squaredNorm() <= tolerance * tolerance) {
+    return IntersectStatus::Intersect;
+  }
+
+  // The supports on the previous portal directions, each of them might
+  // certify the separation as in RunIntersect
+  v1 = computeShapeSupport(shape, v1_dir_in_support);
+  if (v1_dir_in_support.dot(v1) < 0) {
+    return IntersectStatus::Separated;
+  }
+  v2 = computeShapeSupport(shape, v2_dir_in_support);
+  if (v2_dir_in_support.dot(v2) < 0) {
+    return IntersectStatus::Separated;
+  }
+  v3 = computeShapeSupport(shape, v3_dir_in_support);
+  if (v3_dir_in_support.dot(v3) < 0) {
+    return IntersectStatus::Separated;
+  }
+
+  // findPortal requires v0/v1/v2/v3 to be a tetrahedron. If the previous
+  // portal degenerates (or the input directions are invalid, which yields
+  // NaN here) start from scratch.
+  const Vector3<T> v0_to_v1 = v1 - v0_interior;
+  const Vector3<T> v0_to_v2 = v2 - v0_interior;
+  const Vector3<T> v0_to_v3 = v3 - v0_interior;
+  const T abs_volume = std::abs(v0_to_v1.dot(v0_to_v2.cross(v0_to_v3)));
+  if (!(abs_volume > tolerance * computeAbsNorm(v0_to_v1) *
+                         computeAbsNorm(v0_to_v2) *
+                         computeAbsNorm(v0_to_v3))) {
+    return RunIntersect(shape, intersect_data, max_iterations, tolerance);
+  }
+
+  // Find and refine the portal
+  const auto status =
+      refineIntersectPortal(shape, intersect_data, max_iterations, tolerance);
+  if (status == IntersectStatus::Failed) {
+    return RunIntersect(shape, intersect_data, max_iterations, tolerance);
+  }
+  return status;
+}
+
+template <typename T>
+template <typename MinkowskiDiffT>
+typename MPR<T>::IntersectStatus MPR<T>::refineIntersectPortal(
+    const MinkowskiDiffT& shape, IntersectData& intersect_data,
+    int max_iterations, T tolerance) {
+  using std::swap;
+  const Vector3<T>& v0_interior = intersect_data.v0_interior;
+  Vector3<T>& v1 = intersect_data.v1;
+  Vector3<T>& v2 = intersect_data.v2;
+  Vector3<T>& v3 = intersect_data.v3;
+  Vector3<T>& v1_dir_in_support = intersect_data.v1_dir_in_support;
+  Vector3<T>& v2_dir_in_support = intersect_data.v2_dir_in_support;
+  Vector3<T>& v3_dir_in_support = intersect_data.v3_dir_in_support;
+
   // The loop to find the portal
   std::array<Vector3<T>*, 3> v1_v2_v3_dir_in_support{
       &v1_dir_in_support, &v2_dir_in_support, &v3_dir_in_support};
@@ -185,8 +274,9 @@ typename MPR<T>::IntersectStatus MPR<T>::RunIntersect(
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 typename MPR<T>::FindPortalStatus MPR<T>::findPortal(
-    const MinkowskiDiff<T>& shape, const Vector3<T>& v0, Vector3<T>& v1,
+    const MinkowskiDiffT& shape, const Vector3<T>& v0, Vector3<T>& v1,
     Vector3<T>& v2, Vector3<T>& v3,
     std::array<Vector3<T>*, 3> v1_v2_v3_dir_in_support, int max_iterations) {
   // Check input
@@ -404,7 +494,8 @@ bool MPR<T>::portalEncloseOrigin(const Vector3<T>& v0_interior,
 }
 
 template <typename T>
-bool MPR<T>::IsOriginEnclosedDebug(const MinkowskiDiff<T>& shape,
+template <typename MinkowskiDiffT>
+bool MPR<T>::IsOriginEnclosedDebug(const MinkowskiDiffT& shape,
                                    const IntersectData& intersect_data) const {
   // Degeneration case 0: one point
   assert(!intersect_data.v0_interior.array().isNaN().any());
@@ -494,8 +585,9 @@ void MPR<T>::updatePortal(const Vector3<T>& v0, const Vector3<T>& v4,
 
 // The directed penetration query
 template <typename T>
+template <typename MinkowskiDiffT>
 typename MPR<T>::DirectedPenetrationStatus MPR<T>::RunDirectedPenetration(
-    const MinkowskiDiff<T>& shape, const Vector3<T>& unit_direction,
+    const MinkowskiDiffT& shape, const Vector3<T>& unit_direction,
     DirectedPenetrationData& penetration_data, int max_iterations,
     T tolerance) {
   using std::swap;
@@ -619,16 +711,18 @@ typename MPR<T>::DirectedPenetrationStatus MPR<T>::RunDirectedPenetration(
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 typename MPR<T>::DirectedPenetrationStatus MPR<T>::DirectedPenetration(
-    const MinkowskiDiff<T>& shape, const Vector3<T>& unit_direction,
+    const MinkowskiDiffT& shape, const Vector3<T>& unit_direction,
     DirectedPenetrationData& penetration_data) const {
   return RunDirectedPenetration(shape, unit_direction, penetration_data,
                                 max_iterations, tolerance);
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 void MPR<T>::finalizeDirectedPenetrationResult(
-    const MinkowskiDiff<T>& shape, const Vector3<T>& ray_direction,
+    const MinkowskiDiffT& shape, const Vector3<T>& ray_direction,
     const Vector3<T>& v123_normal_arg,
     DirectedPenetrationData& penetration_data, const Vector3<T>* v4_optional) {
   // First assign the normal
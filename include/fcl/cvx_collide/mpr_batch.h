@@ -0,0 +1,95 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "mpr.h"
+
+namespace fcl {
+namespace cvx_collide {
+
+/// MPRBatch runs the binary intersection of MPR (MPR<T>::RunIntersect) on
+/// independent MinkowskiDiffs with N lanes in lockstep. The vertices of all
+/// the lanes are stored as structure-of-arrays, and every iteration updates
+/// all lanes by branch-free selects on per-lane masks. Each iteration
+/// evaluates at most one support per lane, which is inlined when the
+/// MinkowskiDiffT is a StaticMinkowskiDiff.
+/// A lane that terminates is refilled by the next MinkowskiDiff, thus the
+/// lanes are kept busy although the queries take different iterations.
+/// Each query follows exactly the steps of RunIntersect.
+template <typename T, std::size_t N>
+class MPRBatch {
+ public:
+  using IntersectStatus = typename MPR<T>::IntersectStatus;
+  static constexpr std::size_t kBatchSize = N;
+
+  MPRBatch(int max_iterations, T tolerance)
+      : max_iterations_(max_iterations), tolerance_(tolerance) {}
+
+  /// Run the query for shapes[0, n_shapes), the status of shapes[i] is
+  /// written to status[i].
+  template <typename MinkowskiDiffT>
+  void Intersect(const MinkowskiDiffT* shapes, std::size_t n_shapes,
+                 IntersectStatus* status) const;
+
+ private:
+  const int max_iterations_;
+  const T tolerance_;
+
+  // The per-lane integers have the same width as T, so that the masks of
+  // the integers and scalars can be mixed in the vectorized loops
+  using LaneInt = typename std::conditional<sizeof(T) == sizeof(std::int32_t),
+                                            std::int32_t, std::int64_t>::type;
+
+  // The phase of a lane, each of them (except Terminated) requires one
+  // support evaluation for the next vertex
+  enum LanePhase {
+    FindV1 = 0,
+    FindV2 = 1,
+    FindV3 = 2,
+    FindPortal = 3,
+    RefinePortal = 4,
+    Terminated = 5
+  };
+
+  // The lane data as structure-of-arrays
+  struct LaneData {
+    T v0[3][N];
+    T v1[3][N];
+    T v2[3][N];
+    T v3[3][N];
+    T direction[3][N];
+    T support[3][N];
+    LaneInt phase[N];
+    // The vertex (1, 2 or 3) replaced by the support in FindPortal
+    LaneInt portal_replace[N];
+    LaneInt find_portal_iteration[N];
+    LaneInt refine_portal_iteration[N];
+    // The IntersectStatus as integer
+    LaneInt status[N];
+    // The index of the shape in this lane
+    std::size_t shape_index[N];
+  };
+
+  // Load the next shape (if any) into the lane
+  template <typename MinkowskiDiffT>
+  void loadLane(const MinkowskiDiffT* shapes, std::size_t n_shapes,
+                std::size_t& next_shape, IntersectStatus* status,
+                LaneData& lanes, std::size_t i) const;
+
+  // The stages of one iteration, which return whether any lane is running
+  bool computeDirection(LaneData& lanes) const;
+  template <typename MinkowskiDiffT>
+  static void computeSupport(const MinkowskiDiffT* shapes, LaneData& lanes);
+  void updateVertex(LaneData& lanes) const;
+};
+
+}  // namespace cvx_collide
+}  // namespace fcl
+
+#include "mpr_batch.hpp"
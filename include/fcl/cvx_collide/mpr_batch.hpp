@@ -0,0 +1,338 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace fcl {
+namespace cvx_collide {
+namespace internal {
+
+// The operations on the 3-element vector of one lane
+template <typename T>
+struct LaneVector3 {
+  T x, y, z;
+};
+
+template <typename T, std::size_t N>
+inline LaneVector3<T> laneLoad(const T (&v)[3][N], std::size_t i) {
+  return LaneVector3<T>{v[0][i], v[1][i], v[2][i]};
+}
+
+template <typename T, std::size_t N>
+inline void laneStore(const LaneVector3<T>& value, T (&v)[3][N],
+                      std::size_t i) {
+  v[0][i] = value.x;
+  v[1][i] = value.y;
+  v[2][i] = value.z;
+}
+
+template <typename T>
+inline LaneVector3<T> laneSub(const LaneVector3<T>& a,
+                              const LaneVector3<T>& b) {
+  return LaneVector3<T>{a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+template <typename T>
+inline LaneVector3<T> laneNeg(const LaneVector3<T>& a) {
+  return LaneVector3<T>{-a.x, -a.y, -a.z};
+}
+
+template <typename T>
+inline LaneVector3<T> laneCross(const LaneVector3<T>& a,
+                                const LaneVector3<T>& b) {
+  return LaneVector3<T>{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z,
+                        a.x * b.y - a.y * b.x};
+}
+
+template <typename T>
+inline T laneDot(const LaneVector3<T>& a, const LaneVector3<T>& b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+template <typename T>
+inline T laneAbsNorm(const LaneVector3<T>& a) {
+  return std::abs(a.x) + std::abs(a.y) + std::abs(a.z);
+}
+
+template <typename T>
+inline LaneVector3<T> laneSelect(bool condition, const LaneVector3<T>& a,
+                                 const LaneVector3<T>& b) {
+  return LaneVector3<T>{condition ? a.x : b.x, condition ? a.y : b.y,
+                        condition ? a.z : b.z};
+}
+
+}  // namespace internal
+
+template <typename T, std::size_t N>
+template <typename MinkowskiDiffT>
+void MPRBatch<T, N>::Intersect(const MinkowskiDiffT* shapes,
+                               std::size_t n_shapes,
+                               IntersectStatus* status) const {
+  LaneData lanes;
+  for (std::size_t i = 0; i < N; i++) {
+    for (int k = 0; k < 3; k++) {
+      lanes.v0[k][i] = lanes.v1[k][i] = lanes.v2[k][i] = lanes.v3[k][i] = 0;
+      lanes.direction[k][i] = lanes.support[k][i] = 0;
+    }
+    lanes.portal_replace[i] = 0;
+    lanes.phase[i] = Terminated;
+    lanes.shape_index[i] = n_shapes;
+  }
+
+  // The lockstep loop
+  std::size_t next_shape = 0;
+  for (;;) {
+    // Write the terminated lanes and refill them
+    for (std::size_t i = 0; i < N; i++) {
+      if (lanes.phase[i] != Terminated) continue;
+      if (lanes.shape_index[i] < n_shapes) {
+        status[lanes.shape_index[i]] =
+            static_cast<IntersectStatus>(lanes.status[i]);
+      }
+      loadLane(shapes, n_shapes, next_shape, status, lanes, i);
+    }
+
+    if (!computeDirection(lanes)) {
+      if (next_shape < n_shapes) continue;
+      break;
+    }
+    computeSupport(shapes, lanes);
+    updateVertex(lanes);
+  }
+
+  // The lanes terminated by the last computeDirection
+  for (std::size_t i = 0; i < N; i++) {
+    if (lanes.shape_index[i] < n_shapes) {
+      status[lanes.shape_index[i]] =
+          static_cast<IntersectStatus>(lanes.status[i]);
+    }
+  }
+}
+
+template <typename T, std::size_t N>
+template <typename MinkowskiDiffT>
+void MPRBatch<T, N>::loadLane(const MinkowskiDiffT* shapes,
+                              std::size_t n_shapes, std::size_t& next_shape,
+                              IntersectStatus* status, LaneData& lanes,
+                              std::size_t i) const {
+  lanes.phase[i] = Terminated;
+  lanes.shape_index[i] = n_shapes;
+  lanes.find_portal_iteration[i] = 0;
+  lanes.refine_portal_iteration[i] = 0;
+  lanes.status[i] = static_cast<LaneInt>(IntersectStatus::Failed);
+  while (next_shape < n_shapes) {
+    // The interior point, the origin close to it must be in intersection
+    const std::size_t shape_i = next_shape++;
+    const Vector3<T> v0 = shapes[shape_i].interior();
+    if (v0.squaredNorm() <= tolerance_ * tolerance_) {
+      status[shape_i] = IntersectStatus::Intersect;
+      continue;
+    }
+    for (int k = 0; k < 3; k++) lanes.v0[k][i] = v0[k];
+    lanes.phase[i] = FindV1;
+    lanes.shape_index[i] = shape_i;
+    return;
+  }
+}
+
+template <typename T, std::size_t N>
+bool MPRBatch<T, N>::computeDirection(LaneData& lanes) const {
+  using namespace internal;
+  // The same as MPR<T>::dot_eps_ratio
+  constexpr T dot_eps_ratio = std::numeric_limits<T>::epsilon();
+  const LaneInt max_iterations = max_iterations_;
+  const LaneInt intersect_status =
+      static_cast<LaneInt>(IntersectStatus::Intersect);
+  const LaneInt failed_status = static_cast<LaneInt>(IntersectStatus::Failed);
+  LaneInt n_running = 0;
+  for (std::size_t i = 0; i < N; i++) {
+    const LaneInt phase = lanes.phase[i];
+    const LaneVector3<T> v0 = laneLoad(lanes.v0, i);
+    const LaneVector3<T> v1 = laneLoad(lanes.v1, i);
+    const LaneVector3<T> v2 = laneLoad(lanes.v2, i);
+    const LaneVector3<T> v3 = laneLoad(lanes.v3, i);
+    const LaneVector3<T> v0_to_v1 = laneSub(v1, v0);
+    const LaneVector3<T> v0_to_v2 = laneSub(v2, v0);
+    const LaneVector3<T> v0_to_v3 = laneSub(v3, v0);
+    const T v0_abs_norm = laneAbsNorm(v0);
+
+    // FindV2: the direction o_to_v0 x o_to_v1, which can be co-linear
+    const LaneVector3<T> v2_direction = laneCross(v0, v1);
+    const bool v2_colinear = laneAbsNorm(v2_direction) <=
+                             v0_abs_norm * laneAbsNorm(v1) * tolerance_;
+
+    // FindV3: the normal of v0v1v2 that is oriented "outside" the origin
+    const LaneVector3<T> v012_raw = laneCross(v0_to_v1, v0_to_v2);
+    const bool v3_swap_v1_v2 = laneDot(v012_raw, v0) > 0;
+    const LaneVector3<T> v3_direction =
+        laneSelect(v3_swap_v1_v2, laneNeg(v012_raw), v012_raw);
+
+    // FindPortal: orient v0123 by swapping v2/v3, which also exchanges and
+    // negates the normals of v031 and v012
+    const bool in_find_portal = phase == FindPortal;
+    const bool portal_iteration_limit =
+        in_find_portal && lanes.find_portal_iteration[i] >= max_iterations;
+    const LaneVector3<T> v031_raw = laneCross(v0_to_v3, v0_to_v1);
+    const LaneVector3<T> v023_raw = laneCross(v0_to_v2, v0_to_v3);
+    const bool portal_swap_v2_v3 =
+        in_find_portal && laneDot(v0_to_v2, v031_raw) < 0;
+    const LaneVector3<T> v031_normal =
+        laneSelect(portal_swap_v2_v3, laneNeg(v012_raw), v031_raw);
+    const LaneVector3<T> v012_normal =
+        laneSelect(portal_swap_v2_v3, laneNeg(v031_raw), v012_raw);
+    const LaneVector3<T> v023_normal =
+        laneSelect(portal_swap_v2_v3, laneNeg(v023_raw), v023_raw);
+    const bool v031_separated =
+        laneDot(v0, v031_normal) >
+        dot_eps_ratio * v0_abs_norm * laneAbsNorm(v031_normal);
+    const bool v012_separated =
+        laneDot(v0, v012_normal) >
+        dot_eps_ratio * v0_abs_norm * laneAbsNorm(v012_normal);
+    const bool v023_separated =
+        laneDot(v0, v023_normal) >
+        dot_eps_ratio * v0_abs_norm * laneAbsNorm(v023_normal);
+    const LaneVector3<T> portal_direction = laneNeg(laneSelect(
+        v031_separated, v031_normal,
+        laneSelect(v012_separated, v012_normal, v023_normal)));
+    const LaneInt portal_replace = v031_separated   ? LaneInt(2)
+                                   : v012_separated ? LaneInt(3)
+                                                    : LaneInt(1);
+    const bool portal_found = in_find_portal && !portal_iteration_limit &&
+                              !v031_separated && !v012_separated &&
+                              !v023_separated;
+    const LaneVector3<T> portal_v2 = laneSelect(portal_swap_v2_v3, v3, v2);
+    const LaneVector3<T> portal_v3 = laneSelect(portal_swap_v2_v3, v2, v3);
+
+    // RefinePortal: the normal of v123 that is oriented towards the origin
+    const bool in_refine = phase == RefinePortal || portal_found;
+    const bool refine_iteration_limit =
+        in_refine && lanes.refine_portal_iteration[i] >= max_iterations;
+    const LaneVector3<T> v123_raw =
+        laneCross(laneSub(portal_v2, v1), laneSub(portal_v3, v1));
+    const bool refine_swap_v2_v3 = in_refine && laneDot(v123_raw, v0) > 0;
+    const LaneVector3<T> v123_normal =
+        laneSelect(refine_swap_v2_v3, laneNeg(v123_raw), v123_raw);
+    const bool refine_intersect = !(laneDot(v1, v123_normal) < 0);
+
+    // Select the direction by phase
+    LaneVector3<T> direction = laneNeg(v0);
+    direction = laneSelect(phase == FindV2, v2_direction, direction);
+    direction = laneSelect(phase == FindV3, v3_direction, direction);
+    direction = laneSelect(in_find_portal, portal_direction, direction);
+    direction = laneSelect(in_refine, v123_normal, direction);
+    laneStore(direction, lanes.direction, i);
+
+    // Write back the vertices
+    const bool swap_v1_v2 = phase == FindV3 && v3_swap_v1_v2;
+    laneStore(laneSelect(swap_v1_v2, v2, v1), lanes.v1, i);
+    laneStore(laneSelect(swap_v1_v2, v1,
+                         laneSelect(refine_swap_v2_v3, portal_v3, portal_v2)),
+              lanes.v2, i);
+    laneStore(laneSelect(refine_swap_v2_v3, portal_v2, portal_v3), lanes.v3,
+              i);
+    lanes.portal_replace[i] = portal_replace;
+    lanes.find_portal_iteration[i] += in_find_portal ? 1 : 0;
+    lanes.refine_portal_iteration[i] += in_refine ? 1 : 0;
+
+    // Update the phase and status
+    const bool intersect = (phase == FindV2 && v2_colinear) ||
+                           (in_refine && !refine_iteration_limit &&
+                            refine_intersect);
+    const bool failed = portal_iteration_limit || refine_iteration_limit;
+    LaneInt new_phase = portal_found ? LaneInt(RefinePortal) : phase;
+    new_phase = (intersect || failed) ? LaneInt(Terminated) : new_phase;
+    lanes.phase[i] = new_phase;
+    LaneInt new_status = lanes.status[i];
+    new_status = intersect ? intersect_status : new_status;
+    new_status = failed ? failed_status : new_status;
+    lanes.status[i] = new_status;
+    n_running += (new_phase != Terminated) ? 1 : 0;
+  }
+  return n_running > 0;
+}
+
+template <typename T, std::size_t N>
+template <typename MinkowskiDiffT>
+void MPRBatch<T, N>::computeSupport(const MinkowskiDiffT* shapes,
+                                    LaneData& lanes) {
+  using namespace internal;
+  // Normalize the direction as MPR<T>::computeShapeSupport
+  for (std::size_t i = 0; i < N; i++) {
+    const LaneVector3<T> direction = laneLoad(lanes.direction, i);
+    const T squared_norm = laneDot(direction, direction);
+    const T norm = squared_norm > 0 ? std::sqrt(squared_norm) : T(1);
+    lanes.direction[0][i] = direction.x / norm;
+    lanes.direction[1][i] = direction.y / norm;
+    lanes.direction[2][i] = direction.z / norm;
+  }
+
+  // The support of each running lane
+  for (std::size_t i = 0; i < N; i++) {
+    if (lanes.phase[i] == Terminated) continue;
+    const Vector3<T> direction(lanes.direction[0][i], lanes.direction[1][i],
+                               lanes.direction[2][i]);
+    const Vector3<T> support =
+        shapes[lanes.shape_index[i]].support(direction);
+    for (int k = 0; k < 3; k++) lanes.support[k][i] = support[k];
+  }
+}
+
+template <typename T, std::size_t N>
+void MPRBatch<T, N>::updateVertex(LaneData& lanes) const {
+  using namespace internal;
+  const LaneInt separated_status =
+      static_cast<LaneInt>(IntersectStatus::Separated);
+  for (std::size_t i = 0; i < N; i++) {
+    const LaneInt phase = lanes.phase[i];
+    const LaneVector3<T> direction = laneLoad(lanes.direction, i);
+    const LaneVector3<T> support = laneLoad(lanes.support, i);
+    const LaneVector3<T> v0 = laneLoad(lanes.v0, i);
+    const LaneVector3<T> v1 = laneLoad(lanes.v1, i);
+    const LaneVector3<T> v2 = laneLoad(lanes.v2, i);
+    const LaneVector3<T> v3 = laneLoad(lanes.v3, i);
+
+    // The support does not pass the origin, or the new portal is too close
+    // to the separation plane
+    const bool in_refine = phase == RefinePortal;
+    const bool separated =
+        laneDot(support, direction) < 0 ||
+        (in_refine && std::abs(laneDot(laneSub(support, v1), direction)) <
+                          tolerance_ * laneAbsNorm(direction));
+
+    // The vertex to be replaced, by phase. For RefinePortal, it is selected
+    // by the plane of v0, v4 and the origin as MPR<T>::updatePortal
+    const LaneVector3<T> v0_v4_o_normal = laneCross(support, v0);
+    const bool v1_positive = laneDot(v1, v0_v4_o_normal) > 0;
+    const bool v2_positive = laneDot(v2, v0_v4_o_normal) > 0;
+    const bool v3_positive = laneDot(v3, v0_v4_o_normal) > 0;
+    const LaneInt refine_replace =
+        v1_positive ? (v2_positive ? LaneInt(1) : LaneInt(3))
+                    : (v3_positive ? LaneInt(2) : LaneInt(1));
+    LaneInt replace = lanes.portal_replace[i];
+    replace = phase == FindV1 ? LaneInt(1) : replace;
+    replace = phase == FindV2 ? LaneInt(2) : replace;
+    replace = phase == FindV3 ? LaneInt(3) : replace;
+    replace = in_refine ? refine_replace : replace;
+
+    const bool running = phase != Terminated;
+    const bool update = running && !separated;
+    laneStore(laneSelect(update && replace == 1, support, v1), lanes.v1, i);
+    laneStore(laneSelect(update && replace == 2, support, v2), lanes.v2, i);
+    laneStore(laneSelect(update && replace == 3, support, v3), lanes.v3, i);
+
+    // FindV1 -> FindV2 -> FindV3 -> FindPortal
+    LaneInt new_phase = phase < FindPortal ? LaneInt(phase + 1) : phase;
+    new_phase = (running && separated) ? LaneInt(Terminated) : new_phase;
+    lanes.phase[i] = new_phase;
+    lanes.status[i] =
+        (running && separated) ? separated_status : lanes.status[i];
+  }
+}
+
+}  // namespace cvx_collide
+}  // namespace fcl
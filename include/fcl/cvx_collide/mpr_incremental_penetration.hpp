@@ -36,9 +36,10 @@ void computeExploredDistanceLowerUpperBound(
 
 // The incremental minimum penetration query
 template <typename T>
+template <typename MinkowskiDiffT>
 typename MPR<T>::IncrementalMinDistanceSubroutineStatus
 MPR<T>::incrementalMinimumDistanceExploreDirection(
-    const MinkowskiDiff<T>& shape, const Vector3<T>& direction_to_explore,
+    const MinkowskiDiffT& shape, const Vector3<T>& direction_to_explore,
     // Both input/output
     Vector3<T>& v1, Vector3<T>& v2, Vector3<T>& v3,
     Vector3<T>& v1_dir_in_support, Vector3<T>& v2_dir_in_support,
@@ -187,9 +188,10 @@ MPR<T>::incrementalMinimumDistanceExploreDirection(
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 typename MPR<T>::IncrementalPenetrationStatus
 MPR<T>::RunIncrementalMinimumPenetrationDistance(
-    const MinkowskiDiff<T>& shape, const Vector3<T>& init_direction,
+    const MinkowskiDiffT& shape, const Vector3<T>& init_direction,
     IncrementalMinimumPenetrationData& refine_data, int max_iteration,
     T tolerance, bool return_on_subroutine_converge) {
   // The local variable
@@ -292,9 +294,10 @@ MPR<T>::RunIncrementalMinimumPenetrationDistance(
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 typename MPR<T>::IncrementalPenetrationStatus
 MPR<T>::IncrementalMinimumPenetrationDistance(
-    const MinkowskiDiff<T>& shape, const Vector3<T>& init_direction,
+    const MinkowskiDiffT& shape, const Vector3<T>& init_direction,
     IncrementalMinimumPenetrationData& refine_data,
     bool return_on_subroutine_converge) const {
   return RunIncrementalMinimumPenetrationDistance(
@@ -303,8 +306,9 @@ MPR<T>::IncrementalMinimumPenetrationDistance(
 }
 
 template <typename T>
+template <typename MinkowskiDiffT>
 void MPR<T>::finalizeIncrementalPenetrationResult(
-    const MinkowskiDiff<T>& shape, const Vector3<T>& ray_direction,
+    const MinkowskiDiffT& shape, const Vector3<T>& ray_direction,
     const Vector3<T>& v1, const Vector3<T>& v2, const Vector3<T>& v3,
     const Vector3<T>& v1_dir, const Vector3<T>& v2_dir,
     const Vector3<T>& v3_dir, const Vector3<T>& v123_normal_arg, T distance_lb,
@@ -15,6 +15,9 @@
 #include "fcl/geometry/octree2/octree.h"
 #include "fcl/geometry/octree2/octree_visit.h"
 #include "fcl/geometry/octree2/octree_prune.h"
+#include "fcl/geometry/octree2/octree_lod.h"
+#include "fcl/geometry/octree2/octree_raycast.h"
+#include "fcl/geometry/octree2/octree_region.h"
 #include "fcl/geometry/octree2/octree_collision_geometry.h"
 #include "fcl/geometry/shape/box.h"
 #include "fcl/geometry/shape/capsule.h"
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <thread>
+
 namespace fcl {
 namespace heightmap {
 
@@ -10,11 +13,8 @@ FlatHeightMap<S>::FlatHeightMap(S resolution_x, S resolution_y,
                                 uint16_t half_map_shape_y)
     : xy_info{{resolution_x, half_map_shape_x, uint16_t(half_map_shape_x * 2)},
               {resolution_y, half_map_shape_y, uint16_t(half_map_shape_y * 2)}},
-      height_upper_bound_in_mm(0) {
-  const std::size_t map_flat_size =
-      xy_info[0].full_shape * xy_info[1].full_shape;
-  heightmap_in_mm.resize(map_flat_size, 0);
-}
+      heightmap_in_mm(xy_info[0].full_shape, xy_info[1].full_shape),
+      height_upper_bound_in_mm(0) {}
 
 template <typename S>
 FlatHeightMap<S>::FlatHeightMap(S resolution, uint16_t half_map_shape)
@@ -29,8 +29,7 @@ uint16_t FlatHeightMap<S>::pixelHeight(const Pixel& pixel) const {
   }
 
   // OK to obtain height
-  const std::size_t flat_index = pixelToFlatIndex(pixel);
-  return heightmap_in_mm[flat_index];
+  return heightmap_in_mm.get(pixel.x, pixel.y);
 }
 
 template <typename S>
@@ -116,11 +115,6 @@ void FlatHeightMap<S>::pixelToPoint2DUnchecked(
   }
 }
 
-template <typename S>
-std::size_t FlatHeightMap<S>::pixelToFlatIndex(const Pixel& pixel) const {
-  return pixel.y * full_shape_x() + pixel.x;
-}
-
 template <typename S>
 bool FlatHeightMap<S>::pixelToBox(const Pixel& pixel, Box<S>& box,
                                   Vector3<S>& box_center) const {
@@ -190,7 +184,7 @@ bool FlatHeightMap<S>::pixelToBox(const Pixel& pixel, AABB<S>& aabb) const {
 /// Update the height map using the points, iterators or functors
 template <typename S>
 void FlatHeightMap<S>::resetHeights() {
-  std::fill(heightmap_in_mm.begin(), heightmap_in_mm.end(), 0);
+  heightmap_in_mm.clear();
   height_upper_bound_in_mm = 0;
 }
 
@@ -204,8 +198,8 @@ void FlatHeightMap<S>::updateHeightsByPointCloud3D(
       y = points[index].y();
       z = points[index].z();
     } else {
-      Eigen::Vector3f point3f{points[index].x(), points[index].x(),
-                              points[index].x()};
+      Eigen::Vector3f point3f{points[index].x(), points[index].y(),
+                              points[index].z()};
       Eigen::Vector3f point_tf = (*points_to_heightmap_frame) * (point3f);
       x = point_tf.x();
       y = point_tf.y();
@@ -236,38 +230,210 @@ void FlatHeightMap<S>::updateHeightsByPoint3DIterator(
     Pixel pixel;
     bool in_range = point2DToPixel(Point2D<S>(point3d.x(), point3d.y()), pixel);
     if (in_range) {
-      const auto index = pixel.y * full_shape_x() + pixel.x;
-      const int z = static_cast<uint16_t>(point3d.z() * 1000);
-      if (heightmap_in_mm[index] < z)
-        heightmap_in_mm[index] = static_cast<uint16_t>(z);
-      if (height_upper_bound_in_mm < heightmap_in_mm[index])
-        height_upper_bound_in_mm = heightmap_in_mm[index];
+      const uint16_t z = static_cast<uint16_t>(point3d.z() * 1000);
+      const uint16_t height = heightmap_in_mm.updateMax(pixel.x, pixel.y, z);
+      if (height_upper_bound_in_mm < height) height_upper_bound_in_mm = height;
     }
   }
 }
 
 template <typename S>
 void FlatHeightMap<S>::updateHeightsByPointGenerationFunctor(
-    const PointGenerationFunc& point_generator, int n_points) {
-  for (auto i = 0; i < n_points; i++) {
-    S point_x, point_y, point_z;
-    point_generator(i, point_x, point_y, point_z);
+    const PointGenerationFunc& point_generator, int n_points, int n_threads) {
+  auto ingest_points = [&](std::size_t point_begin, std::size_t point_end,
+                           HeightMapTiles& heights) -> uint16_t {
+    uint16_t max_height_in_mm = 0;
+    for (auto i = point_begin; i < point_end; i++) {
+      S point_x, point_y, point_z;
+      point_generator(static_cast<int>(i), point_x, point_y, point_z);
+
+      // Do not handle negative z
+      if (point_z < 0) continue;
+
+      // Map to image
+      Pixel pixel;
+      bool in_range = point2DToPixel(Point2D<S>(point_x, point_y), pixel);
+      if (in_range) {
+        const uint16_t z = static_cast<uint16_t>(point_z * 1000);
+        const uint16_t height = heights.updateMax(pixel.x, pixel.y, z);
+        if (max_height_in_mm < height) max_height_in_mm = height;
+      }
+    }
+    return max_height_in_mm;
+  };
+  if (n_points <= 0) return;
+  ingestPointsInParallel(static_cast<std::size_t>(n_points), n_threads,
+                         ingest_points);
+}
 
-    // Do not handle negative z
-    if (point_z < 0) continue;
+template <typename S>
+void FlatHeightMap<S>::updateHeightsByXYZBuffer(
+    const float* xyz, std::size_t n_points,
+    const Eigen::Isometry3f* points_to_heightmap_frame, int n_threads) {
+  if (xyz == nullptr || n_points == 0) return;
+  const internal::HeightMapPointQuantizer quantizer =
+      makePointQuantizer(points_to_heightmap_frame);
+  auto ingest_points = [&](std::size_t point_begin, std::size_t point_end,
+                           HeightMapTiles& heights) -> uint16_t {
+    return internal::ingestXYZBuffer(quantizer, xyz, point_begin, point_end,
+                                     heights);
+  };
+  ingestPointsInParallel(n_points, n_threads, ingest_points);
+}
 
-    // Map to image
-    Pixel pixel;
-    bool in_range = point2DToPixel(Point2D<S>(point_x, point_y), pixel);
-    if (in_range) {
-      const auto index = pixel.y * full_shape_x() + pixel.x;
-      const int z = static_cast<uint16_t>(point_z * 1000);
-      if (heightmap_in_mm[index] < z)
-        heightmap_in_mm[index] = static_cast<uint16_t>(z);
-      if (height_upper_bound_in_mm < heightmap_in_mm[index])
-        height_upper_bound_in_mm = heightmap_in_mm[index];
+template <typename S>
+void FlatHeightMap<S>::updateHeightsByDepthImage(
+    const uint16_t* depth_image, const PinholeCameraIntrinsic<float>& intrinsic,
+    const Eigen::Isometry3f& camera_to_heightmap_frame, float depth_scale,
+    int n_threads) {
+  updateHeightsByDepthImageImpl(depth_image, intrinsic,
+                                camera_to_heightmap_frame, depth_scale,
+                                n_threads);
+}
+
+template <typename S>
+void FlatHeightMap<S>::updateHeightsByDepthImage(
+    const float* depth_image, const PinholeCameraIntrinsic<float>& intrinsic,
+    const Eigen::Isometry3f& camera_to_heightmap_frame, float depth_scale,
+    int n_threads) {
+  updateHeightsByDepthImageImpl(depth_image, intrinsic,
+                                camera_to_heightmap_frame, depth_scale,
+                                n_threads);
+}
+
+template <typename S>
+template <typename DepthT>
+void FlatHeightMap<S>::updateHeightsByDepthImageImpl(
+    const DepthT* depth_image, const PinholeCameraIntrinsic<float>& intrinsic,
+    const Eigen::Isometry3f& camera_to_heightmap_frame, float depth_scale,
+    int n_threads) {
+  if (depth_image == nullptr || intrinsic.width <= 0 || intrinsic.height <= 0)
+    return;
+
+  // The transform is applied in the unprojection
+  const internal::HeightMapPointQuantizer quantizer =
+      makePointQuantizer(nullptr);
+  internal::HeightMapDepthImageUnprojector unprojector;
+  unprojector.ray_x_of_column.resize(intrinsic.width);
+  for (int col = 0; col < intrinsic.width; col++) {
+    unprojector.ray_x_of_column[col] =
+        (float(col) - intrinsic.cx) / intrinsic.fx;
+  }
+  unprojector.fy = intrinsic.fy;
+  unprojector.cy = intrinsic.cy;
+  unprojector.width = intrinsic.width;
+  unprojector.depth_scale = depth_scale;
+  for (int row = 0; row < 3; row++) {
+    for (int col = 0; col < 3; col++) {
+      unprojector.rotation[3 * row + col] =
+          camera_to_heightmap_frame.linear()(row, col);
+    }
+    unprojector.translation[row] = camera_to_heightmap_frame.translation()[row];
+  }
+
+  auto ingest_pixels = [&](std::size_t pixel_begin, std::size_t pixel_end,
+                           HeightMapTiles& heights) -> uint16_t {
+    return internal::ingestDepthImage(quantizer, unprojector, depth_image,
+                                      pixel_begin, pixel_end, heights);
+  };
+  ingestPointsInParallel(intrinsic.n_pixels(), n_threads, ingest_pixels);
+}
+
+template <typename S>
+internal::HeightMapPointQuantizer FlatHeightMap<S>::makePointQuantizer(
+    const Eigen::Isometry3f* points_to_heightmap_frame) const {
+  internal::HeightMapPointQuantizer quantizer;
+  quantizer.has_transform = points_to_heightmap_frame != nullptr;
+  if (quantizer.has_transform) {
+    for (int row = 0; row < 3; row++) {
+      for (int col = 0; col < 3; col++) {
+        quantizer.rotation[3 * row + col] =
+            points_to_heightmap_frame->linear()(row, col);
+      }
+      quantizer.translation[row] =
+          points_to_heightmap_frame->translation()[row];
     }
   }
+  quantizer.resolution_x = static_cast<float>(resolution_x());
+  quantizer.resolution_y = static_cast<float>(resolution_y());
+  quantizer.half_shape_x = half_shape_x();
+  quantizer.half_shape_y = half_shape_y();
+  quantizer.full_shape_x = full_shape_x();
+  quantizer.full_shape_y = full_shape_y();
+  return quantizer;
+}
+
+template <typename S>
+template <typename IngestPointsFunc>
+void FlatHeightMap<S>::ingestPointsInParallel(
+    std::size_t n_points, int n_threads,
+    const IngestPointsFunc& ingest_points) {
+  if (n_threads <= 0) {
+    n_threads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  const std::size_t max_n_threads =
+      std::max<std::size_t>(1, n_points / kMinPointsPerIngestionThread);
+  n_threads = static_cast<int>(std::max<std::size_t>(
+      1, std::min<std::size_t>(n_threads, max_n_threads)));
+  if (n_threads == 1) {
+    const uint16_t max_height_in_mm =
+        ingest_points(0, n_points, heightmap_in_mm);
+    height_upper_bound_in_mm =
+        std::max(height_upper_bound_in_mm, max_height_in_mm);
+    return;
+  }
+
+  // The first chunk is reduced into this map, others into their own
+  // (sparse) copy
+  std::vector<HeightMapTiles> thread_heights(
+      n_threads - 1, HeightMapTiles(full_shape_x(), full_shape_y()));
+  std::vector<uint16_t> thread_max_height(n_threads, 0);
+  auto ingest_chunk = [&](int thread_i) -> void {
+    const std::size_t point_begin = n_points * thread_i / n_threads;
+    const std::size_t point_end = n_points * (thread_i + 1) / n_threads;
+    HeightMapTiles& heights =
+        thread_i > 0 ? thread_heights[thread_i - 1] : heightmap_in_mm;
+    thread_max_height[thread_i] =
+        ingest_points(point_begin, point_end, heights);
+  };
+
+  // Max-merge by tiles with a shared counter, only the tiles written by
+  // the other threads are touched
+  std::atomic<int> next_tile{0};
+  const int n_tiles = static_cast<int>(heightmap_in_mm.n_tiles());
+  auto merge_tiles = [&]() -> void {
+    while (true) {
+      const int tile = next_tile.fetch_add(1);
+      if (tile >= n_tiles) break;
+      for (const auto& heights : thread_heights) {
+        const uint16_t* src = heights.tile(tile);
+        if (src == nullptr) continue;
+        internal::maxMergeHeights(heightmap_in_mm.mutableTile(tile), src,
+                                  HeightMapTiles::kTileSize);
+      }
+    }
+  };
+
+  // Only the chunks in worker threads
+  {
+    std::vector<std::thread> workers;
+    workers.reserve(n_threads - 1);
+    for (int i = 1; i < n_threads; i++) workers.emplace_back(ingest_chunk, i);
+    ingest_chunk(0);
+    for (auto& worker : workers) worker.join();
+  }
+  {
+    std::vector<std::thread> workers;
+    workers.reserve(n_threads - 1);
+    for (int i = 1; i < n_threads; i++) workers.emplace_back(merge_tiles);
+    merge_tiles();
+    for (auto& worker : workers) worker.join();
+  }
+
+  for (const uint16_t max_height_in_mm : thread_max_height) {
+    height_upper_bound_in_mm =
+        std::max(height_upper_bound_in_mm, max_height_in_mm);
+  }
 }
 
 template <typename S>
@@ -285,17 +451,130 @@ void FlatHeightMap<S>::visitHeightMap(const VisitHeightMapFunctor& visitor,
       pixelToPoint2DUnchecked(pixel, box_bottom_center,
                               PixelToPoint2DType::Center);
       // Do not need checking here
-      uint16_t height_in_mm = heightmap_in_mm[pixelToFlatIndex(pixel)];
+      uint16_t height_in_mm = heightmap_in_mm.get(x, y);
       bool done = visitor(pixel, box_bottom_center, height_in_mm);
       if (done) return;
     }
   }
 }
 
+template <typename S>
+void FlatHeightMap<S>::visitNonZeroHeights(const VisitHeightMapFunctor& visitor,
+                                           const PixelSpaceROI* roi) const {
+  // Obtain the range
+  Pixel top_left, bottom_right;
+  rectifyHeightMapROI(top_left, bottom_right, roi);
+
+  // Visit the allocated tiles in range
+  constexpr std::size_t kTileShapeLog2 = HeightMapTiles::kTileShapeLog2;
+  for (std::size_t tile_y = top_left.y >> kTileShapeLog2;
+       tile_y <= std::size_t(bottom_right.y >> kTileShapeLog2); tile_y++) {
+    for (std::size_t tile_x = top_left.x >> kTileShapeLog2;
+         tile_x <= std::size_t(bottom_right.x >> kTileShapeLog2); tile_x++) {
+      const uint16_t* tile =
+          heightmap_in_mm.tile(heightmap_in_mm.tileIndex(tile_x, tile_y));
+      if (tile == nullptr) continue;
+
+      // The range in this tile
+      const std::size_t y_begin =
+          std::max<std::size_t>(top_left.y, tile_y << kTileShapeLog2);
+      const std::size_t y_end = std::min<std::size_t>(
+          std::size_t(bottom_right.y) + 1, (tile_y + 1) << kTileShapeLog2);
+      const std::size_t x_begin =
+          std::max<std::size_t>(top_left.x, tile_x << kTileShapeLog2);
+      const std::size_t x_end = std::min<std::size_t>(
+          std::size_t(bottom_right.x) + 1, (tile_x + 1) << kTileShapeLog2);
+      for (std::size_t y = y_begin; y < y_end; y++) {
+        for (std::size_t x = x_begin; x < x_end; x++) {
+          const uint16_t height_in_mm =
+              tile[HeightMapTiles::pixelToOffsetInTile(x, y)];
+          if (height_in_mm == 0) continue;
+          Pixel pixel(static_cast<uint16_t>(x), static_cast<uint16_t>(y));
+          Point2D<S> box_bottom_center;
+          pixelToPoint2DUnchecked(pixel, box_bottom_center,
+                                  PixelToPoint2DType::Center);
+          if (visitor(pixel, box_bottom_center, height_in_mm)) return;
+        }
+      }
+    }
+  }
+}
+
+template <typename S>
+uint16_t FlatHeightMap<S>::maxHeightInRow(uint16_t y, uint16_t x_begin,
+                                          uint16_t x_end) const {
+  assert(y < full_shape_y() && x_end < full_shape_x());
+  uint16_t max_height_in_mm = 0;
+  constexpr std::size_t kTileShape = HeightMapTiles::kTileShape;
+  for (std::size_t x_0 = x_begin; x_0 <= x_end;) {
+    // The segment in this tile
+    const std::size_t x_1 =
+        std::min<std::size_t>(std::size_t(x_end) + 1,
+                              (x_0 / kTileShape + 1) * kTileShape);
+    const uint16_t* tile =
+        heightmap_in_mm.tile(heightmap_in_mm.pixelToTileIndex(x_0, y));
+    if (tile != nullptr) {
+      const uint16_t* row = tile + HeightMapTiles::pixelToOffsetInTile(x_0, y);
+      for (std::size_t i = 0; i < x_1 - x_0; i++) {
+        max_height_in_mm = std::max(max_height_in_mm, row[i]);
+      }
+    }
+    x_0 = x_1;
+  }
+  return max_height_in_mm;
+}
+
+template <typename S>
+void FlatHeightMap<S>::copyRow(uint16_t y, uint16_t x_begin, uint16_t x_end,
+                               uint16_t* heights_in_mm) const {
+  assert(y < full_shape_y() && x_end < full_shape_x());
+  constexpr std::size_t kTileShape = HeightMapTiles::kTileShape;
+  for (std::size_t x_0 = x_begin; x_0 <= x_end;) {
+    const std::size_t x_1 =
+        std::min<std::size_t>(std::size_t(x_end) + 1,
+                              (x_0 / kTileShape + 1) * kTileShape);
+    uint16_t* out = heights_in_mm + (x_0 - x_begin);
+    const uint16_t* tile =
+        heightmap_in_mm.tile(heightmap_in_mm.pixelToTileIndex(x_0, y));
+    if (tile == nullptr) {
+      std::fill(out, out + (x_1 - x_0), uint16_t(0));
+    } else {
+      const uint16_t* row = tile + HeightMapTiles::pixelToOffsetInTile(x_0, y);
+      std::copy(row, row + (x_1 - x_0), out);
+    }
+    x_0 = x_1;
+  }
+}
+
+template <typename S>
+void FlatHeightMap<S>::copyColumn(uint16_t x, uint16_t y_begin, uint16_t y_end,
+                                  uint16_t* heights_in_mm) const {
+  assert(x < full_shape_x() && y_end < full_shape_y());
+  constexpr std::size_t kTileShape = HeightMapTiles::kTileShape;
+  for (std::size_t y_0 = y_begin; y_0 <= y_end;) {
+    const std::size_t y_1 =
+        std::min<std::size_t>(std::size_t(y_end) + 1,
+                              (y_0 / kTileShape + 1) * kTileShape);
+    uint16_t* out = heights_in_mm + (y_0 - y_begin);
+    const uint16_t* tile =
+        heightmap_in_mm.tile(heightmap_in_mm.pixelToTileIndex(x, y_0));
+    if (tile == nullptr) {
+      std::fill(out, out + (y_1 - y_0), uint16_t(0));
+    } else {
+      const uint16_t* column =
+          tile + HeightMapTiles::pixelToOffsetInTile(x, y_0);
+      for (std::size_t i = 0; i < y_1 - y_0; i++) {
+        out[i] = column[i * kTileShape];
+      }
+    }
+    y_0 = y_1;
+  }
+}
+
 template <typename S>
 PointCloud FlatHeightMap<S>::toPointCloud() const {
   octomap::Pointcloud cloud;
-  cloud.reserve(heightmap_in_mm.size());
+  cloud.reserve(std::size_t(full_shape_x()) * full_shape_y());
   auto append_point = [&cloud](const Pixel& pixel,
                                const Point2D<S>& box_bottom_center,
                                uint16_t height_in_mm) -> bool {
@@ -330,14 +609,14 @@ void FlatHeightMap<S>::updateHeightsByFunctor(
       pixelToPoint2DUnchecked(pixel, box_bottom_center,
                               PixelToPoint2DType::Center);
       // Do not need checking here
-      old_height_in_mm = heightmap_in_mm[pixelToFlatIndex(pixel)];
+      old_height_in_mm = heightmap_in_mm.get(x, y);
       new_height_in_mm = old_height_in_mm;
       done =
           visitor(pixel, box_bottom_center, old_height_in_mm, new_height_in_mm);
 
       // Do need update the map
       if (old_height_in_mm != new_height_in_mm) {
-        heightmap_in_mm[pixelToFlatIndex(pixel)] = new_height_in_mm;
+        heightmap_in_mm.set(x, y, new_height_in_mm);
         if (new_height_in_mm > height_upper_bound_in_mm) {
           height_upper_bound_in_mm = new_height_in_mm;
         }
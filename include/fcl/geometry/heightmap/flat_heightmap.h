@@ -2,7 +2,10 @@
 #include <array>
 #include <memory>
 
+#include "fcl/geometry/heightmap/heightmap_ingestion_kernel.h"
+#include "fcl/geometry/heightmap/heightmap_tiles.h"
 #include "fcl/geometry/heightmap/heightmap_types.h"
+#include "fcl/math/pinhole_camera.h"
 
 namespace fcl {
 namespace heightmap {
@@ -20,7 +23,8 @@ class LayeredHeightMap;
 /// the x-axis in usual image coordinate. Similar holds for y-axis and cols.
 ///
 /// "Flat" heightmap implies this heightmap is stored as an flat "image".
-/// Alternatively, we might consider a sparse or hierarchical representation.
+/// The image is stored as tiles that are allocated on the first write, thus
+/// the empty region of a large map does not consume memory.
 /// \tparam S
 template <typename S>
 class FlatHeightMap {
@@ -31,9 +35,9 @@ class FlatHeightMap {
     uint16_t full_shape;
   } xy_info[2];
 
-  /// Vector with maximum height values for every bin (height map)
-  /// Column-major representation (cols are continuous)
-  std::vector<uint16_t> heightmap_in_mm;
+  /// The maximum height values for every bin (height map)
+  /// Column-major representation (cols are continuous) in each tile
+  HeightMapTiles heightmap_in_mm;
 
   /// A upper bound of the heights in the map
   /// When there is no remove (or reduction of heights in update), this
@@ -79,7 +83,6 @@ class FlatHeightMap {
   void pixelToPoint2DUnchecked(
       const Pixel& pixel, Point2D<S>& point_output,
       PixelToPoint2DType query_type = PixelToPoint2DType::Center) const;
-  std::size_t pixelToFlatIndex(const Pixel& pixel) const;
 
   /// Update the height map using the points, iterators and functor
  public:
@@ -91,9 +94,36 @@ class FlatHeightMap {
   void updateHeightsByPoint3DIterator(
       const Point3DIterator& begin, const Point3DIterator& end,
       const Eigen::Isometry3f* points_to_heightmap_frame = nullptr);
+  /// The ingestion below can be split into n_threads (non-positive implies
+  /// std::thread::hardware_concurrency). Each thread reduces its points into
+  /// its own copy of the map, which are max-merged at the end. Thus, the
+  /// point_generator must be thread-safe if n_threads != 1.
   using PointGenerationFunc = std::function<void(int index, S& x, S& y, S& z)>;
   void updateHeightsByPointGenerationFunctor(
-      const PointGenerationFunc& point_generator, int n_points);
+      const PointGenerationFunc& point_generator, int n_points,
+      int n_threads = 1);
+
+  /// Update by a contiguous buffer of float [x0, y0, z0, x1, y1, z1, ...],
+  /// the transform and quantization are vectorized and performed in float.
+  void updateHeightsByXYZBuffer(
+      const float* xyz, std::size_t n_points,
+      const Eigen::Isometry3f* points_to_heightmap_frame = nullptr,
+      int n_threads = 1);
+
+  /// Update by an organized depth image (row-major, intrinsic.width is the
+  /// row stride) of a pinhole camera, whose pose in heightmap frame is given.
+  /// The pixels are unprojected, transformed and max-reduced in one pass
+  /// without intermediate point cloud. The depth in meter is computed as
+  /// depth_scale * depth, and pixels with zero (or invalid) depth are skipped.
+  void updateHeightsByDepthImage(
+      const uint16_t* depth_image,
+      const PinholeCameraIntrinsic<float>& intrinsic,
+      const Eigen::Isometry3f& camera_to_heightmap_frame,
+      float depth_scale = 0.001f, int n_threads = 1);
+  void updateHeightsByDepthImage(
+      const float* depth_image, const PinholeCameraIntrinsic<float>& intrinsic,
+      const Eigen::Isometry3f& camera_to_heightmap_frame,
+      float depth_scale = 1.0f, int n_threads = 1);
 
   /// Visit or update the height map using arbitrary functor
   /// The visitor/updater functor return a bool indicate
@@ -111,6 +141,20 @@ class FlatHeightMap {
   // The visit is potentially limited by a region_of_interest
   void visitHeightMap(const VisitHeightMapFunctor& visitor,
                       const PixelSpaceROI* roi = nullptr) const;
+  // Same as visitHeightMap, but the pixels with zero height are skipped
+  // (as well as the absent tiles), and the visit order is tile-by-tile.
+  void visitNonZeroHeights(const VisitHeightMapFunctor& visitor,
+                           const PixelSpaceROI* roi = nullptr) const;
+  // The max height of the pixels [x_begin, x_end] (inclusive) of row y,
+  // which must be in range. The absent tiles are skipped.
+  uint16_t maxHeightInRow(uint16_t y, uint16_t x_begin, uint16_t x_end) const;
+  // Copy the heights of the pixels [x_begin, x_end] of row y (or the pixels
+  // [y_begin, y_end] of column x) into a dense buffer, the absent tiles are
+  // written as zero. The pixels must be in range.
+  void copyRow(uint16_t y, uint16_t x_begin, uint16_t x_end,
+               uint16_t* heights_in_mm) const;
+  void copyColumn(uint16_t x, uint16_t y_begin, uint16_t y_end,
+                  uint16_t* heights_in_mm) const;
   void updateHeightsByFunctor(const UpdateHeightMapFunctor& visitor,
                               const PixelSpaceROI* roi = nullptr);
   PointCloud toPointCloud() const;
@@ -127,8 +171,26 @@ class FlatHeightMap {
   S height_upper_bound_meter() const;
   S half_range_x() const;
   S half_range_y() const;
+  /// The memory of the allocated tiles
+  std::size_t allocated_bytes() const {
+    return heightmap_in_mm.allocated_bytes();
+  }
 
  private:
+  internal::HeightMapPointQuantizer makePointQuantizer(
+      const Eigen::Isometry3f* points_to_heightmap_frame) const;
+  template <typename DepthT>
+  void updateHeightsByDepthImageImpl(
+      const DepthT* depth_image, const PinholeCameraIntrinsic<float>& intrinsic,
+      const Eigen::Isometry3f& camera_to_heightmap_frame, float depth_scale,
+      int n_threads);
+
+  /// Run ingest_points(point_begin, point_end, heights) on n_threads chunks
+  /// of the points, which return the max height written into the tiles.
+  static constexpr std::size_t kMinPointsPerIngestionThread = 1 << 16;
+  template <typename IngestPointsFunc>
+  void ingestPointsInParallel(std::size_t n_points, int n_threads,
+                              const IngestPointsFunc& ingest_points);
   void rectifyHeightMapROI(Pixel& top_left, Pixel& bottom_right,
                            const PixelSpaceROI* roi = nullptr) const;
 };
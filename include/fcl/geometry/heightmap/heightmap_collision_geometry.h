@@ -4,6 +4,32 @@
 
 namespace fcl {
 
+/// The cost model to choose between the flat (visit every bottom pixel in
+/// the region of interest) and traversal algorithm in heightmap-shape
+/// collision. The costs are relative, and can be calibrated by benchmarking
+/// both algorithms on the target machine.
+template <typename S>
+struct HeightMapShapeCollisionCostModel {
+  /// Visit a bottom pixel in the flat algorithm
+  S flat_pixel_cost{1.0};
+  /// Visit a node in traversal, i.e., compute its AABB and OBB disjoint test
+  S traversal_node_cost{3.0};
+  /// The narrowphase of a pixel box with the shape, for both algorithms
+  S leaf_cost{20.0};
+
+  /// The shape occupies a fill_ratio of the roi with roi_pixels. The
+  /// traversal only visits the occupied part, with 4/3 nodes per bottom
+  /// pixel for the 4-ary tree and the descent of n_seeds from seed_depth.
+  S flatCost(S roi_pixels) const {
+    return roi_pixels * (flat_pixel_cost + leaf_cost);
+  }
+  S traversalCost(S roi_pixels, S fill_ratio, S n_seeds, S seed_depth) const {
+    return roi_pixels * fill_ratio *
+               (S(4.0 / 3.0) * traversal_node_cost + leaf_cost) +
+           n_seeds * seed_depth * traversal_node_cost;
+  }
+};
+
 /// CollisionGeometry class for HeightMap for integration
 /// in fcl::collide. Just a const shared_ptr to the actual
 /// LayeredHeightMap.
@@ -22,9 +48,20 @@ class HeightMapCollisionGeometry : public CollisionGeometry<S> {
   NODE_TYPE getNodeType() const override;
   const HeightMapPtr& raw_heightmap() const;
 
+  /// The cost model for choosing the heightmap-shape collision algorithm
+  const HeightMapShapeCollisionCostModel<S>& shape_collision_cost_model()
+      const {
+    return shape_collision_cost_model_;
+  }
+  void setShapeCollisionCostModel(
+      const HeightMapShapeCollisionCostModel<S>& cost_model) {
+    shape_collision_cost_model_ = cost_model;
+  }
+
   /// Read-only, shared_ptr access to a height_map
  private:
   std::shared_ptr<const heightmap::LayeredHeightMap<S>> height_map;
+  HeightMapShapeCollisionCostModel<S> shape_collision_cost_model_;
 };
 
 // template specialized for float/double
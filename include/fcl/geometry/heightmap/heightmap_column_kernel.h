@@ -0,0 +1,61 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "fcl/math/math_simd_details.h"
+
+namespace fcl {
+namespace heightmap {
+namespace internal {
+
+/// Given two rows of n heights that are aligned pixel-by-pixel, write the
+/// index i of each column with row_1[i] >= lower_1 and row_2[i] >= lower_2
+/// into columns (which must hold n indices), and return the number of them.
+inline std::size_t findColumnsAboveBoth(const uint16_t* row_1,
+                                        const uint16_t* row_2, std::size_t n,
+                                        uint16_t lower_1, uint16_t lower_2,
+                                        uint16_t* columns) {
+  std::size_t n_columns = 0;
+  std::size_t i = 0;
+#ifdef FCL_SSE_ENABLED
+  // There is no unsigned compare in SSE2, h >= lower iff (lower -| h) == 0
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i lower_1_x8 = _mm_set1_epi16(static_cast<short>(lower_1));
+  const __m128i lower_2_x8 = _mm_set1_epi16(static_cast<short>(lower_2));
+  for (; i + 8 <= n; i += 8) {
+    const __m128i heights_1 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row_1 + i));
+    const __m128i heights_2 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row_2 + i));
+    const __m128i above_both = _mm_and_si128(
+        _mm_cmpeq_epi16(_mm_subs_epu16(lower_1_x8, heights_1), zero),
+        _mm_cmpeq_epi16(_mm_subs_epu16(lower_2_x8, heights_2), zero));
+    const int mask = _mm_movemask_epi8(above_both);
+    if (mask == 0) continue;
+
+    // Two bits for each 16-bit lane
+    for (std::size_t lane = 0; lane < 8; lane++) {
+      if (mask & (1 << (2 * lane))) {
+        columns[n_columns++] = static_cast<uint16_t>(i + lane);
+      }
+    }
+  }
+#endif
+
+  // The remaining (or all of them without sse)
+  for (; i < n; i++) {
+    if (row_1[i] >= lower_1 && row_2[i] >= lower_2) {
+      columns[n_columns++] = static_cast<uint16_t>(i);
+    }
+  }
+  return n_columns;
+}
+
+}  // namespace internal
+}  // namespace heightmap
+}  // namespace fcl
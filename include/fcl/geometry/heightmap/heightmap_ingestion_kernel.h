@@ -0,0 +1,337 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "fcl/geometry/heightmap/heightmap_pyramid_kernel.h"
+#include "fcl/geometry/heightmap/heightmap_tiles.h"
+
+namespace fcl {
+namespace heightmap {
+namespace internal {
+
+/// The parameters to map a float point (in its own frame) to a pixel and
+/// its height in mm. All computation is performed in float, as the input.
+struct HeightMapPointQuantizer {
+  // Row-major rotation and the translation of points_to_heightmap_frame
+  bool has_transform{false};
+  float rotation[9];
+  float translation[3];
+
+  // Pixel info of the map
+  float resolution_x;
+  float resolution_y;
+  int half_shape_x;
+  int half_shape_y;
+  int full_shape_x;
+  int full_shape_y;
+};
+
+/// Transform and quantize a point, return false if it is not in the map
+/// or below the xOy plane.
+inline bool quantizePoint(const HeightMapPointQuantizer& quantizer, float x,
+                          float y, float z, int& pixel_x_out,
+                          int& pixel_y_out, uint16_t& height_in_mm) {
+  if (quantizer.has_transform) {
+    const float* r = quantizer.rotation;
+    const float* t = quantizer.translation;
+    const float x_tf = ((r[0] * x + r[1] * y) + r[2] * z) + t[0];
+    const float y_tf = ((r[3] * x + r[4] * y) + r[5] * z) + t[1];
+    const float z_tf = ((r[6] * x + r[7] * y) + r[8] * z) + t[2];
+    x = x_tf;
+    y = y_tf;
+    z = z_tf;
+  }
+
+  // Do not handle negative z (or nan)
+  if (!(z >= 0.0f)) return false;
+  const float pixel_x = std::floor(x / quantizer.resolution_x);
+  const float pixel_y = std::floor(y / quantizer.resolution_y);
+  if (!(pixel_x >= -quantizer.half_shape_x &&
+        pixel_x < quantizer.half_shape_x &&
+        pixel_y >= -quantizer.half_shape_y &&
+        pixel_y < quantizer.half_shape_y)) {
+    return false;
+  }
+
+  pixel_x_out = static_cast<int>(pixel_x) + quantizer.half_shape_x;
+  pixel_y_out = static_cast<int>(pixel_y) + quantizer.half_shape_y;
+  height_in_mm =
+      static_cast<uint16_t>(std::min(z * 1000.0f, float(UINT16_MAX)));
+  return true;
+}
+
+#ifdef FCL_SSE_ENABLED
+/// floor() of 4 floats in SSE2, the input must be in the int32 range
+inline __m128 floorPs(__m128 x) {
+  const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+  const __m128 is_rounded_up = _mm_cmpgt_ps(truncated, x);
+  return _mm_sub_ps(truncated, _mm_and_ps(is_rounded_up, _mm_set1_ps(1.0f)));
+}
+
+/// Quantize 4 points that are already in the heightmap frame, lanes with
+/// zero valid_in are ignored. The output pixels are only meaningful for
+/// lanes with a non-zero valid flag.
+inline void quantize4PointsInHeightMapFrame(
+    const HeightMapPointQuantizer& quantizer, __m128 x, __m128 y, __m128 z,
+    __m128 valid_in, int pixel_x_out[4], int pixel_y_out[4],
+    int height_in_mm[4], int valid[4]) {
+  // Clamp before floorPs() to stay in the int32 range, nan is clamped too
+  auto to_pixel = [](__m128 v, float resolution) -> __m128 {
+    const __m128 bound = _mm_set1_ps(1.0e9f);
+    v = _mm_div_ps(v, _mm_set1_ps(resolution));
+    v = _mm_min_ps(_mm_max_ps(v, _mm_sub_ps(_mm_setzero_ps(), bound)), bound);
+    return floorPs(v);
+  };
+  const __m128 pixel_x = to_pixel(x, quantizer.resolution_x);
+  const __m128 pixel_y = to_pixel(y, quantizer.resolution_y);
+
+  // Range check in float before the int conversion
+  const __m128 half_x = _mm_set1_ps(float(quantizer.half_shape_x));
+  const __m128 half_y = _mm_set1_ps(float(quantizer.half_shape_y));
+  const __m128 neg_half_x = _mm_sub_ps(_mm_setzero_ps(), half_x);
+  const __m128 neg_half_y = _mm_sub_ps(_mm_setzero_ps(), half_y);
+  __m128 in_range = _mm_and_ps(valid_in, _mm_cmpge_ps(z, _mm_setzero_ps()));
+  in_range = _mm_and_ps(in_range, _mm_cmpge_ps(pixel_x, neg_half_x));
+  in_range = _mm_and_ps(in_range, _mm_cmplt_ps(pixel_x, half_x));
+  in_range = _mm_and_ps(in_range, _mm_cmpge_ps(pixel_y, neg_half_y));
+  in_range = _mm_and_ps(in_range, _mm_cmplt_ps(pixel_y, half_y));
+
+  // The pixels in [0, full_shape)
+  const __m128 height = _mm_min_ps(_mm_mul_ps(z, _mm_set1_ps(1000.0f)),
+                                   _mm_set1_ps(float(UINT16_MAX)));
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(pixel_x_out),
+      _mm_cvttps_epi32(_mm_and_ps(in_range, _mm_add_ps(pixel_x, half_x))));
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(pixel_y_out),
+      _mm_cvttps_epi32(_mm_and_ps(in_range, _mm_add_ps(pixel_y, half_y))));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(height_in_mm),
+                   _mm_cvttps_epi32(_mm_and_ps(in_range, height)));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(valid),
+                   _mm_castps_si128(in_range));
+}
+
+/// Transform and quantize 4 points in xyz (12 floats)
+inline void quantize4Points(const HeightMapPointQuantizer& quantizer,
+                            const float* xyz, int pixel_x_out[4],
+                            int pixel_y_out[4], int height_in_mm[4],
+                            int valid[4]) {
+  // Deinterleave [x0 y0 z0 x1] [y1 z1 x2 y2] [z2 x3 y3 z3]
+  const __m128 a = _mm_loadu_ps(xyz);
+  const __m128 b = _mm_loadu_ps(xyz + 4);
+  const __m128 c = _mm_loadu_ps(xyz + 8);
+  __m128 x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)),
+                            _MM_SHUFFLE(2, 0, 3, 0));
+  __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                            _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+                            _MM_SHUFFLE(2, 0, 2, 0));
+  __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                            _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+                            _MM_SHUFFLE(2, 0, 2, 0));
+
+  // Same operation order as quantizePoint()
+  if (quantizer.has_transform) {
+    const float* r = quantizer.rotation;
+    const float* t = quantizer.translation;
+    __m128 tf[3];
+    for (int i = 0; i < 3; i++) {
+      tf[i] = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(r[3 * i + 0]), x),
+                         _mm_mul_ps(_mm_set1_ps(r[3 * i + 1]), y));
+      tf[i] = _mm_add_ps(tf[i], _mm_mul_ps(_mm_set1_ps(r[3 * i + 2]), z));
+      tf[i] = _mm_add_ps(tf[i], _mm_set1_ps(t[i]));
+    }
+    x = tf[0];
+    y = tf[1];
+    z = tf[2];
+  }
+
+  quantize4PointsInHeightMapFrame(
+      quantizer, x, y, z, _mm_castsi128_ps(_mm_set1_epi32(-1)), pixel_x_out,
+      pixel_y_out, height_in_mm, valid);
+}
+#endif
+
+/// The max-reduce of quantized points into heights
+struct HeightsMaxUpdater {
+  HeightMapTiles& heights;
+  uint16_t max_height_in_mm{0};
+
+  explicit HeightsMaxUpdater(HeightMapTiles& heights_in)
+      : heights(heights_in) {}
+
+  inline void update(int pixel_x, int pixel_y, uint16_t height_in_mm) {
+    const uint16_t new_height_in_mm = heights.updateMax(
+        static_cast<std::size_t>(pixel_x), static_cast<std::size_t>(pixel_y),
+        height_in_mm);
+    if (max_height_in_mm < new_height_in_mm)
+      max_height_in_mm = new_height_in_mm;
+  }
+
+  inline void update4(const int pixel_x[4], const int pixel_y[4],
+                      const int height_in_mm[4], const int valid[4]) {
+    for (int lane = 0; lane < 4; lane++) {
+      if (valid[lane] == 0) continue;
+      update(pixel_x[lane], pixel_y[lane],
+             static_cast<uint16_t>(height_in_mm[lane]));
+    }
+  }
+};
+
+/// Max-reduce the points [point_begin, point_end) of the contiguous xyz
+/// buffer into heights. Return the max height that is written.
+inline uint16_t ingestXYZBuffer(const HeightMapPointQuantizer& quantizer,
+                                const float* xyz, std::size_t point_begin,
+                                std::size_t point_end,
+                                HeightMapTiles& heights) {
+  HeightsMaxUpdater updater(heights);
+  std::size_t i = point_begin;
+#ifdef FCL_SSE_ENABLED
+  int pixel_x[4], pixel_y[4], height_in_mm[4], valid[4];
+  for (; i + 4 <= point_end; i += 4) {
+    quantize4Points(quantizer, xyz + 3 * i, pixel_x, pixel_y, height_in_mm,
+                    valid);
+    updater.update4(pixel_x, pixel_y, height_in_mm, valid);
+  }
+#endif
+
+  // The remaining (or all of them without sse)
+  int point_pixel_x, point_pixel_y;
+  uint16_t point_height_in_mm;
+  for (; i < point_end; i++) {
+    const float* point = xyz + 3 * i;
+    if (quantizePoint(quantizer, point[0], point[1], point[2], point_pixel_x,
+                      point_pixel_y, point_height_in_mm)) {
+      updater.update(point_pixel_x, point_pixel_y, point_height_in_mm);
+    }
+  }
+  return updater.max_height_in_mm;
+}
+
+/// Unproject the pixels of a depth image with a pinhole camera, whose
+/// pose in the heightmap frame is given by rotation/translation.
+struct HeightMapDepthImageUnprojector {
+  // (u - cx) / fx for each column u
+  std::vector<float> ray_x_of_column;
+  float fy;
+  float cy;
+  int width;
+
+  // The depth of the image in meter is depth_scale * depth
+  float depth_scale;
+
+  // Row-major rotation and the translation of camera_to_heightmap_frame
+  float rotation[9];
+  float translation[3];
+};
+
+/// Load 4 depth as float
+#ifdef FCL_SSE_ENABLED
+inline __m128 load4Depth(const float* depth) { return _mm_loadu_ps(depth); }
+inline __m128 load4Depth(const uint16_t* depth) {
+  const __m128i depth_epu16 =
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(depth));
+  return _mm_cvtepi32_ps(
+      _mm_unpacklo_epi16(depth_epu16, _mm_setzero_si128()));
+}
+#endif
+
+/// Max-reduce the pixels [pixel_begin, pixel_end) of the depth image
+/// (in the row-major flat index) into heights. The depth image can be
+/// either float or uint16_t, and pixels with non-positive or nan depth are
+/// skipped. Return the max height that is written.
+template <typename DepthT>
+uint16_t ingestDepthImage(const HeightMapPointQuantizer& quantizer,
+                          const HeightMapDepthImageUnprojector& unprojector,
+                          const DepthT* depth_image, std::size_t pixel_begin,
+                          std::size_t pixel_end, HeightMapTiles& heights) {
+  assert(!quantizer.has_transform);
+  HeightsMaxUpdater updater(heights);
+  const std::size_t width = static_cast<std::size_t>(unprojector.width);
+  const float* r = unprojector.rotation;
+  const float* t = unprojector.translation;
+  int pixel_x_1, pixel_y_1;
+  uint16_t height_in_mm;
+  for (std::size_t row = pixel_begin / width; row * width < pixel_end; row++) {
+    const std::size_t col_begin =
+        std::max(pixel_begin, row * width) - row * width;
+    const std::size_t col_end = std::min(pixel_end, (row + 1) * width) -
+                                row * width;
+    const DepthT* row_depth = depth_image + row * width;
+
+    // The point in heightmap frame is depth * (ray_x * r_col0 + row_offset) +
+    // translation, where row_offset = ray_y * r_col1 + r_col2
+    const float ray_y = (float(row) - unprojector.cy) / unprojector.fy;
+    const float row_offset[3] = {ray_y * r[1] + r[2], ray_y * r[4] + r[5],
+                                 ray_y * r[7] + r[8]};
+    std::size_t col = col_begin;
+#ifdef FCL_SSE_ENABLED
+    int pixel_x[4], pixel_y[4], height_in_mm_4[4], valid[4];
+    const __m128 depth_scale = _mm_set1_ps(unprojector.depth_scale);
+    for (; col + 4 <= col_end; col += 4) {
+      const __m128 depth =
+          _mm_mul_ps(load4Depth(row_depth + col), depth_scale);
+      const __m128 ray_x =
+          _mm_loadu_ps(unprojector.ray_x_of_column.data() + col);
+      __m128 xyz[3];
+      for (int i = 0; i < 3; i++) {
+        const __m128 direction =
+            _mm_add_ps(_mm_mul_ps(ray_x, _mm_set1_ps(r[3 * i])),
+                       _mm_set1_ps(row_offset[i]));
+        xyz[i] = _mm_add_ps(_mm_mul_ps(depth, direction), _mm_set1_ps(t[i]));
+      }
+      quantize4PointsInHeightMapFrame(
+          quantizer, xyz[0], xyz[1], xyz[2],
+          _mm_cmpgt_ps(depth, _mm_setzero_ps()), pixel_x, pixel_y,
+          height_in_mm_4, valid);
+      updater.update4(pixel_x, pixel_y, height_in_mm_4, valid);
+    }
+#endif
+
+    // The remaining (or all of them without sse)
+    for (; col < col_end; col++) {
+      const float depth = float(row_depth[col]) * unprojector.depth_scale;
+      if (!(depth > 0.0f)) continue;
+      const float ray_x = unprojector.ray_x_of_column[col];
+      float xyz[3];
+      for (int i = 0; i < 3; i++) {
+        xyz[i] = depth * (ray_x * r[3 * i] + row_offset[i]) + t[i];
+      }
+      if (quantizePoint(quantizer, xyz[0], xyz[1], xyz[2], pixel_x_1,
+                        pixel_y_1, height_in_mm)) {
+        updater.update(pixel_x_1, pixel_y_1, height_in_mm);
+      }
+    }
+  }
+  return updater.max_height_in_mm;
+}
+
+/// dst[i] = max(dst[i], src[i])
+inline void maxMergeHeights(uint16_t* dst, const uint16_t* src,
+                            std::size_t n) {
+  std::size_t i = 0;
+#ifdef FCL_SSE_ENABLED
+  for (; i + 8 <= n; i += 8) {
+    __m128i* dst_i = reinterpret_cast<__m128i*>(dst + i);
+    _mm_storeu_si128(
+        dst_i, maxEpu16(_mm_loadu_si128(dst_i),
+                        _mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(src + i))));
+  }
+#endif
+  for (; i < n; i++) {
+    if (dst[i] < src[i]) dst[i] = src[i];
+  }
+}
+
+}  // namespace internal
+}  // namespace heightmap
+}  // namespace fcl
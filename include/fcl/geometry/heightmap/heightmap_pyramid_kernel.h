@@ -0,0 +1,200 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "fcl/geometry/heightmap/heightmap_tiles.h"
+#include "fcl/math/math_simd_details.h"
+
+namespace fcl {
+namespace heightmap {
+namespace internal {
+
+#ifdef FCL_SSE_ENABLED
+/// Lane-wise max of unsigned 16-bit integers. _mm_max_epu16 is SSE4.1,
+/// for SSE2 we use the saturated subtraction: max(a, b) = (a -| b) + b
+inline __m128i maxEpu16(__m128i a, __m128i b) {
+#ifdef __SSE4__
+  return _mm_max_epu16(a, b);
+#else
+  return _mm_adds_epu16(_mm_subs_epu16(a, b), b);
+#endif
+}
+
+/// Lane-wise min of unsigned 16-bit integers, min(a, b) = a - (a -| b)
+inline __m128i minEpu16(__m128i a, __m128i b) {
+#ifdef __SSE4__
+  return _mm_min_epu16(a, b);
+#else
+  return _mm_sub_epi16(a, _mm_subs_epu16(a, b));
+#endif
+}
+
+/// Given 16 heights (in two registers) of a row, compute the 8 max of
+/// the adjacent pairs (2i, 2i + 1).
+inline __m128i maxOfAdjacentPairsEpu16(__m128i lo, __m128i hi) {
+  // Each 32-bit lane is a pair, the max is kept in the low 16-bit
+  const __m128i low_mask = _mm_set1_epi32(0xFFFF);
+  lo = _mm_and_si128(maxEpu16(lo, _mm_srli_epi32(lo, 16)), low_mask);
+  hi = _mm_and_si128(maxEpu16(hi, _mm_srli_epi32(hi, 16)), low_mask);
+
+  // _mm_packus_epi32 is SSE4.1, shift the range to use the signed pack
+  const __m128i bias_32 = _mm_set1_epi32(0x8000);
+  const __m128i bias_16 = _mm_set1_epi16(static_cast<short>(0x8000));
+  const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(lo, bias_32),
+                                         _mm_sub_epi32(hi, bias_32));
+  return _mm_xor_si128(packed, bias_16);
+}
+
+/// The min counterpart of maxOfAdjacentPairsEpu16
+inline __m128i minOfAdjacentPairsEpu16(__m128i lo, __m128i hi) {
+  const __m128i low_mask = _mm_set1_epi32(0xFFFF);
+  lo = _mm_and_si128(minEpu16(lo, _mm_srli_epi32(lo, 16)), low_mask);
+  hi = _mm_and_si128(minEpu16(hi, _mm_srli_epi32(hi, 16)), low_mask);
+  const __m128i bias_32 = _mm_set1_epi32(0x8000);
+  const __m128i bias_16 = _mm_set1_epi16(static_cast<short>(0x8000));
+  const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(lo, bias_32),
+                                         _mm_sub_epi32(hi, bias_32));
+  return _mm_xor_si128(packed, bias_16);
+}
+#endif
+
+/// Compute one row of the up layer from two rows of the down layer, where
+/// each pixel of the up layer is the max of a 2x2 grid in the down layer.
+/// row_0 and row_1 must contain 2 * n_up_pixels heights.
+inline void maxPool2x2Row(const uint16_t* row_0, const uint16_t* row_1,
+                          uint16_t* up_row, std::size_t n_up_pixels) {
+  std::size_t i = 0;
+#ifdef FCL_SSE_ENABLED
+  for (; i + 8 <= n_up_pixels; i += 8) {
+    const uint16_t* row_0_i = row_0 + 2 * i;
+    const uint16_t* row_1_i = row_1 + 2 * i;
+    const __m128i lo = maxEpu16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row_0_i)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row_1_i)));
+    const __m128i hi = maxEpu16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row_0_i + 8)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row_1_i + 8)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(up_row + i),
+                     maxOfAdjacentPairsEpu16(lo, hi));
+  }
+#endif
+
+  // The remaining (or all of them without sse)
+  for (; i < n_up_pixels; i++) {
+    const uint16_t max_0 = row_0[2 * i] > row_0[2 * i + 1] ? row_0[2 * i]
+                                                           : row_0[2 * i + 1];
+    const uint16_t max_1 = row_1[2 * i] > row_1[2 * i + 1] ? row_1[2 * i]
+                                                           : row_1[2 * i + 1];
+    up_row[i] = max_0 > max_1 ? max_0 : max_1;
+  }
+}
+
+/// Compute one row of the up layer from two rows of the down layer, where
+/// each pixel of the up layer is the min of a 2x2 grid in the down layer.
+inline void minPool2x2Row(const uint16_t* row_0, const uint16_t* row_1,
+                          uint16_t* up_row, std::size_t n_up_pixels) {
+  std::size_t i = 0;
+#ifdef FCL_SSE_ENABLED
+  for (; i + 8 <= n_up_pixels; i += 8) {
+    const uint16_t* row_0_i = row_0 + 2 * i;
+    const uint16_t* row_1_i = row_1 + 2 * i;
+    const __m128i lo = minEpu16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row_0_i)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row_1_i)));
+    const __m128i hi = minEpu16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row_0_i + 8)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row_1_i + 8)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(up_row + i),
+                     minOfAdjacentPairsEpu16(lo, hi));
+  }
+#endif
+
+  for (; i < n_up_pixels; i++) {
+    const uint16_t min_0 = row_0[2 * i] < row_0[2 * i + 1] ? row_0[2 * i]
+                                                           : row_0[2 * i + 1];
+    const uint16_t min_1 = row_1[2 * i] < row_1[2 * i + 1] ? row_1[2 * i]
+                                                           : row_1[2 * i + 1];
+    up_row[i] = min_0 < min_1 ? min_0 : min_1;
+  }
+}
+
+/// Max-pool a rectangle [x_begin, x_end) x [y_begin, y_end) in the pixel
+/// space of the up layer. The strides are the full_shape_x of the layers.
+inline void maxPool2x2Rect(const uint16_t* down, std::size_t down_stride,
+                           uint16_t* up, std::size_t up_stride,
+                           std::size_t x_begin, std::size_t x_end,
+                           std::size_t y_begin, std::size_t y_end) {
+  for (std::size_t y = y_begin; y < y_end; y++) {
+    const uint16_t* row_0 = down + (2 * y) * down_stride + 2 * x_begin;
+    maxPool2x2Row(row_0, row_0 + down_stride, up + y * up_stride + x_begin,
+                  x_end - x_begin);
+  }
+}
+
+/// The min counterpart of maxPool2x2Rect
+inline void minPool2x2Rect(const uint16_t* down, std::size_t down_stride,
+                           uint16_t* up, std::size_t up_stride,
+                           std::size_t x_begin, std::size_t x_end,
+                           std::size_t y_begin, std::size_t y_end) {
+  for (std::size_t y = y_begin; y < y_end; y++) {
+    const uint16_t* row_0 = down + (2 * y) * down_stride + 2 * x_begin;
+    minPool2x2Row(row_0, row_0 + down_stride, up + y * up_stride + x_begin,
+                  x_end - x_begin);
+  }
+}
+
+/// Pool a rectangle [x_begin, x_end) x [y_begin, y_end) in the pixel space
+/// of the up layer, where both layers are stored in tiles. The rectangle
+/// is split by the down tiles, and an absent down tile is all-zero.
+inline void pool2x2TilesRect(const HeightMapTiles& down, HeightMapTiles& up,
+                             bool pool_min, std::size_t x_begin,
+                             std::size_t x_end, std::size_t y_begin,
+                             std::size_t y_end) {
+  // A down tile covers a quarter of an up tile
+  constexpr std::size_t kTileShape = HeightMapTiles::kTileShape;
+  constexpr std::size_t kHalfTileShape = kTileShape / 2;
+  for (std::size_t y_0 = y_begin; y_0 < y_end;) {
+    const std::size_t y_1 =
+        std::min(y_end, (y_0 / kHalfTileShape + 1) * kHalfTileShape);
+    for (std::size_t x_0 = x_begin; x_0 < x_end;) {
+      const std::size_t x_1 =
+          std::min(x_end, (x_0 / kHalfTileShape + 1) * kHalfTileShape);
+      const uint16_t* down_tile =
+          down.tile(down.pixelToTileIndex(2 * x_0, 2 * y_0));
+      const std::size_t up_tile_idx = up.pixelToTileIndex(x_0, y_0);
+      const std::size_t up_offset =
+          HeightMapTiles::pixelToOffsetInTile(x_0, y_0);
+      if (down_tile != nullptr) {
+        uint16_t* up_tile = up.mutableTile(up_tile_idx) + up_offset;
+        const uint16_t* down_rect =
+            down_tile + HeightMapTiles::pixelToOffsetInTile(2 * x_0, 2 * y_0);
+        if (pool_min) {
+          minPool2x2Rect(down_rect, kTileShape, up_tile, kTileShape, 0,
+                         x_1 - x_0, 0, y_1 - y_0);
+        } else {
+          maxPool2x2Rect(down_rect, kTileShape, up_tile, kTileShape, 0,
+                         x_1 - x_0, 0, y_1 - y_0);
+        }
+      } else if (up.tile(up_tile_idx) != nullptr) {
+        // The up pixels of an absent down tile are zero
+        uint16_t* up_tile = up.mutableTile(up_tile_idx) + up_offset;
+        for (std::size_t y = 0; y < y_1 - y_0; y++) {
+          std::fill(up_tile + y * kTileShape, up_tile + y * kTileShape +
+                                                  (x_1 - x_0), uint16_t(0));
+        }
+      }
+      x_0 = x_1;
+    }
+    y_0 = y_1;
+  }
+}
+
+}  // namespace internal
+}  // namespace heightmap
+}  // namespace fcl
@@ -0,0 +1,150 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace fcl {
+namespace heightmap {
+
+/// HeightMapTiles stores an 1-channel uint16_t image as square tiles of
+/// kTileShape x kTileShape pixels. A tile is allocated on its first write
+/// and an absent tile is all-zero. Thus, a large map that is mostly empty
+/// only costs the memory of its occupied tiles.
+/// In a tile, the pixels are stored x-continuous as the full image. The
+/// tiles on the boundary might be partially out of the image, and these
+/// padding pixels are always zero.
+///
+/// The tiles are reference-counted and copy-on-write: a copy of the
+/// HeightMapTiles shares every tile, and a write clones the tile if it is
+/// shared. Thus, a copy is a cheap snapshot that is not affected by the
+/// later writes to the original, and can be read from other threads. The
+/// copy itself must not run concurrently with the writes.
+/// Each tile also has a dirty flag, which is set by every write to the tile
+/// and cleared by the owner (such as the pyramid rebuild).
+class HeightMapTiles {
+ public:
+  static constexpr std::size_t kTileShapeLog2 = 6;
+  static constexpr std::size_t kTileShape = std::size_t(1) << kTileShapeLog2;
+  static constexpr std::size_t kTileSize = kTileShape * kTileShape;
+  using Tile = std::array<uint16_t, kTileSize>;
+
+  HeightMapTiles() = default;
+  HeightMapTiles(std::size_t full_shape_x, std::size_t full_shape_y)
+      : n_tiles_x_((full_shape_x + kTileShape - 1) / kTileShape),
+        n_tiles_y_((full_shape_y + kTileShape - 1) / kTileShape),
+        tiles_(n_tiles_x_ * n_tiles_y_),
+        dirty_(n_tiles_x_ * n_tiles_y_, 0) {}
+  // Default copy/move/assign, the copy shares the tiles
+
+  /// The index of tile and the offset of a pixel in the tile
+  std::size_t n_tiles_x() const { return n_tiles_x_; }
+  std::size_t n_tiles_y() const { return n_tiles_y_; }
+  std::size_t n_tiles() const { return tiles_.size(); }
+  std::size_t tileIndex(std::size_t tile_x, std::size_t tile_y) const {
+    return tile_y * n_tiles_x_ + tile_x;
+  }
+  std::size_t pixelToTileIndex(std::size_t x, std::size_t y) const {
+    return tileIndex(x >> kTileShapeLog2, y >> kTileShapeLog2);
+  }
+  static std::size_t pixelToOffsetInTile(std::size_t x, std::size_t y) {
+    return ((y & (kTileShape - 1)) << kTileShapeLog2) | (x & (kTileShape - 1));
+  }
+
+  /// The access of tiles. tile() returns nullptr for an absent (all-zero)
+  /// tile, while mutableTile() allocates it, or clones it if shared.
+  /// The writes to different tiles can be performed in parallel.
+  const uint16_t* tile(std::size_t tile_idx) const {
+    assert(tile_idx < tiles_.size());
+    return tiles_[tile_idx] ? tiles_[tile_idx]->data() : nullptr;
+  }
+  uint16_t* mutableTile(std::size_t tile_idx) {
+    assert(tile_idx < tiles_.size());
+    std::shared_ptr<Tile>& this_tile = tiles_[tile_idx];
+    if (!this_tile) {
+      this_tile = std::make_shared<Tile>();
+    } else if (this_tile.use_count() > 1) {
+      this_tile = std::make_shared<Tile>(*this_tile);
+    } else {
+      // Synchronize with the release of the snapshot that shared it
+      std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    // Only write the flag once, as the tile might be written by threads
+    // that are prepared to touch different pixels of the same tile
+    if (!dirty_[tile_idx]) dirty_[tile_idx] = 1;
+    return this_tile->data();
+  }
+  void releaseTile(std::size_t tile_idx) {
+    assert(tile_idx < tiles_.size());
+    if (!tiles_[tile_idx]) return;
+    tiles_[tile_idx].reset();
+    dirty_[tile_idx] = 1;
+  }
+  void clear() {
+    for (std::size_t i = 0; i < tiles_.size(); i++) releaseTile(i);
+  }
+
+  /// The access of pixels, which must be in range
+  uint16_t get(std::size_t x, std::size_t y) const {
+    const uint16_t* pixel_tile = tile(pixelToTileIndex(x, y));
+    return pixel_tile == nullptr ? 0 : pixel_tile[pixelToOffsetInTile(x, y)];
+  }
+  void set(std::size_t x, std::size_t y, uint16_t height) {
+    const std::size_t tile_idx = pixelToTileIndex(x, y);
+    if (height == 0 && tile(tile_idx) == nullptr) return;
+    mutableTile(tile_idx)[pixelToOffsetInTile(x, y)] = height;
+  }
+  /// Update the pixel to max(current, height) and return the new height
+  uint16_t updateMax(std::size_t x, std::size_t y, uint16_t height) {
+    if (height == 0) return get(x, y);
+    uint16_t& current =
+        mutableTile(pixelToTileIndex(x, y))[pixelToOffsetInTile(x, y)];
+    if (current < height) current = height;
+    return current;
+  }
+
+  /// Dirty flags
+  bool isTileDirty(std::size_t tile_idx) const {
+    return dirty_[tile_idx] != 0;
+  }
+  void markAllTilesDirty() { std::fill(dirty_.begin(), dirty_.end(), 1); }
+  void clearDirtyFlags() { std::fill(dirty_.begin(), dirty_.end(), 0); }
+
+  /// Memory statistics
+  std::size_t n_allocated_tiles() const {
+    std::size_t n_allocated = 0;
+    for (const auto& tile_i : tiles_) {
+      if (tile_i) n_allocated++;
+    }
+    return n_allocated;
+  }
+  /// The number of tiles that are shared with other
+  std::size_t n_tiles_shared_with(const HeightMapTiles& other) const {
+    std::size_t n_shared = 0;
+    for (std::size_t i = 0; i < std::min(n_tiles(), other.n_tiles()); i++) {
+      if (tiles_[i] && tiles_[i] == other.tiles_[i]) n_shared++;
+    }
+    return n_shared;
+  }
+  std::size_t allocated_bytes() const {
+    return n_allocated_tiles() * kTileSize * sizeof(uint16_t);
+  }
+
+ private:
+  std::size_t n_tiles_x_{0};
+  std::size_t n_tiles_y_{0};
+  std::vector<std::shared_ptr<Tile>> tiles_;
+  std::vector<uint8_t> dirty_;
+};
+
+}  // namespace heightmap
+}  // namespace fcl
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <thread>
+
+#include "fcl/geometry/heightmap/heightmap_pyramid_kernel.h"
+
 namespace fcl {
 namespace heightmap {
 
@@ -80,38 +85,266 @@ S LayeredHeightMap<S>::half_range_y() const {
 }
 
 template <typename S>
-void LayeredHeightMap<S>::rebuildNextLayer(const FlatHeightMap<S>& down_layer,
-                                           FlatHeightMap<S>& up_layer) {
+void LayeredHeightMap<S>::setMinHeightChannelEnabled(bool enabled) {
+  if (enabled == min_height_channel_enabled()) return;
+  if (!enabled) {
+    min_heights_in_mm_.clear();
+    return;
+  }
+
+  // Allocate and build from the current bottom
+  min_heights_in_mm_.resize(layers_.size() - 1);
+  for (std::size_t i = 0; i + 1 < layers_.size(); i++) {
+    min_heights_in_mm_[i] =
+        HeightMapTiles(layers_[i].full_shape_x(), layers_[i].full_shape_y());
+  }
+  bottom_mutable().heightmap_in_mm.markAllTilesDirty();
+  updateEveryLayersFromBottom();
+}
+
+template <typename S>
+uint16_t LayeredHeightMap<S>::pixelMinHeight(std::size_t layer_idx,
+                                             const Pixel& pixel) const {
+  const FlatHeightMap<S>& layer = layers_[layer_idx];
+  if (is_bottom_layer(layer_idx)) return layer.pixelHeight(pixel);
+  if (!min_height_channel_enabled() || !layer.isPixelInRange(pixel)) return 0;
+  return min_heights_in_mm_[layer_idx].get(pixel.x, pixel.y);
+}
+
+template <typename S>
+std::size_t LayeredHeightMap<S>::allocated_bytes() const {
+  std::size_t bytes = 0;
+  for (const auto& layer : layers_) bytes += layer.allocated_bytes();
+  for (const auto& min_heights : min_heights_in_mm_) {
+    bytes += min_heights.allocated_bytes();
+  }
+  return bytes;
+}
+
+template <typename S>
+std::size_t LayeredHeightMap<S>::n_tiles_shared_with(
+    const LayeredHeightMap<S>& other) const {
+  std::size_t n_shared = 0;
+  for (std::size_t i = 0; i < std::min(n_layers(), other.n_layers()); i++) {
+    n_shared += layers_[i].heightmap_in_mm.n_tiles_shared_with(
+        other.layers_[i].heightmap_in_mm);
+  }
+  for (std::size_t i = 0; i < std::min(min_heights_in_mm_.size(),
+                                       other.min_heights_in_mm_.size());
+       i++) {
+    n_shared += min_heights_in_mm_[i].n_tiles_shared_with(
+        other.min_heights_in_mm_[i]);
+  }
+  return n_shared;
+}
+
+template <typename S>
+void LayeredHeightMap<S>::clearDirtyFlags() {
+  for (auto& layer : layers_) layer.heightmap_in_mm.clearDirtyFlags();
+  for (auto& min_heights : min_heights_in_mm_) min_heights.clearDirtyFlags();
+}
+
+template <typename S>
+const HeightMapTiles& LayeredHeightMap<S>::layerMinHeights(
+    std::size_t layer_idx) const {
+  if (is_bottom_layer(layer_idx)) return layers_[layer_idx].heightmap_in_mm;
+  return min_heights_in_mm_[layer_idx];
+}
+
+template <typename S>
+void LayeredHeightMap<S>::prepareUpLayerTiles(std::size_t down_layer_idx) {
+  const std::size_t up_layer_idx = down_layer_idx - 1;
+  const HeightMapTiles& down = layers_[down_layer_idx].heightmap_in_mm;
+  HeightMapTiles& up = layers_[up_layer_idx].heightmap_in_mm;
+  for (std::size_t up_y = 0; up_y < up.n_tiles_y(); up_y++) {
+    for (std::size_t up_x = 0; up_x < up.n_tiles_x(); up_x++) {
+      // The 2x2 down tiles covered by this up tile
+      bool has_down_tile = false;
+      bool has_dirty_down_tile = false;
+      for (std::size_t down_y = 2 * up_y;
+           down_y < std::min(2 * up_y + 2, down.n_tiles_y()); down_y++) {
+        for (std::size_t down_x = 2 * up_x;
+             down_x < std::min(2 * up_x + 2, down.n_tiles_x()); down_x++) {
+          const std::size_t down_tile_idx = down.tileIndex(down_x, down_y);
+          has_down_tile |= down.tile(down_tile_idx) != nullptr;
+          has_dirty_down_tile |= down.isTileDirty(down_tile_idx);
+        }
+      }
+      if (!has_dirty_down_tile) continue;
+
+      const std::size_t up_tile_idx = up.tileIndex(up_x, up_y);
+      if (has_down_tile) {
+        up.mutableTile(up_tile_idx);
+        if (min_height_channel_enabled()) {
+          min_heights_in_mm_[up_layer_idx].mutableTile(up_tile_idx);
+        }
+      } else {
+        up.releaseTile(up_tile_idx);
+        if (min_height_channel_enabled()) {
+          min_heights_in_mm_[up_layer_idx].releaseTile(up_tile_idx);
+        }
+      }
+    }
+  }
+}
+
+template <typename S>
+void LayeredHeightMap<S>::poolLayerRect(std::size_t down_layer_idx,
+                                        std::size_t x_begin, std::size_t x_end,
+                                        std::size_t y_begin,
+                                        std::size_t y_end) {
+  // A pixel in up layer corresponds an 2x2 grid in down layer
+  const std::size_t up_layer_idx = down_layer_idx - 1;
+  internal::pool2x2TilesRect(layers_[down_layer_idx].heightmap_in_mm,
+                             layers_[up_layer_idx].heightmap_in_mm, false,
+                             x_begin, x_end, y_begin, y_end);
+  if (min_height_channel_enabled()) {
+    internal::pool2x2TilesRect(layerMinHeights(down_layer_idx),
+                               min_heights_in_mm_[up_layer_idx], true, x_begin,
+                               x_end, y_begin, y_end);
+  }
+}
+
+template <typename S>
+void LayeredHeightMap<S>::rebuildNextLayer(std::size_t down_layer_idx) {
+  const FlatHeightMap<S>& down_layer = layers_[down_layer_idx];
+  FlatHeightMap<S>& up_layer = layers_[down_layer_idx - 1];
   assert(up_layer.half_shape_x() * 2 == down_layer.half_shape_x());
   assert(up_layer.half_shape_y() * 2 == down_layer.half_shape_y());
-  up_layer.resetHeights();
-  auto update_up_layer_height = [&up_layer](const Pixel& pixel_down,
-                                            const Point2D<S>& box_bottom_center,
-                                            uint16_t height_in_mm) -> bool {
-    (void)(box_bottom_center);
-    // A pixel in up layer corresponds an 2x2 grid in down layer
-    Pixel pixel_up;
-    pixel_up.x = pixel_down.x / 2;
-    pixel_up.y = pixel_down.y / 2;
-    auto flat_index_in_up = up_layer.pixelToFlatIndex(pixel_up);
-    if (height_in_mm > up_layer.heightmap_in_mm[flat_index_in_up]) {
-      up_layer.heightmap_in_mm[flat_index_in_up] = height_in_mm;
-    }
 
-    // Visit the entire down map
-    return false;
-  };
-  down_layer.visitHeightMap(update_up_layer_height);
+  // Only the dirty up tiles (after prepareUpLayerTiles)
+  const HeightMapTiles& up_tiles = up_layer.heightmap_in_mm;
+  constexpr std::size_t kTileShape = HeightMapTiles::kTileShape;
+  for (std::size_t tile_y = 0; tile_y < up_tiles.n_tiles_y(); tile_y++) {
+    for (std::size_t tile_x = 0; tile_x < up_tiles.n_tiles_x(); tile_x++) {
+      if (!up_tiles.isTileDirty(up_tiles.tileIndex(tile_x, tile_y))) continue;
+      poolLayerRect(
+          down_layer_idx, tile_x * kTileShape,
+          std::min<std::size_t>((tile_x + 1) * kTileShape,
+                                up_layer.full_shape_x()),
+          tile_y * kTileShape,
+          std::min<std::size_t>((tile_y + 1) * kTileShape,
+                                up_layer.full_shape_y()));
+    }
+  }
   up_layer.height_upper_bound_in_mm = down_layer.height_upper_bound_in_mm;
 }
 
+template <typename S>
+void LayeredHeightMap<S>::rebuildLayersInBottomTile(std::size_t n_fused_layers,
+                                                    std::size_t tile_shape,
+                                                    std::size_t tile_x,
+                                                    std::size_t tile_y) {
+  // The tile in the current layer, which is halved for each upper layer
+  std::size_t x = tile_x * tile_shape;
+  std::size_t y = tile_y * tile_shape;
+  std::size_t shape = tile_shape;
+  for (std::size_t i = 0; i < n_fused_layers; i++) {
+    const std::size_t down_i = layers_.size() - 1 - i;
+    x /= 2;
+    y /= 2;
+    shape /= 2;
+    poolLayerRect(down_i, x, x + shape, y, y + shape);
+  }
+}
+
 template <typename S>
 void LayeredHeightMap<S>::updateEveryLayersFromBottom() {
   assert(layers_.size() >= 1);
+  const FlatHeightMap<S>& bottom_layer = bottom();
+  std::size_t tile_shape = kPyramidTileShape;
+  tile_shape = std::min<std::size_t>(tile_shape, bottom_layer.full_shape_x());
+  tile_shape = std::min<std::size_t>(tile_shape, bottom_layer.full_shape_y());
+
+  // The layers in a tile until it shrinks to one pixel are fused
+  std::size_t n_fused_layers = 0;
+  for (std::size_t shape = tile_shape; shape > 1; shape /= 2) n_fused_layers++;
+  n_fused_layers = std::min(n_fused_layers, layers_.size() - 1);
+
+  // No allocation (of the storage tiles) is performed in the threads
+  for (std::size_t down_i = layers_.size() - 1; down_i > 0; down_i--) {
+    prepareUpLayerTiles(down_i);
+  }
+
+  // Process the tiles with a shared counter
+  const std::size_t n_tiles_x = bottom_layer.full_shape_x() / tile_shape;
+  const std::size_t n_tiles_y = bottom_layer.full_shape_y() / tile_shape;
+  const int n_tiles = static_cast<int>(n_tiles_x * n_tiles_y);
+  std::atomic<int> next_tile{0};
+  const HeightMapTiles& bottom_tiles = bottom_layer.heightmap_in_mm;
+  auto rebuild_tiles = [&]() -> void {
+    while (true) {
+      const int tile = next_tile.fetch_add(1);
+      if (tile >= n_tiles) break;
+      const std::size_t tile_x = tile % n_tiles_x;
+      const std::size_t tile_y = tile / n_tiles_x;
+
+      // The upper pixels of a clean tile are up-to-date
+      if (!bottom_tiles.isTileDirty(bottom_tiles.pixelToTileIndex(
+              tile_x * tile_shape, tile_y * tile_shape))) {
+        continue;
+      }
+      rebuildLayersInBottomTile(n_fused_layers, tile_shape, tile_x, tile_y);
+    }
+  };
+
+  // Run in this thread or dispatch to workers
+  int n_threads = pyramid_rebuild_threads_;
+  if (n_threads <= 0) {
+    n_threads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  n_threads = std::max(1, std::min(n_threads, n_tiles));
+  if (n_threads == 1) {
+    rebuild_tiles();
+  } else {
+    std::vector<std::thread> workers;
+    workers.reserve(n_threads - 1);
+    for (int i = 1; i < n_threads; i++) workers.emplace_back(rebuild_tiles);
+    rebuild_tiles();
+    for (auto& worker : workers) worker.join();
+  }
+
+  // The remaining layers are small enough for plain layer-by-layer rebuild
+  for (std::size_t i = n_fused_layers; i < layers_.size() - 1; i++) {
+    rebuildNextLayer(layers_.size() - 1 - i);
+  }
+
+  clearDirtyFlags();
+  updateHeightUpperBoundByTopLayer();
+}
+
+template <typename S>
+void LayeredHeightMap<S>::updateLayersFromBottomInROI(
+    const PixelSpaceROI& bottom_roi) {
+  assert(layers_.size() >= 1);
+  Pixel top_left, bottom_right;
+  bottom().rectifyHeightMapROI(top_left, bottom_right, &bottom_roi);
   for (std::size_t i = 0; i < layers_.size() - 1; i++) {
-    std::size_t down_i = layers_.size() - 1 - i;
-    std::size_t up_i = down_i - 1;
-    rebuildNextLayer(layers_[down_i], layers_[up_i]);
+    // The roi is inclusive, the pixels in it are covered by its half
+    top_left.x /= 2;
+    top_left.y /= 2;
+    bottom_right.x /= 2;
+    bottom_right.y /= 2;
+    poolLayerRect(layers_.size() - 1 - i, top_left.x,
+                  std::size_t(bottom_right.x) + 1, top_left.y,
+                  std::size_t(bottom_right.y) + 1);
+  }
+  clearDirtyFlags();
+  updateHeightUpperBoundByTopLayer();
+}
+
+template <typename S>
+void LayeredHeightMap<S>::updateHeightUpperBoundByTopLayer() {
+  uint16_t max_height_in_mm = 0;
+  for (uint16_t y = 0; y < top().full_shape_y(); y++) {
+    for (uint16_t x = 0; x < top().full_shape_x(); x++) {
+      max_height_in_mm = std::max(max_height_in_mm, top().pixelHeight({x, y}));
+    }
+  }
+
+  // The upper bound is the same for each layer
+  for (auto& layer : layers_) {
+    layer.height_upper_bound_in_mm = max_height_in_mm;
   }
 }
 
@@ -120,6 +353,8 @@ void LayeredHeightMap<S>::resetHeights() {
   for (auto& layer : layers_) {
     layer.resetHeights();
   }
+  for (auto& min_heights : min_heights_in_mm_) min_heights.clear();
+  clearDirtyFlags();
 }
 
 template <typename S>
@@ -142,9 +377,41 @@ void LayeredHeightMap<S>::updateHeightsByPoint3DIterator(
 
 template <typename S>
 void LayeredHeightMap<S>::updateHeightsByPointGenerationFunctor(
-    const PointGenerationFunc& point_generator, int n_points) {
+    const PointGenerationFunc& point_generator, int n_points, int n_threads) {
   bottom_mutable().updateHeightsByPointGenerationFunctor(point_generator,
-                                                         n_points);
+                                                         n_points, n_threads);
+  updateEveryLayersFromBottom();
+}
+
+template <typename S>
+void LayeredHeightMap<S>::updateHeightsByXYZBuffer(
+    const float* xyz, std::size_t n_points,
+    const Eigen::Isometry3f* points_to_heightmap_frame, int n_threads) {
+  bottom_mutable().updateHeightsByXYZBuffer(xyz, n_points,
+                                            points_to_heightmap_frame,
+                                            n_threads);
+  updateEveryLayersFromBottom();
+}
+
+template <typename S>
+void LayeredHeightMap<S>::updateHeightsByDepthImage(
+    const uint16_t* depth_image, const PinholeCameraIntrinsic<float>& intrinsic,
+    const Eigen::Isometry3f& camera_to_heightmap_frame, float depth_scale,
+    int n_threads) {
+  bottom_mutable().updateHeightsByDepthImage(depth_image, intrinsic,
+                                             camera_to_heightmap_frame,
+                                             depth_scale, n_threads);
+  updateEveryLayersFromBottom();
+}
+
+template <typename S>
+void LayeredHeightMap<S>::updateHeightsByDepthImage(
+    const float* depth_image, const PinholeCameraIntrinsic<float>& intrinsic,
+    const Eigen::Isometry3f& camera_to_heightmap_frame, float depth_scale,
+    int n_threads) {
+  bottom_mutable().updateHeightsByDepthImage(depth_image, intrinsic,
+                                             camera_to_heightmap_frame,
+                                             depth_scale, n_threads);
   updateEveryLayersFromBottom();
 }
 
@@ -152,7 +419,11 @@ template <typename S>
 void LayeredHeightMap<S>::updateHeightsByBottomLayerUpdateFunctor(
     const UpdateBottomLayerHeightsFunctor& visitor, const PixelSpaceROI* roi) {
   bottom_mutable().updateHeightsByFunctor(visitor, roi);
-  updateEveryLayersFromBottom();
+  if (roi != nullptr) {
+    updateLayersFromBottomInROI(*roi);
+  } else {
+    updateEveryLayersFromBottom();
+  }
 }
 
 }  // namespace heightmap
@@ -27,6 +27,15 @@ class LayeredHeightMap {
   std::vector<FlatHeightMap<S>> layers_;
   FlatHeightMap<S>& bottom_mutable() { return layers_.back(); }
 
+  /// The number of threads used to rebuild the upper layers from the
+  /// bottom. Non-positive value implies std::thread::hardware_concurrency.
+  int pyramid_rebuild_threads_{1};
+
+  /// The optional min-height channel of each layer except the bottom, where
+  /// a pixel stores the min height of the bottom pixels it covers. Empty
+  /// if the channel is disabled. The min of the bottom layer is its height.
+  std::vector<HeightMapTiles> min_heights_in_mm_;
+
  public:
   /// The same construction parameter as FlatHeightMap,
   /// However, half_map_shape must be 2^n.
@@ -34,7 +43,16 @@ class LayeredHeightMap {
                    uint16_t bottom_half_map_shape_x,
                    uint16_t bottom_half_map_shape_y);
   LayeredHeightMap(S bottom_resolution, uint16_t bottom_half_map_shape);
-  // Default copy/move/assign
+  // Default copy/move/assign, the copy shares the (copy-on-write) tiles
+
+  /// An immutable snapshot of the current map, e.g., for the collision
+  /// geometry used by planners while this map keeps being updated. The
+  /// snapshot shares every tile, and the later updates of this map only
+  /// clone the tiles they touch. The snapshot must be taken in the thread
+  /// that updates this map, while it can be read from any thread.
+  std::shared_ptr<const LayeredHeightMap<S>> snapshot() const {
+    return std::make_shared<const LayeredHeightMap<S>>(*this);
+  }
 
   // The access of layers
   std::size_t n_layers() const { return layers_.size(); }
@@ -47,6 +65,31 @@ class LayeredHeightMap {
   S height_upper_bound_meter() const;
   S half_range_x() const;
   S half_range_y() const;
+  /// The memory of the allocated tiles of every layer, and the number of
+  /// tiles that are shared with other (such as a snapshot)
+  std::size_t allocated_bytes() const;
+  std::size_t n_tiles_shared_with(const LayeredHeightMap<S>& other) const;
+
+  /// The rebuild of upper layers is split into independent tiles
+  /// of the bottom layer, which can be processed in parallel.
+  void setPyramidRebuildThreads(int n_threads) {
+    pyramid_rebuild_threads_ = n_threads;
+  }
+  int pyramid_rebuild_threads() const { return pyramid_rebuild_threads_; }
+
+  /// Each node (layer, pixel) represents the column [0, max height] of its
+  /// footprint. With the min-height channel, the sub-column [0, min height]
+  /// is known to be fully occupied, which lets the traversal accept a node
+  /// without descending to the bottom. The channel is maintained by every
+  /// update after enabled, with the cost of another pooling per update.
+  void setMinHeightChannelEnabled(bool enabled);
+  bool min_height_channel_enabled() const {
+    return !min_heights_in_mm_.empty();
+  }
+  /// The min height of the bottom pixels covered by this pixel, return
+  /// 0 if the pixel is out-of-range or the channel is disabled (unless
+  /// this is the bottom layer).
+  uint16_t pixelMinHeight(std::size_t layer_idx, const Pixel& pixel) const;
 
   /// Update the height map using the points, iterators and functors
   void resetHeights();
@@ -59,7 +102,21 @@ class LayeredHeightMap {
       const Eigen::Isometry3f* points_to_heightmap_frame = nullptr);
   using PointGenerationFunc = typename FlatHeightMap<S>::PointGenerationFunc;
   void updateHeightsByPointGenerationFunctor(
-      const PointGenerationFunc& point_generator, int n_points);
+      const PointGenerationFunc& point_generator, int n_points,
+      int n_threads = 1);
+  void updateHeightsByXYZBuffer(
+      const float* xyz, std::size_t n_points,
+      const Eigen::Isometry3f* points_to_heightmap_frame = nullptr,
+      int n_threads = 1);
+  void updateHeightsByDepthImage(
+      const uint16_t* depth_image,
+      const PinholeCameraIntrinsic<float>& intrinsic,
+      const Eigen::Isometry3f& camera_to_heightmap_frame,
+      float depth_scale = 0.001f, int n_threads = 1);
+  void updateHeightsByDepthImage(
+      const float* depth_image, const PinholeCameraIntrinsic<float>& intrinsic,
+      const Eigen::Isometry3f& camera_to_heightmap_frame,
+      float depth_scale = 1.0f, int n_threads = 1);
 
   /// Update the heights by visitor that updates the bottom layer
   using UpdateBottomLayerHeightsFunctor = std::function<bool(
@@ -70,9 +127,36 @@ class LayeredHeightMap {
       const PixelSpaceROI* roi = nullptr);
 
  private:
-  void rebuildNextLayer(const FlatHeightMap<S>& down_layer,
-                        FlatHeightMap<S>& up_layer);
+  /// The bottom layer is split into tiles of kPyramidTileShape^2 pixels
+  /// (or smaller if the map is smaller), and the upper layers of a tile
+  /// are built together while the tile is still in cache. This is the
+  /// storage tile, thus an absent tile is skipped as a whole.
+  static constexpr uint16_t kPyramidTileShape = HeightMapTiles::kTileShape;
+  void rebuildNextLayer(std::size_t down_layer_idx);
+  void poolLayerRect(std::size_t down_layer_idx, std::size_t x_begin,
+                     std::size_t x_end, std::size_t y_begin,
+                     std::size_t y_end);
+  const HeightMapTiles& layerMinHeights(std::size_t layer_idx) const;
+  /// For each up tile covering a dirty down tile, allocate (or unshare) it
+  /// if any of its down tiles is allocated, else release it. Thus, the
+  /// rebuild of the up layer can be split into threads without allocation,
+  /// and the dirty up tiles are the ones to rebuild.
+  void prepareUpLayerTiles(std::size_t down_layer_idx);
+  /// Called when the pyramid is consistent with the bottom
+  void clearDirtyFlags();
+  void rebuildLayersInBottomTile(std::size_t n_fused_layers,
+                                 std::size_t tile_shape, std::size_t tile_x,
+                                 std::size_t tile_y);
   void updateEveryLayersFromBottom();
+
+  /// Only rebuild the upper pixels covering the bottom_roi, which is
+  /// halved for each upper layer
+  void updateLayersFromBottomInROI(const PixelSpaceROI& bottom_roi);
+
+  /// The top layer is small and its max is the max of the map, use it as
+  /// a tight upper bound of each layer (the bound of the bottom layer
+  /// is not reduced when heights are removed)
+  void updateHeightUpperBoundByTopLayer();
 };
 
 }  // namespace heightmap
@@ -14,6 +14,27 @@
 namespace fcl {
 namespace octree2 {
 
+/// The changes made by Octree::updateTree. The node indices refer to the
+/// updated tree, and both the index vectors are sorted in ascending order.
+/// Caches built upon the touched nodes (or overlapping with changed_aabb) are
+/// stale, while the others are still valid.
+template <typename S>
+struct OctreeUpdateDelta {
+  std::vector<OctreeVoxel> added_voxels;
+  std::vector<OctreeVoxel> removed_voxels;
+
+  /// The inner nodes whose subtree changed, i.e., the ancestors of
+  /// changed_leaf_nodes. The root is included if anything changed.
+  std::vector<OctreeNodeIndex> changed_inner_nodes;
+  std::vector<OctreeNodeIndex> changed_leaf_nodes;
+
+  /// The bounding box of added and removed voxels in the octree frame
+  AABB<S> changed_aabb;
+
+  bool empty() const { return added_voxels.empty() && removed_voxels.empty(); }
+  void clear();
+};
+
 /// Octree represents a 3D geometry consists of many boxes. These
 /// The represented ranges is:
 ///    [-half_range_x, half_range_x] x [-h_y, h_y] x [-h_z, h_z]
@@ -73,6 +94,17 @@ class Octree {
       std::vector<bool>& new_inner_nodes_fully_occupied) const;
   void rebuildAccordingToPruneInfo(const OctreePruneInfo& prune_info);
 
+  /// Differential update: replace the occupied voxels with the ones from a new
+  /// point cloud, but only touch the nodes related to the added/removed voxels.
+  /// Emptied nodes are kept in the tree (as the pruned ones) and might be
+  /// re-used later; call rebuildTree to compact the storage if required.
+  /// The new nodes are appended, thus prune info built on the old tree has
+  /// mismatched size and would be ignored by the visiting routines.
+  /// The delta might be nullptr if not required.
+  void updateTree(const PointGenerationFunc& point_generator, int n_points,
+                  OctreeUpdateDelta<S>* delta = nullptr);
+  void collectSortedVoxelKeys(std::vector<OctreeVoxelKey>& keys) const;
+
  private:
   // Inner and leaf nodes
   std::vector<OctreeInnerNode> inner_nodes_;
@@ -93,6 +125,10 @@ class Octree {
 
   // Internal utility
   void insertVoxelIntoTree(const OctreeVoxel& key);
+  OctreeNodeIndex markVoxelPathChanged(const OctreeVoxel& voxel,
+                                       std::vector<bool>& inner_node_changed,
+                                       std::vector<bool>& leaf_node_changed);
+  void computeVoxelAABB(const OctreeVoxel& voxel, AABB<S>& voxel_bv) const;
   void rebuildAccordingToPruneInfo(
       const std::vector<bool>& inner_node_pruned,
       const std::vector<OctreeLeafNode>& leaf_nodes,
@@ -112,3 +148,4 @@ class Octree {
 
 #include "fcl/geometry/octree2/octree-inl.h"
 #include "fcl/geometry/octree2/octree_construction-inl.h"
+#include "fcl/geometry/octree2/octree_update-inl.h"
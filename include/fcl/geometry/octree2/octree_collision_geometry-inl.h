@@ -73,6 +73,9 @@ void Octree2CollisionGeometry<S>::computeLocalAABB() {
   // Valid tree
   if (octree->n_leaf_nodes() == 0) {
     this->aabb_local = octree->root_bv();
+  } else if (is_coarse()) {
+    this->aabb_local = octree2::snapAABBToDepth(
+        *octree, octree->leaf_points_AABB(), lod_depth);
   } else {
     this->aabb_local = octree->leaf_points_AABB();
   }
@@ -94,6 +97,44 @@ void Octree2CollisionGeometry<S>::visitLeafNodes(
   octree2::visitOctree<S>(*octree, prune_info.get(), inner_visitor);
 }
 
+template <typename S>
+bool Octree2CollisionGeometry<S>::castRay(const Vector3<S>& origin,
+                                          const Vector3<S>& direction,
+                                          S max_distance, RayHit& hit) const {
+  if (octree == nullptr) return false;
+  return octree2::castRayOnOctree<S>(*octree, prune_info.get(), origin,
+                                     direction, max_distance, hit);
+}
+
+template <typename S>
+void Octree2CollisionGeometry<S>::renderDepthImage(
+    const PinholeCameraIntrinsic<S>& intrinsic,
+    const Transform3<S>& tf_camera_in_octree, S max_depth, S* depth_image,
+    int n_threads) const {
+  if (octree == nullptr) return;
+  octree2::renderOctreeDepthImage<S>(*octree, prune_info.get(), intrinsic,
+                                     tf_camera_in_octree, max_depth,
+                                     depth_image, n_threads);
+}
+
+template <typename S>
+std::size_t Octree2CollisionGeometry<S>::extractOccupiedVoxels(
+    const OBB<S>& region, float* xyz_buffer,
+    std::size_t buffer_capacity) const {
+  if (octree == nullptr) return 0;
+  return octree2::extractOccupiedVoxelsInOBB<S>(
+      *octree, prune_info.get(), region, xyz_buffer, buffer_capacity);
+}
+
+template <typename S>
+std::size_t Octree2CollisionGeometry<S>::extractOccupiedVoxels(
+    const AABB<S>& region, float* xyz_buffer,
+    std::size_t buffer_capacity) const {
+  if (octree == nullptr) return 0;
+  return octree2::extractOccupiedVoxelsInAABB<S>(
+      *octree, prune_info.get(), region, xyz_buffer, buffer_capacity);
+}
+
 template <typename S>
 std::shared_ptr<const Octree2CollisionGeometry<S>>
 Octree2CollisionGeometry<S>::pruneBy(const OBB<S>& obb,
@@ -103,6 +144,12 @@ Octree2CollisionGeometry<S>::pruneBy(const OBB<S>& obb,
     return nullptr;
   }
 
+  // Prune the original geometry and coarsen it again
+  if (is_coarse()) {
+    Octree2CollisionGeometry<S> source(octree, lod_source_prune_info);
+    return source.pruneBy(obb, rebuild_octree)->coarsenTo(lod_depth);
+  }
+
   // Gather existing prune info
   auto new_prune_info = std::make_shared<OctreePruneInfo>();
   if (prune_info != nullptr) {
@@ -132,6 +179,11 @@ Octree2CollisionGeometry<S>::pruneBy(const OBB<S>& obb,
 template <typename S>
 std::shared_ptr<const Octree2CollisionGeometry<S>>
 Octree2CollisionGeometry<S>::rebuildByConsolidatePruneInfo() const {
+  if (is_coarse()) {
+    Octree2CollisionGeometry<S> source(octree, lod_source_prune_info);
+    return source.rebuildByConsolidatePruneInfo()->coarsenTo(lod_depth);
+  }
+
   auto new_tree = std::make_shared<octree2::Octree<S>>(*octree);
   if (prune_info != nullptr) {
     new_tree->rebuildAccordingToPruneInfo(*prune_info);
@@ -144,4 +196,27 @@ Octree2CollisionGeometry<S>::rebuildByConsolidatePruneInfo() const {
   return new_tree_geom;
 }
 
+template <typename S>
+std::shared_ptr<const Octree2CollisionGeometry<S>>
+Octree2CollisionGeometry<S>::coarsenTo(std::uint8_t max_depth) const {
+  if (octree == nullptr) {
+    return nullptr;
+  }
+
+  // Always coarsen the original one
+  const auto& source_prune_info =
+      is_coarse() ? lod_source_prune_info : prune_info;
+  auto coarse_prune_info = std::make_shared<OctreePruneInfo>();
+  octree2::coarsenOctreeAtDepth(*octree, source_prune_info.get(), max_depth,
+                                *coarse_prune_info);
+
+  // Into geom
+  auto coarse_geom = std::make_shared<Octree2CollisionGeometry<S>>(
+      octree, std::move(coarse_prune_info));
+  coarse_geom->lod_depth = max_depth;
+  coarse_geom->lod_source_prune_info = source_prune_info;
+  coarse_geom->computeLocalAABB();
+  return coarse_geom;
+}
+
 }  // namespace fcl
@@ -6,6 +6,9 @@
 
 #include "fcl/geometry/collision_geometry.h"
 #include "fcl/geometry/octree2/octree.h"
+#include "fcl/geometry/octree2/octree_lod.h"
+#include "fcl/geometry/octree2/octree_raycast.h"
+#include "fcl/geometry/octree2/octree_region.h"
 
 namespace fcl {
 
@@ -32,6 +35,15 @@ class Octree2CollisionGeometry : public CollisionGeometry<S> {
   ConstPtr pruneBy(const OBB<S>& obb, bool rebuild_octree) const;
   ConstPtr rebuildByConsolidatePruneInfo() const;
 
+  /// Level-of-detail: a conservative geometry where any non-empty node at
+  /// max_depth is regarded as solid, thus all the queries on it stop at that
+  /// depth. The octree is shared. Pruning a coarse geometry prunes the
+  /// original one and then coarsens it again. Refer to octree_lod.h.
+  ConstPtr coarsenTo(std::uint8_t max_depth) const;
+  bool is_coarse() const {
+    return octree != nullptr && lod_depth < octree->n_layers();
+  }
+
   /// Simple access
   // clang-format off
   OBJECT_TYPE getObjectType() const override { return OT_OCTREE2; };
@@ -52,10 +64,31 @@ class Octree2CollisionGeometry : public CollisionGeometry<S> {
   using VisitLeafNodeFunctor = std::function<bool(const AABB<S>& aabb)>;
   void visitLeafNodes(const VisitLeafNodeFunctor& visit_functor) const;
 
+  /// Ray casting and depth rendering in the local frame of this geometry,
+  /// the pruned part is ignored. Refer to octree_raycast.h for details.
+  using RayHit = octree2::OctreeRayHit<S>;
+  bool castRay(const Vector3<S>& origin, const Vector3<S>& direction,
+               S max_distance, RayHit& hit) const;
+  void renderDepthImage(const PinholeCameraIntrinsic<S>& intrinsic,
+                        const Transform3<S>& tf_camera_in_octree, S max_depth,
+                        S* depth_image, int n_threads = 1) const;
+
+  /// Write the centers of occupied voxels within a region (in the local frame
+  /// of this geometry) into xyz_buffer. Return the total number of voxels in
+  /// the region. Refer to octree_region.h for details.
+  std::size_t extractOccupiedVoxels(const OBB<S>& region, float* xyz_buffer,
+                                    std::size_t buffer_capacity) const;
+  std::size_t extractOccupiedVoxels(const AABB<S>& region, float* xyz_buffer,
+                                    std::size_t buffer_capacity) const;
+
   /// Read-only, shared ptr access to a octree with pruned or not
  private:
   std::shared_ptr<const Octree> octree{nullptr};
   std::shared_ptr<const OctreePruneInfo> prune_info{nullptr};
+
+  // For the coarse geometry, the depth and the original prune info
+  std::uint8_t lod_depth{std::numeric_limits<std::uint8_t>::max()};
+  std::shared_ptr<const OctreePruneInfo> lod_source_prune_info{nullptr};
 };
 
 }  // namespace fcl
@@ -81,6 +81,10 @@ struct OctreeInnerNodeAuxiliaryInfoUpdater {
   const std::vector<bool>* inner_nodes_pruned{nullptr};
   const std::vector<OctreeLeafNode>& leaf_nodes;
 
+  // If not nullptr, only these nodes (and their changed children) are updated
+  // while the others keep their current value in inner_nodes_full
+  const std::vector<bool>* inner_nodes_to_update{nullptr};
+
   // Output
   std::vector<bool>& inner_nodes_full;
 
@@ -122,6 +126,12 @@ bool OctreeInnerNodeAuxiliaryInfoUpdater<S>::updateRecursive(
   assert((inner_nodes_pruned == nullptr) ||
          (inner_nodes_pruned->size() == inner_nodes.size()));
 
+  // Not changed
+  if (inner_nodes_to_update &&
+      !inner_nodes_to_update->operator[](inner_node_index)) {
+    return inner_nodes_full[inner_node_index];
+  }
+
   // If pruned
   const OctreeInnerNode& node = inner_nodes[inner_node_index];
   if (inner_nodes_pruned && inner_nodes_pruned->operator[](inner_node_index)) {
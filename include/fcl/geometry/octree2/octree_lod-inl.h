@@ -0,0 +1,199 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include <cmath>
+
+namespace fcl {
+namespace octree2 {
+namespace internal {
+
+template <typename S>
+struct OctreeCoarsener {
+  // Input
+  const Octree<S>& tree;
+  const std::vector<bool>* inner_nodes_pruned{nullptr};
+  const std::vector<OctreeLeafNode>& leaf_nodes;
+  std::uint8_t max_depth;
+
+  // Output
+  OctreePruneInfo& coarse_info;
+
+  OctreeCoarsener(const Octree<S>& tree_in,
+                  const std::vector<bool>* inner_nodes_pruned_in,
+                  const std::vector<OctreeLeafNode>& leaf_nodes_in,
+                  std::uint8_t max_depth_in, OctreePruneInfo& coarse_info_in)
+      : tree(tree_in),
+        inner_nodes_pruned(inner_nodes_pruned_in),
+        leaf_nodes(leaf_nodes_in),
+        max_depth(max_depth_in),
+        coarse_info(coarse_info_in) {}
+
+  /// Whether any voxel below this inner node is occupied
+  bool isNonEmpty(std::uint32_t inner_node_index, std::uint8_t node_depth);
+
+  /// Actual func; return whether the node is full in the coarse tree.
+  /// Empty nodes are marked as pruned.
+  bool coarsenRecursive(std::uint32_t inner_node_index,
+                        std::uint8_t node_depth);
+};
+
+template <typename S>
+bool OctreeCoarsener<S>::isNonEmpty(std::uint32_t inner_node_index,
+                                    std::uint8_t node_depth) {
+  if (inner_nodes_pruned && (*inner_nodes_pruned)[inner_node_index])
+    return false;
+  const OctreeInnerNode& node = tree.inner_nodes()[inner_node_index];
+  const bool is_child_leaf = tree.isChildLayerLeafNode(node_depth);
+  for (std::uint8_t child_i = 0; child_i < 8; child_i++) {
+    const std::uint32_t child_vector_index = node.children[child_i];
+    if (child_vector_index == kInvalidNodeIndex) continue;
+    if (is_child_leaf) {
+      if (!leaf_nodes[child_vector_index].is_empty()) return true;
+    } else if (isNonEmpty(child_vector_index, node_depth + 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename S>
+bool OctreeCoarsener<S>::coarsenRecursive(std::uint32_t inner_node_index,
+                                          std::uint8_t node_depth) {
+  auto& inner_nodes_full = coarse_info.new_inner_nodes_fully_occupied;
+  auto& inner_nodes_pruned_out = coarse_info.prune_internal_nodes;
+
+  // The solid layer
+  if (node_depth == max_depth) {
+    const bool non_empty = isNonEmpty(inner_node_index, node_depth);
+    inner_nodes_full[inner_node_index] = non_empty;
+    inner_nodes_pruned_out[inner_node_index] = !non_empty;
+    return non_empty;
+  }
+
+  // Pruned
+  assert(node_depth < max_depth);
+  if (inner_nodes_pruned_out[inner_node_index]) {
+    inner_nodes_full[inner_node_index] = false;
+    return false;
+  }
+
+  // Its child is leaf, they are kept as is
+  const OctreeInnerNode& node = tree.inner_nodes()[inner_node_index];
+  if (tree.isChildLayerLeafNode(node_depth)) {
+    bool is_all_child_occupied = true;
+    bool non_empty = false;
+    for (std::uint8_t child_i = 0; child_i < 8; child_i++) {
+      const std::uint32_t child_vector_index = node.children[child_i];
+      if (child_vector_index == kInvalidNodeIndex) {
+        is_all_child_occupied = false;
+        continue;
+      }
+
+      const OctreeLeafNode& leaf_node = leaf_nodes[child_vector_index];
+      if (!leaf_node.is_fully_occupied()) is_all_child_occupied = false;
+      if (!leaf_node.is_empty()) non_empty = true;
+    }
+
+    inner_nodes_full[inner_node_index] = is_all_child_occupied;
+    inner_nodes_pruned_out[inner_node_index] = !non_empty;
+    return is_all_child_occupied;
+  }
+
+  // Next layer is also internal, it is empty if all its children are pruned
+  bool is_all_child_occupied = true;
+  bool non_empty = false;
+  for (std::uint8_t child_i = 0; child_i < 8; child_i++) {
+    const std::uint32_t child_vector_index = node.children[child_i];
+    if (child_vector_index == kInvalidNodeIndex) {
+      is_all_child_occupied = false;
+      continue;
+    }
+
+    if (!coarsenRecursive(child_vector_index, node_depth + 1))
+      is_all_child_occupied = false;
+    if (!inner_nodes_pruned_out[child_vector_index]) non_empty = true;
+  }
+
+  inner_nodes_full[inner_node_index] = is_all_child_occupied;
+  inner_nodes_pruned_out[inner_node_index] = !non_empty;
+  return is_all_child_occupied;
+}
+
+}  // namespace internal
+
+template <typename S>
+void coarsenOctreeAtDepth(const Octree<S>& tree,
+                          const OctreePruneInfo* prune_octree_info,
+                          std::uint8_t max_depth,
+                          OctreePruneInfo& coarse_prune_info) {
+  // Collection inputs
+  const auto& inner_nodes = tree.inner_nodes();
+  const bool use_prune_info =
+      (prune_octree_info != nullptr) &&
+      (prune_octree_info->prune_internal_nodes.size() == inner_nodes.size());
+  const auto& leaf_nodes = use_prune_info ? prune_octree_info->new_leaf_nodes
+                                          : tree.leaf_nodes();
+  const auto& inner_nodes_full =
+      use_prune_info ? prune_octree_info->new_inner_nodes_fully_occupied
+                     : tree.inner_nodes_fully_occupied();
+  const std::vector<bool>* inner_nodes_pruned =
+      use_prune_info ? &prune_octree_info->prune_internal_nodes : nullptr;
+
+  // Init the output with the input
+  coarse_prune_info.new_leaf_nodes = leaf_nodes;
+  coarse_prune_info.new_inner_nodes_fully_occupied = inner_nodes_full;
+  if (inner_nodes_pruned != nullptr) {
+    coarse_prune_info.prune_internal_nodes = *inner_nodes_pruned;
+  } else {
+    coarse_prune_info.prune_internal_nodes.assign(inner_nodes.size(), false);
+  }
+
+  // Nothing to coarsen, the leaf nodes are the finest nodes in the tree
+  const std::uint8_t leaf_node_depth = tree.n_layers() - 2;
+  if (max_depth >= leaf_node_depth) {
+    if (max_depth > leaf_node_depth) return;
+
+    // Non-empty leaf nodes are solid
+    for (auto& leaf_node : coarse_prune_info.new_leaf_nodes) {
+      if (!leaf_node.is_empty()) leaf_node.child_occupied.set_all();
+    }
+    tree.updateInnerNodeAuxiliaryInfo(
+        coarse_prune_info.new_leaf_nodes,
+        &coarse_prune_info.prune_internal_nodes,
+        coarse_prune_info.new_inner_nodes_fully_occupied);
+    return;
+  }
+
+  // Inner nodes at max_depth are solid
+  internal::OctreeCoarsener<S> coarsener(tree, inner_nodes_pruned, leaf_nodes,
+                                         max_depth, coarse_prune_info);
+  coarsener.coarsenRecursive(0, 0);
+}
+
+template <typename S>
+AABB<S> snapAABBToDepth(const Octree<S>& tree, const AABB<S>& aabb,
+                        std::uint8_t max_depth) {
+  if (max_depth >= tree.n_layers()) return aabb;
+  const AABB<S>& root_bv = tree.root_bv();
+  const Vector3<S>& resolution = tree.layer_metas()[max_depth].resolution_xyz;
+  AABB<S> snapped;
+  using std::ceil;
+  using std::floor;
+  for (auto i = 0; i < 3; i++) {
+    snapped.min_[i] =
+        root_bv.min_[i] +
+        floor((aabb.min_[i] - root_bv.min_[i]) / resolution[i]) * resolution[i];
+    snapped.max_[i] =
+        root_bv.min_[i] +
+        ceil((aabb.max_[i] - root_bv.min_[i]) / resolution[i]) * resolution[i];
+    snapped.min_[i] = std::max(snapped.min_[i], root_bv.min_[i]);
+    snapped.max_[i] = std::min(snapped.max_[i], root_bv.max_[i]);
+  }
+  return snapped;
+}
+
+}  // namespace octree2
+}  // namespace fcl
@@ -0,0 +1,37 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include "fcl/geometry/octree2/octree.h"
+
+namespace fcl {
+namespace octree2 {
+
+/// Level-of-detail of an octree: any non-empty node at max_depth is regarded
+/// as fully occupied, thus the traversal never goes below that depth and the
+/// query time is bounded regardless of the density of the points. The result
+/// is conservative, i.e., the coarse geometry contains the original one.
+///
+/// The output is expressed as prune info for the original tree, thus it can
+/// be used with all the routines that accept prune info. The empty subtrees
+/// are marked as pruned. The prune_info might be nullptr, else the pruned part
+/// is ignored. A max_depth larger or equal to the depth of the leaf node keeps
+/// the 2x2x2 leaf nodes as they are, thus no change in that case.
+template <typename S>
+void coarsenOctreeAtDepth(const Octree<S>& tree,
+                          const OctreePruneInfo* prune_octree_info,
+                          std::uint8_t max_depth,
+                          OctreePruneInfo& coarse_prune_info);
+
+/// The AABB of all the depth-max_depth nodes overlapping with the given box,
+/// which bounds the coarse geometry if the box bounds the original one.
+template <typename S>
+AABB<S> snapAABBToDepth(const Octree<S>& tree, const AABB<S>& aabb,
+                        std::uint8_t max_depth);
+
+}  // namespace octree2
+}  // namespace fcl
+
+#include "fcl/geometry/octree2/octree_lod-inl.h"
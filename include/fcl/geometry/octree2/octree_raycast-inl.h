@@ -0,0 +1,300 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace fcl {
+namespace octree2 {
+namespace internal {
+
+/// Each inner node pushes at most 8 children, and the octree has at most
+/// 17 layers as the bottom_half_shape is std::uint16_t
+constexpr int kRayCastMaxNumLayers = 20;
+constexpr int kRayCastStackCapacity = 8 * kRayCastMaxNumLayers;
+
+/// Ray with pre-computed inverse direction for slab test
+template <typename S>
+struct OctreeRay {
+  Vector3<S> origin;
+  Vector3<S> direction;  // normalized
+  Vector3<S> inv_direction;
+  S max_distance;
+
+  bool initialize(const Vector3<S>& origin_in,
+                  const Vector3<S>& direction_in, S max_distance_in) {
+    const S direction_norm = direction_in.norm();
+    if (!(direction_norm > S(0.0)) || !(max_distance_in >= S(0.0)))
+      return false;
+    origin = origin_in;
+    direction = direction_in / direction_norm;
+    max_distance = max_distance_in;
+
+    // A huge (but finite) value avoids 0 * inf for axis-parallel rays
+    for (auto i = 0; i < 3; i++) {
+      inv_direction[i] = (direction[i] != S(0.0))
+                             ? S(1.0) / direction[i]
+                             : std::numeric_limits<S>::max();
+    }
+    return true;
+  }
+
+  /// Slab test, t_enter is clamped to [0, max_distance]
+  inline bool intersect(const AABB<S>& bv, S& t_enter) const {
+    S t_0 = S(0.0);
+    S t_1 = max_distance;
+    for (auto i = 0; i < 3; i++) {
+      S t_a = (bv.min_[i] - origin[i]) * inv_direction[i];
+      S t_b = (bv.max_[i] - origin[i]) * inv_direction[i];
+      if (t_a > t_b) std::swap(t_a, t_b);
+      t_0 = t_0 < t_a ? t_a : t_0;
+      t_1 = t_1 > t_b ? t_b : t_1;
+      if (t_0 > t_1) return false;
+    }
+
+    t_enter = t_0;
+    return true;
+  }
+};
+
+/// Resolve the tree (and the prune info) once and cast many rays
+template <typename S>
+class OctreeRayCaster {
+ public:
+  OctreeRayCaster(const Octree<S>& tree_in,
+                  const OctreePruneInfo* prune_octree_info);
+  bool cast(const OctreeRay<S>& ray, OctreeRayHit<S>& hit) const;
+
+ private:
+  const Octree<S>& tree;
+  const std::vector<OctreeInnerNode>& inner_nodes;
+  const std::vector<bool>& inner_nodes_full;
+  const std::vector<OctreeLeafNode>& leaf_nodes;
+  const std::vector<bool>* prune_internal_nodes;
+
+  struct StackElement {
+    OctreeTraverseStackElement<S> node;
+    S t_enter;
+  };
+
+  static void writeHit(const OctreeRay<S>& ray, const AABB<S>& bv,
+                       std::uint8_t depth, S t_enter, OctreeRayHit<S>& hit);
+};
+
+template <typename S>
+OctreeRayCaster<S>::OctreeRayCaster(const Octree<S>& tree_in,
+                                    const OctreePruneInfo* prune_octree_info)
+    : tree(tree_in),
+      inner_nodes(tree_in.inner_nodes()),
+      inner_nodes_full(
+          (prune_octree_info != nullptr &&
+           prune_octree_info->new_inner_nodes_fully_occupied.size() ==
+               tree_in.inner_nodes_fully_occupied().size())
+              ? prune_octree_info->new_inner_nodes_fully_occupied
+              : tree_in.inner_nodes_fully_occupied()),
+      leaf_nodes((prune_octree_info != nullptr &&
+                  prune_octree_info->new_leaf_nodes.size() ==
+                      tree_in.leaf_nodes().size())
+                     ? prune_octree_info->new_leaf_nodes
+                     : tree_in.leaf_nodes()),
+      prune_internal_nodes(
+          (prune_octree_info != nullptr &&
+           prune_octree_info->prune_internal_nodes.size() ==
+               tree_in.inner_nodes().size())
+              ? &prune_octree_info->prune_internal_nodes
+              : nullptr) {
+  assert(inner_nodes.size() == inner_nodes_full.size());
+  assert(tree.n_layers() <= kRayCastMaxNumLayers);
+}
+
+template <typename S>
+void OctreeRayCaster<S>::writeHit(const OctreeRay<S>& ray, const AABB<S>& bv,
+                                  std::uint8_t depth, S t_enter,
+                                  OctreeRayHit<S>& hit) {
+  hit.distance = t_enter;
+  hit.point = ray.origin + t_enter * ray.direction;
+  hit.voxel_bv = bv;
+  hit.depth = depth;
+}
+
+template <typename S>
+bool OctreeRayCaster<S>::cast(const OctreeRay<S>& ray,
+                              OctreeRayHit<S>& hit) const {
+  // The root
+  std::array<StackElement, kRayCastStackCapacity> task_stack;
+  int stack_size = 0;
+  {
+    StackElement root;
+    root.node = OctreeTraverseStackElement<S>::MakeRoot(tree.root_bv());
+    if (!ray.intersect(root.node.bv, root.t_enter)) return false;
+    task_stack[stack_size++] = root;
+  }
+
+  // Children of a node, sorted by their entering distance
+  std::array<StackElement, kNumberChildOfOctant> children;
+  AABB<S> local_aabb;
+  S t_enter;
+  while (stack_size > 0) {
+    // Pop the stack. The children are pushed front-to-back, and the ray
+    // intervals of the boxes within a node are disjoint. Thus, the first hit
+    // is the nearest one
+    const StackElement this_task = task_stack[--stack_size];
+    const auto& this_node = this_task.node;
+
+    // Leaf node
+    if (this_node.is_leaf_node) {
+      assert(this_node.node_vector_index < leaf_nodes.size());
+      const OctreeLeafNode& leaf_node = leaf_nodes[this_node.node_vector_index];
+      if (leaf_node.is_fully_occupied()) {
+        writeHit(ray, this_node.bv, this_node.depth, this_task.t_enter, hit);
+        return true;
+      }
+
+      // The nearest occupied child
+      bool leaf_hit = false;
+      S nearest_t = ray.max_distance;
+      AABB<S> nearest_bv;
+      for (std::uint8_t child_i = 0; child_i < 8; child_i++) {
+        if (!leaf_node.child_occupied.test_i(child_i)) continue;
+        computeChildAABB(this_node.bv, child_i, local_aabb);
+        if (!ray.intersect(local_aabb, t_enter)) continue;
+        if (leaf_hit && t_enter >= nearest_t) continue;
+        leaf_hit = true;
+        nearest_t = t_enter;
+        nearest_bv = local_aabb;
+      }
+
+      if (leaf_hit) {
+        writeHit(ray, nearest_bv, this_node.depth + 1, nearest_t, hit);
+        return true;
+      }
+      continue;
+    }
+
+    // Inner node
+    assert(this_node.node_vector_index < inner_nodes.size());
+    if (prune_internal_nodes != nullptr &&
+        (*prune_internal_nodes)[this_node.node_vector_index]) {
+      continue;
+    }
+
+    if (inner_nodes_full[this_node.node_vector_index]) {
+      writeHit(ray, this_node.bv, this_node.depth, this_task.t_enter, hit);
+      return true;
+    }
+
+    // Collect the children along the ray
+    const OctreeInnerNode& node = inner_nodes[this_node.node_vector_index];
+    int n_children = 0;
+    for (std::uint8_t child_i = 0; child_i < 8; child_i++) {
+      const auto child_vector_index = node.children[child_i];
+      if (child_vector_index == kInvalidNodeIndex) continue;
+      computeChildAABB(this_node.bv, child_i, local_aabb);
+      if (!ray.intersect(local_aabb, t_enter)) continue;
+
+      // Insertion sort in descending order of t_enter
+      StackElement child;
+      child.node =
+          tree.makeStackElementChild(this_node, local_aabb, child_vector_index);
+      child.t_enter = t_enter;
+      int insert_at = n_children;
+      while (insert_at > 0 && children[insert_at - 1].t_enter < t_enter) {
+        children[insert_at] = children[insert_at - 1];
+        insert_at--;
+      }
+      children[insert_at] = child;
+      n_children++;
+    }
+
+    // The nearest child is on the top
+    assert(stack_size + n_children <= kRayCastStackCapacity);
+    for (int i = 0; i < n_children; i++) {
+      task_stack[stack_size++] = children[i];
+    }
+  }
+
+  // No hit
+  return false;
+}
+
+}  // namespace internal
+
+template <typename S>
+bool castRayOnOctree(const Octree<S>& tree,
+                     const OctreePruneInfo* prune_octree_info,
+                     const Vector3<S>& origin, const Vector3<S>& direction,
+                     S max_distance, OctreeRayHit<S>& hit) {
+  internal::OctreeRay<S> ray;
+  if (!ray.initialize(origin, direction, max_distance)) return false;
+  internal::OctreeRayCaster<S> caster(tree, prune_octree_info);
+  return caster.cast(ray, hit);
+}
+
+template <typename S>
+void renderOctreeDepthImage(const Octree<S>& tree,
+                            const OctreePruneInfo* prune_octree_info,
+                            const PinholeCameraIntrinsic<S>& intrinsic,
+                            const Transform3<S>& tf_camera_in_octree,
+                            S max_depth, S* depth_image, int n_threads) {
+  if (depth_image == nullptr || intrinsic.width <= 0 || intrinsic.height <= 0)
+    return;
+  const internal::OctreeRayCaster<S> caster(tree, prune_octree_info);
+  const Vector3<S> camera_origin = tf_camera_in_octree.translation();
+  const Matrix3<S> camera_rotation = tf_camera_in_octree.linear();
+
+  // Render the rows with a shared counter, which balances the load
+  // automatically as rows facing the empty space are cheap
+  std::atomic<int> next_row{0};
+  auto render_rows = [&]() -> void {
+    internal::OctreeRay<S> ray;
+    OctreeRayHit<S> hit;
+    while (true) {
+      const int row = next_row.fetch_add(1);
+      if (row >= intrinsic.height) break;
+      S* row_depth = depth_image + static_cast<std::size_t>(row) *
+                                       static_cast<std::size_t>(intrinsic.width);
+      for (int col = 0; col < intrinsic.width; col++) {
+        // The direction has z == 1 in camera frame
+        const Vector3<S> direction_in_camera =
+            intrinsic.pixelToRayDirection(S(col), S(row));
+        const S direction_norm = direction_in_camera.norm();
+        row_depth[col] = S(0.0);
+        if (!ray.initialize(camera_origin,
+                            camera_rotation * direction_in_camera,
+                            max_depth * direction_norm)) {
+          continue;
+        }
+
+        if (caster.cast(ray, hit)) {
+          row_depth[col] = hit.distance / direction_norm;
+        }
+      }
+    }
+  };
+
+  // Run in this thread or dispatch to workers
+  if (n_threads <= 0) {
+    n_threads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  n_threads = std::max(1, std::min(n_threads, intrinsic.height));
+  if (n_threads == 1) {
+    render_rows();
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve(n_threads - 1);
+  for (int i = 1; i < n_threads; i++) workers.emplace_back(render_rows);
+  render_rows();
+  for (auto& worker : workers) worker.join();
+}
+
+}  // namespace octree2
+}  // namespace fcl
@@ -0,0 +1,54 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include "fcl/geometry/octree2/octree.h"
+#include "fcl/math/pinhole_camera.h"
+
+namespace fcl {
+namespace octree2 {
+
+/// The first occupied box along a ray. All the quantities are expressed in
+/// the frame of the octree.
+template <typename S>
+struct OctreeRayHit {
+  /// Distance from the ray origin, measured along the normalized direction
+  S distance{0};
+  Vector3<S> point{Vector3<S>::Zero()};
+
+  /// The box being hit, which can be a voxel or a fully occupied node
+  AABB<S> voxel_bv;
+  std::uint8_t depth{0};
+};
+
+/// Cast a ray starting at origin (in octree frame) along direction, which does
+/// NOT need to be normalized. Only hits within [0, max_distance] are reported.
+/// Traversal is hierarchical and front-to-back, thus the nearest occupied box
+/// is found without visiting the nodes behind it.
+/// The prune_info might be nullptr, else the pruned part is ignored.
+/// Return whether there is a hit.
+template <typename S>
+bool castRayOnOctree(const Octree<S>& tree,
+                     const OctreePruneInfo* prune_octree_info,
+                     const Vector3<S>& origin, const Vector3<S>& direction,
+                     S max_distance, OctreeRayHit<S>& hit);
+
+/// Render a depth image of the octree from a pinhole camera, whose pose is
+/// given in the frame of the octree. The depth_image must have intrinsic.width
+/// * intrinsic.height elements in row-major order. The depth (z in camera
+/// frame) of pixels without a hit within max_depth is written as 0.
+/// Rows are distributed to n_threads worker threads, a non-positive n_threads
+/// implies using all the hardware threads.
+template <typename S>
+void renderOctreeDepthImage(const Octree<S>& tree,
+                            const OctreePruneInfo* prune_octree_info,
+                            const PinholeCameraIntrinsic<S>& intrinsic,
+                            const Transform3<S>& tf_camera_in_octree,
+                            S max_depth, S* depth_image, int n_threads = 1);
+
+}  // namespace octree2
+}  // namespace fcl
+
+#include "fcl/geometry/octree2/octree_raycast-inl.h"
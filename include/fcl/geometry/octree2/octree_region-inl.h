@@ -0,0 +1,226 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace fcl {
+namespace octree2 {
+namespace internal {
+
+/// Region tests used for culling the nodes during extraction
+template <typename S>
+struct OctreeOBBRegion {
+  explicit OctreeOBBRegion(const OBB<S>& obb_in) : obb(obb_in) {
+    node_obb.axis.setIdentity();
+  }
+
+  inline bool overlap(const AABB<S>& bv) {
+    node_obb.To = bv.center();
+    node_obb.extent = S(0.5) * (bv.max_ - bv.min_);
+    return obb.overlap(node_obb);
+  }
+  inline bool contain(const AABB<S>& bv) const { return is_contained(obb, bv); }
+  inline bool contain(const Vector3<S>& point) const {
+    return obb.contain(point);
+  }
+
+ private:
+  const OBB<S>& obb;
+  OBB<S> node_obb;
+};
+
+template <typename S>
+struct OctreeAABBRegion {
+  explicit OctreeAABBRegion(const AABB<S>& aabb_in) : aabb(aabb_in) {}
+
+  inline bool overlap(const AABB<S>& bv) const { return aabb.overlap(bv); }
+  inline bool contain(const AABB<S>& bv) const { return aabb.contain(bv); }
+  inline bool contain(const Vector3<S>& point) const {
+    return aabb.contain(point);
+  }
+
+ private:
+  const AABB<S>& aabb;
+};
+
+/// Write the voxel centers into the buffer, count the overflowed ones
+struct OctreeVoxelCenterWriter {
+  float* xyz_buffer{nullptr};
+  std::size_t buffer_capacity{0};
+  std::size_t n_voxels{0};
+
+  template <typename S>
+  inline void write(S x, S y, S z) {
+    if (n_voxels < buffer_capacity) {
+      float* xyz = xyz_buffer + 3 * n_voxels;
+      xyz[0] = static_cast<float>(x);
+      xyz[1] = static_cast<float>(y);
+      xyz[2] = static_cast<float>(z);
+    }
+    n_voxels++;
+  }
+};
+
+/// Write the bottom voxels of a fully occupied box. If the box is contained in
+/// the region, the per-voxel test is skipped.
+template <typename S, typename Region>
+void writeFullyOccupiedBox(const AABB<S>& bv, const Vector3<S>& resolution,
+                           bool contained, const Region& region,
+                           OctreeVoxelCenterWriter& writer) {
+  std::array<int, 3> shape;
+  for (auto i = 0; i < 3; i++) {
+    shape[i] = static_cast<int>(std::round((bv.max_[i] - bv.min_[i]) /
+                                           resolution[i]));
+  }
+
+  // Only counting is required if the buffer is already full
+  const std::size_t n_box_voxels = static_cast<std::size_t>(shape[0]) *
+                                   static_cast<std::size_t>(shape[1]) *
+                                   static_cast<std::size_t>(shape[2]);
+  if (contained && writer.n_voxels >= writer.buffer_capacity) {
+    writer.n_voxels += n_box_voxels;
+    return;
+  }
+
+  const Vector3<S> first_center = bv.min_ + S(0.5) * resolution;
+  Vector3<S> center;
+  for (int ix = 0; ix < shape[0]; ix++) {
+    center.x() = first_center.x() + S(ix) * resolution.x();
+    for (int iy = 0; iy < shape[1]; iy++) {
+      center.y() = first_center.y() + S(iy) * resolution.y();
+      for (int iz = 0; iz < shape[2]; iz++) {
+        center.z() = first_center.z() + S(iz) * resolution.z();
+        if (contained || region.contain(center)) {
+          writer.write(center.x(), center.y(), center.z());
+        }
+      }
+    }
+  }
+}
+
+template <typename S, typename Region>
+std::size_t extractOccupiedVoxelsInRegion(
+    const Octree<S>& tree, const OctreePruneInfo* prune_octree_info,
+    Region& region, float* xyz_buffer, std::size_t buffer_capacity) {
+  // Collection inputs
+  const auto& inner_nodes = tree.inner_nodes();
+  const auto& inner_nodes_full =
+      (prune_octree_info != nullptr &&
+       prune_octree_info->new_inner_nodes_fully_occupied.size() ==
+           tree.inner_nodes_fully_occupied().size())
+          ? prune_octree_info->new_inner_nodes_fully_occupied
+          : tree.inner_nodes_fully_occupied();
+  const auto& leaf_nodes =
+      (prune_octree_info != nullptr &&
+       prune_octree_info->new_leaf_nodes.size() == tree.leaf_nodes().size())
+          ? prune_octree_info->new_leaf_nodes
+          : tree.leaf_nodes();
+  const bool try_prune_inner_nodes =
+      (prune_octree_info != nullptr) &&
+      (prune_octree_info->prune_internal_nodes.size() == inner_nodes.size());
+  assert(inner_nodes.size() == inner_nodes_full.size());
+  const Vector3<S>& resolution = tree.bottom_resolution_xyz();
+
+  OctreeVoxelCenterWriter writer;
+  writer.xyz_buffer = xyz_buffer;
+  writer.buffer_capacity = (xyz_buffer == nullptr) ? 0 : buffer_capacity;
+  if (inner_nodes.empty()) return 0;
+
+  // Each element is (node, whether the node is contained in the region). The
+  // depth-first stack holds at most 8 elements per layer.
+  struct StackElement {
+    OctreeTraverseStackElement<S> node;
+    bool contained;
+  };
+  std::vector<StackElement> task_stack;
+  task_stack.reserve(8 * (tree.n_layers() + 1));
+  {
+    const auto root = OctreeTraverseStackElement<S>::MakeRoot(tree.root_bv());
+    if (!region.overlap(root.bv)) return 0;
+    task_stack.push_back(StackElement{root, region.contain(root.bv)});
+  }
+
+  // Process loop
+  AABB<S> local_aabb;
+  while (!task_stack.empty()) {
+    const StackElement this_task = task_stack.back();
+    task_stack.pop_back();
+    const auto& this_node = this_task.node;
+
+    // Leaf node, whose children are the bottom voxels
+    if (this_node.is_leaf_node) {
+      assert(this_node.node_vector_index < leaf_nodes.size());
+      const OctreeLeafNode& leaf_node = leaf_nodes[this_node.node_vector_index];
+      for (std::uint8_t child_i = 0; child_i < 8; child_i++) {
+        if (!leaf_node.child_occupied.test_i(child_i)) continue;
+        computeChildAABB(this_node.bv, child_i, local_aabb);
+        const Vector3<S> center = local_aabb.center();
+        if (this_task.contained || region.contain(center)) {
+          writer.write(center.x(), center.y(), center.z());
+        }
+      }
+      continue;
+    }
+
+    // Inner node
+    assert(this_node.node_vector_index < inner_nodes.size());
+    if (try_prune_inner_nodes &&
+        prune_octree_info->prune_internal_nodes[this_node.node_vector_index]) {
+      continue;
+    }
+
+    if (inner_nodes_full[this_node.node_vector_index]) {
+      writeFullyOccupiedBox(this_node.bv, resolution, this_task.contained,
+                            region, writer);
+      continue;
+    }
+
+    // Into children, the culling is skipped for contained nodes
+    const OctreeInnerNode& node = inner_nodes[this_node.node_vector_index];
+    for (std::uint8_t child_i = 0; child_i < 8; child_i++) {
+      const auto child_vector_index = node.children[child_i];
+      if (child_vector_index == kInvalidNodeIndex) continue;
+      computeChildAABB(this_node.bv, child_i, local_aabb);
+      bool child_contained = this_task.contained;
+      if (!child_contained) {
+        if (!region.overlap(local_aabb)) continue;
+        child_contained = region.contain(local_aabb);
+      }
+
+      task_stack.push_back(StackElement{
+          tree.makeStackElementChild(this_node, local_aabb, child_vector_index),
+          child_contained});
+    }
+  }
+
+  return writer.n_voxels;
+}
+
+}  // namespace internal
+
+template <typename S>
+std::size_t extractOccupiedVoxelsInOBB(const Octree<S>& tree,
+                                       const OctreePruneInfo* prune_octree_info,
+                                       const OBB<S>& region, float* xyz_buffer,
+                                       std::size_t buffer_capacity) {
+  internal::OctreeOBBRegion<S> obb_region(region);
+  return internal::extractOccupiedVoxelsInRegion<S>(
+      tree, prune_octree_info, obb_region, xyz_buffer, buffer_capacity);
+}
+
+template <typename S>
+std::size_t extractOccupiedVoxelsInAABB(
+    const Octree<S>& tree, const OctreePruneInfo* prune_octree_info,
+    const AABB<S>& region, float* xyz_buffer, std::size_t buffer_capacity) {
+  internal::OctreeAABBRegion<S> aabb_region(region);
+  return internal::extractOccupiedVoxelsInRegion<S>(
+      tree, prune_octree_info, aabb_region, xyz_buffer, buffer_capacity);
+}
+
+}  // namespace octree2
+}  // namespace fcl
@@ -0,0 +1,38 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include "fcl/geometry/octree2/octree.h"
+#include "fcl/geometry/octree2/octree_util.h"
+
+namespace fcl {
+namespace octree2 {
+
+/// Extract the centers of occupied bottom voxels within a region (in octree
+/// frame) into a caller-provided xyz buffer, packed as [x0, y0, z0, x1, ...].
+/// A voxel is regarded as inside if its center is inside the region, which is
+/// consistent with pruneOctreeByOBB. The inner nodes outside the region are
+/// culled, and the nodes fully inside the region are written without further
+/// per-voxel tests. Fully occupied nodes are expanded into bottom voxels.
+///
+/// At most buffer_capacity voxels (3 * buffer_capacity floats) are written.
+/// The returned value is the total number of voxels within the region, which
+/// might be larger than buffer_capacity. In that case, the caller might resize
+/// the buffer and query again. The prune_info might be nullptr, else the pruned
+/// part is ignored.
+template <typename S>
+std::size_t extractOccupiedVoxelsInOBB(const Octree<S>& tree,
+                                       const OctreePruneInfo* prune_octree_info,
+                                       const OBB<S>& region, float* xyz_buffer,
+                                       std::size_t buffer_capacity);
+template <typename S>
+std::size_t extractOccupiedVoxelsInAABB(
+    const Octree<S>& tree, const OctreePruneInfo* prune_octree_info,
+    const AABB<S>& region, float* xyz_buffer, std::size_t buffer_capacity);
+
+}  // namespace octree2
+}  // namespace fcl
+
+#include "fcl/geometry/octree2/octree_region-inl.h"
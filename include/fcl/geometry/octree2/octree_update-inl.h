@@ -0,0 +1,198 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+
+namespace fcl {
+namespace octree2 {
+
+template <typename S>
+void OctreeUpdateDelta<S>::clear() {
+  added_voxels.clear();
+  removed_voxels.clear();
+  changed_inner_nodes.clear();
+  changed_leaf_nodes.clear();
+  changed_aabb = AABB<S>();
+}
+
+template <typename S>
+void Octree<S>::collectSortedVoxelKeys(
+    std::vector<OctreeVoxelKey>& keys) const {
+  keys.clear();
+  keys.reserve(4 * leaf_nodes_.size());
+
+  // The node and the voxel coordinate of its min corner
+  struct StackElement {
+    std::uint32_t node_vector_index;
+    std::uint8_t depth;
+    OctreeVoxel min_voxel;
+  };
+
+  // Children are pushed in reversed order, thus visited in ascending key order
+  std::stack<StackElement> task_stack;
+  task_stack.push(StackElement{0, 0, OctreeVoxel()});
+  while (!task_stack.empty()) {
+    const StackElement this_task = task_stack.top();
+    task_stack.pop();
+
+    // The bottom voxels in the leaf node
+    if (this_task.depth == meta_info_.leaf_node_depth) {
+      assert(this_task.node_vector_index < leaf_nodes_.size());
+      const OctreeLeafNode& leaf_node =
+          leaf_nodes_[this_task.node_vector_index];
+      for (std::uint8_t child_i = 0; child_i < 8; child_i++) {
+        if (!leaf_node.child_occupied.test_i(child_i)) continue;
+        OctreeVoxel voxel = this_task.min_voxel;
+        voxel.x() += (child_i & 1) ? 1 : 0;
+        voxel.y() += (child_i & 2) ? 1 : 0;
+        voxel.z() += (child_i & 4) ? 1 : 0;
+        keys.push_back(encodeVoxelKey(voxel));
+      }
+      continue;
+    }
+
+    // Inner node, the children might be leaf nodes
+    const OctreeInnerNode& node = inner_nodes_[this_task.node_vector_index];
+    const std::uint16_t child_shape =
+        layer_configuration_.back().full_shape >> (this_task.depth + 1);
+    for (int child_i = 7; child_i >= 0; child_i--) {
+      const auto child_vector_index = node.children[child_i];
+      if (child_vector_index == kInvalidNodeIndex) continue;
+      StackElement child{child_vector_index,
+                         static_cast<std::uint8_t>(this_task.depth + 1),
+                         this_task.min_voxel};
+      if (child_i & 1) child.min_voxel.x() += child_shape;
+      if (child_i & 2) child.min_voxel.y() += child_shape;
+      if (child_i & 4) child.min_voxel.z() += child_shape;
+      task_stack.push(child);
+    }
+  }
+
+  assert(std::is_sorted(keys.begin(), keys.end()));
+}
+
+template <typename S>
+OctreeNodeIndex Octree<S>::markVoxelPathChanged(
+    const OctreeVoxel& voxel, std::vector<bool>& inner_node_changed,
+    std::vector<bool>& leaf_node_changed) {
+  std::uint32_t current_node_vector_idx = 0;
+  std::uint8_t current_node_depth = 0;
+  while (true) {
+    // Do NOT stop at the full nodes, their children are still stored
+    inner_node_changed[current_node_vector_idx] = true;
+    const auto& node = inner_nodes_[current_node_vector_idx];
+    const bool child_is_leaf_node = isChildLayerLeafNode(current_node_depth);
+    const auto child_index = computeChildIndex(voxel, current_node_depth);
+    current_node_vector_idx = node.children[child_index];
+    current_node_depth += 1;
+    assert(current_node_vector_idx != kInvalidNodeIndex);
+    if (child_is_leaf_node) break;
+  }
+
+  assert(current_node_vector_idx < leaf_nodes_.size());
+  leaf_node_changed[current_node_vector_idx] = true;
+  return current_node_vector_idx;
+}
+
+template <typename S>
+void Octree<S>::computeVoxelAABB(const OctreeVoxel& voxel,
+                                 AABB<S>& voxel_bv) const {
+  const auto& resolution = meta_info_.real_leaf_resolution;
+  for (auto i = 0; i < 3; i++) {
+    voxel_bv.min_[i] =
+        meta_info_.root_bv.min_[i] + S(voxel.xyz[i]) * resolution[i];
+    voxel_bv.max_[i] = voxel_bv.min_[i] + resolution[i];
+  }
+}
+
+template <typename S>
+void Octree<S>::updateTree(const PointGenerationFunc& point_generator,
+                           int n_points, OctreeUpdateDelta<S>* delta) {
+  // Sorted keys of the new cloud
+  std::vector<OctreeVoxelKey> new_keys;
+  new_keys.reserve(n_points);
+  AABB<S> new_points_AABB;
+  OctreeVoxel voxel;
+  Vector3<S> point;
+  S x, y, z;
+  for (auto i = 0; i < n_points; i++) {
+    point_generator(i, x, y, z);
+    point.x() = x;
+    point.y() = y;
+    point.z() = z;
+    const bool in_range = computeVoxelCoordinate(point, voxel);
+    if (!in_range) continue;
+    new_points_AABB += point;
+    new_keys.push_back(encodeVoxelKey(voxel));
+  }
+  std::sort(new_keys.begin(), new_keys.end());
+  new_keys.erase(std::unique(new_keys.begin(), new_keys.end()),
+                 new_keys.end());
+
+  // Sorted keys of the existing tree, then the difference
+  std::vector<OctreeVoxelKey> old_keys;
+  collectSortedVoxelKeys(old_keys);
+  std::vector<OctreeVoxelKey> added_keys, removed_keys;
+  std::set_difference(new_keys.begin(), new_keys.end(), old_keys.begin(),
+                      old_keys.end(), std::back_inserter(added_keys));
+  std::set_difference(old_keys.begin(), old_keys.end(), new_keys.begin(),
+                      new_keys.end(), std::back_inserter(removed_keys));
+  leaf_points_AABB_ = new_points_AABB;
+
+  // Apply the delta, the new nodes are appended
+  for (const auto key : added_keys) insertVoxelIntoTree(decodeVoxelKey(key));
+  std::vector<bool> inner_node_changed(inner_nodes_.size(), false);
+  std::vector<bool> leaf_node_changed(leaf_nodes_.size(), false);
+  for (const auto key : added_keys) {
+    markVoxelPathChanged(decodeVoxelKey(key), inner_node_changed,
+                         leaf_node_changed);
+  }
+  for (const auto key : removed_keys) {
+    const OctreeVoxel removed_voxel = decodeVoxelKey(key);
+    const auto leaf_index = markVoxelPathChanged(
+        removed_voxel, inner_node_changed, leaf_node_changed);
+    leaf_nodes_[leaf_index].child_occupied.clear_i(
+        computeChildIndex(removed_voxel, meta_info_.leaf_node_depth));
+  }
+
+  // Only the changed nodes need updating
+  if (!added_keys.empty() || !removed_keys.empty()) {
+    internal::OctreeInnerNodeAuxiliaryInfoUpdater<S> updater(
+        *this, nullptr, leaf_nodes_, inner_nodes_fully_occupied_);
+    updater.inner_nodes_to_update = &inner_node_changed;
+    assert(updater.sanityCheck());
+    updater.updateRecursive(0, 0);
+  }
+
+  // Report the delta
+  if (delta == nullptr) return;
+  delta->clear();
+  AABB<S> voxel_bv;
+  delta->added_voxels.reserve(added_keys.size());
+  for (const auto key : added_keys) {
+    delta->added_voxels.push_back(decodeVoxelKey(key));
+    computeVoxelAABB(delta->added_voxels.back(), voxel_bv);
+    delta->changed_aabb += voxel_bv;
+  }
+  delta->removed_voxels.reserve(removed_keys.size());
+  for (const auto key : removed_keys) {
+    delta->removed_voxels.push_back(decodeVoxelKey(key));
+    computeVoxelAABB(delta->removed_voxels.back(), voxel_bv);
+    delta->changed_aabb += voxel_bv;
+  }
+  for (std::size_t i = 0; i < inner_node_changed.size(); i++) {
+    if (inner_node_changed[i])
+      delta->changed_inner_nodes.push_back(static_cast<OctreeNodeIndex>(i));
+  }
+  for (std::size_t i = 0; i < leaf_node_changed.size(); i++) {
+    if (leaf_node_changed[i])
+      delta->changed_leaf_nodes.push_back(static_cast<OctreeNodeIndex>(i));
+  }
+}
+
+}  // namespace octree2
+}  // namespace fcl
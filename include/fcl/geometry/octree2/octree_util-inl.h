@@ -38,6 +38,44 @@ void computeChildAABB(const AABB<S>& root_bv, std::uint8_t child_i,
   }
 }
 
+namespace internal {
+
+/// Spread the 16 bits of x into every third bit of the result
+inline std::uint64_t spreadBitsBy3(std::uint16_t x) {
+  std::uint64_t v = x;
+  v = (v | (v << 16)) & 0x0000FF0000FFull;
+  v = (v | (v << 8)) & 0x00F00F00F00Full;
+  v = (v | (v << 4)) & 0x0C30C30C30C3ull;
+  v = (v | (v << 2)) & 0x249249249249ull;
+  return v;
+}
+
+/// The inverse of spreadBitsBy3
+inline std::uint16_t compactBitsBy3(std::uint64_t v) {
+  v &= 0x249249249249ull;
+  v = (v | (v >> 2)) & 0x0C30C30C30C3ull;
+  v = (v | (v >> 4)) & 0x00F00F00F00Full;
+  v = (v | (v >> 8)) & 0x0000FF0000FFull;
+  v = (v | (v >> 16)) & 0x00000000FFFFull;
+  return static_cast<std::uint16_t>(v);
+}
+
+}  // namespace internal
+
+inline OctreeVoxelKey encodeVoxelKey(const OctreeVoxel& voxel) {
+  return internal::spreadBitsBy3(voxel.x()) |
+         (internal::spreadBitsBy3(voxel.y()) << 1) |
+         (internal::spreadBitsBy3(voxel.z()) << 2);
+}
+
+inline OctreeVoxel decodeVoxelKey(OctreeVoxelKey key) {
+  OctreeVoxel voxel;
+  voxel.x() = internal::compactBitsBy3(key);
+  voxel.y() = internal::compactBitsBy3(key >> 1);
+  voxel.z() = internal::compactBitsBy3(key >> 2);
+  return voxel;
+}
+
 template <typename S>
 OctreeTraverseStackElement<S> OctreeTraverseStackElement<S>::MakeRoot(
     const AABB<S>& root_bv) {
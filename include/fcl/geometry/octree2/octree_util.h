@@ -16,6 +16,13 @@ template <typename S>
 void computeChildAABB(const AABB<S>& parent_bv, std::uint8_t child_i,
                       AABB<S>& child_bv);
 
+/// Morton (z-order) key of a bottom voxel, which interleaves the bits of the
+/// voxel coordinate as ...z1y1x1z0y0x0. The ascending order of the keys is
+/// exactly the depth-first order of visiting the children 0 to 7 of each node.
+using OctreeVoxelKey = std::uint64_t;
+inline OctreeVoxelKey encodeVoxelKey(const OctreeVoxel& voxel);
+inline OctreeVoxel decodeVoxelKey(OctreeVoxelKey key);
+
 /// Traversing stack element for visiting a octree
 template <typename S>
 struct OctreeTraverseStackElement {
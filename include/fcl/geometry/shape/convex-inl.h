@@ -39,11 +39,14 @@
 #ifndef FCL_SHAPE_CONVEX_INL_H
 #define FCL_SHAPE_CONVEX_INL_H
 
+#include <algorithm>
+#include <cmath>
 #include <map>
 #include <set>
 #include <utility>
 
 #include "fcl/geometry/shape/convex.h"
+#include "fcl/geometry/shape/convex_support_kernel.h"
 
 namespace fcl {
 
@@ -68,6 +71,7 @@ Convex<S>::Convex(
     sum += vertex;
   }
   interior_point_ = sum * (S)(1.0 / vertices_->size());
+  initVerticesSoA();
   FindVertexNeighbors();
   ValidateMesh(throw_if_invalid);
 }
@@ -112,7 +116,11 @@ const Vector3<S>& Convex<S>::findExtremeVertex(const Vector3<S>& v_C) const {
   // TODO(SeanCurtis-TRI): Create an override of this that seeds the search with
   //  the last extremal vertex index (assuming some kind of coherency in the
   //  evaluation sequence).
-  if (find_extreme_via_neighbors_) {
+  if (find_extreme_via_cubemap_) {
+    const int init_vertex_index = support_cubemap_[findSupportCubemapCell(v_C)];
+    return (*vertices_)[findExtremeVertexIndexViaNeighbours(v_C,
+                                                            init_vertex_index)];
+  } else if (find_extreme_via_neighbors_) {
     return findExtremeVertexViaNeighbours(v_C);
   } else {
     return findExtremeVertexNaive(v_C);
@@ -131,21 +139,31 @@ const Vector3<S>& Convex<S>::findExtremeVertexNaive(
 //==============================================================================
 template <typename S>
 int Convex<S>::findExtremeVertexIndexNaive(const Vector3<S>& v_C) const {
-  const std::vector<Vector3<S>>& vertices = *vertices_;
-  int extreme_index = 0;
-  S extreme_value = v_C.dot(vertices[extreme_index]);
+  // Simple linear search over the SoA vertices, the padded vertices are the
+  // copies of vertex 0 and thus never selected.
+  const S* x = vertices_soa_.data();
+  const S* y = x + vertices_soa_stride_;
+  const S* z = y + vertices_soa_stride_;
+  const int extreme_index =
+      detail::findExtremeIndexSoA(x, y, z, vertices_soa_stride_, v_C);
+  assert(extreme_index < static_cast<int>(vertices_->size()));
+  return extreme_index;
+}
 
-  // Simple linear search.
-  for (int i = 1; i < static_cast<int>(vertices.size()); ++i) {
-    S value = v_C.dot(vertices[i]);
-    if (value > extreme_value) {
-      extreme_index = i;
-      extreme_value = value;
+//==============================================================================
+template <typename S>
+void Convex<S>::initVerticesSoA() {
+  const std::vector<Vector3<S>>& vertices = *vertices_;
+  const int n_vertices = static_cast<int>(vertices.size());
+  constexpr int padding = detail::kConvexSoAPadding;
+  vertices_soa_stride_ = (n_vertices + padding - 1) / padding * padding;
+  vertices_soa_.resize(3 * vertices_soa_stride_);
+  for (int i = 0; i < vertices_soa_stride_; ++i) {
+    const Vector3<S>& vertex = vertices[i < n_vertices ? i : 0];
+    for (int k = 0; k < 3; ++k) {
+      vertices_soa_[k * vertices_soa_stride_ + i] = vertex[k];
     }
   }
-
-  // Done
-  return extreme_index;
 }
 
 //==============================================================================
@@ -224,6 +242,15 @@ const Vector3<S>& Convex<S>::findExtremeVertexViaNeighbours(
 
   // Init is ready
   assert(init_vertex_index >= 0);
+  return (*vertices_)[findExtremeVertexIndexViaNeighbours(v_C,
+                                                          init_vertex_index)];
+}
+
+//==============================================================================
+template <typename S>
+int Convex<S>::findExtremeVertexIndexViaNeighbours(
+    const Vector3<S>& v_C, int init_vertex_index) const {
+  assert(find_extreme_via_neighbors_);
   const std::vector<Vector3<S>>& vertices = *vertices_;
   int extreme_index = init_vertex_index;
   S extreme_value = v_C.dot(vertices[extreme_index]);
@@ -278,7 +305,61 @@ const Vector3<S>& Convex<S>::findExtremeVertexViaNeighbours(
   }
 
   // Done
-  return vertices[extreme_index];
+  return extreme_index;
+}
+
+//==============================================================================
+template <typename S>
+int Convex<S>::findSupportCubemapCell(const Vector3<S>& v_C) const {
+  constexpr int resolution = kSupportCubemapResolution;
+  int axis = 0;
+  if (std::abs(v_C[1]) > std::abs(v_C[axis])) axis = 1;
+  if (std::abs(v_C[2]) > std::abs(v_C[axis])) axis = 2;
+  const S major = std::abs(v_C[axis]);
+  const int face = 2 * axis + (v_C[axis] < 0 ? 1 : 0);
+  if (!(major > 0)) return face * resolution * resolution;
+
+  // The other two coordinates projected onto the face, in [-1, 1]
+  auto to_cell = [&](int coordinate) -> int {
+    const S u = v_C[coordinate] / major;
+    const int cell = static_cast<int>((u + S(1)) * S(0.5 * resolution));
+    return std::min(std::max(cell, 0), resolution - 1);
+  };
+  const int i = to_cell((axis + 1) % 3);
+  const int j = to_cell((axis + 2) % 3);
+  return (face * resolution + i) * resolution + j;
+}
+
+//==============================================================================
+template <typename S>
+void Convex<S>::initSupportCubemap() {
+  assert(find_extreme_via_neighbors_);
+  constexpr int resolution = kSupportCubemapResolution;
+  support_cubemap_.resize(6 * resolution * resolution);
+  for (int face = 0; face < 6; face++) {
+    const int axis = face / 2;
+    const S sign = (face % 2 == 0) ? S(1) : S(-1);
+
+    // Walk from the support of the axis, then from the previous cell
+    Vector3<S> axis_direction = Vector3<S>::Zero();
+    axis_direction[axis] = sign;
+    int init_vertex_index = findExtremeVertexIndexNaive(axis_direction);
+    for (int i = 0; i < resolution; i++) {
+      for (int j = 0; j < resolution; j++) {
+        // The center direction of this cell
+        Vector3<S> direction;
+        direction[axis] = sign;
+        direction[(axis + 1) % 3] = S(2 * i + 1) / S(resolution) - S(1);
+        direction[(axis + 2) % 3] = S(2 * j + 1) / S(resolution) - S(1);
+        const int cell = (face * resolution + i) * resolution + j;
+        assert(findSupportCubemapCell(direction) == cell);
+        init_vertex_index =
+            findExtremeVertexIndexViaNeighbours(direction, init_vertex_index);
+        support_cubemap_[cell] = init_vertex_index;
+      }
+    }
+  }
+  find_extreme_via_cubemap_ = true;
 }
 
 //==============================================================================
@@ -371,6 +452,9 @@ void Convex<S>::ValidateTopology(bool throw_on_error) {
   // Init the cache for findExtreme
   if (find_extreme_via_neighbors_) {
     initExtremeViaNeighborCache();
+    if (static_cast<int>(vertices_->size()) > kMinVertCountForSupportCubemap) {
+      initSupportCubemap();
+    }
   }
 }
 
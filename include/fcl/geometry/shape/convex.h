@@ -253,10 +253,39 @@ class Convex : public ShapeBase<S_> {
   const Vector3<S>& findExtremeVertexViaNeighbours(const Vector3<S>& v_C) const;
   int findExtremeVertexIndexNaive(const Vector3<S>& v_C) const;
 
+  // The padded SoA copy of the vertices for findExtremeVertexIndexNaive(),
+  // which is [x..., y..., z...] with vertices_soa_stride_ entries each. See
+  // convex_support_kernel.h for the layout and the SIMD kernels.
+  std::vector<S> vertices_soa_;
+  int vertices_soa_stride_{0};
+  void initVerticesSoA();
+
+  // Walk the edges from init_vertex_index until no neighbor is more extreme
+  // in the direction v_C. Requires find_extreme_via_neighbors_.
+  int findExtremeVertexIndexViaNeighbours(const Vector3<S>& v_C,
+                                          int init_vertex_index) const;
+
+  // For a large convex, the hill-climbing from the 6 axis directions above
+  // still walks a long path. Thus, we precompute the support vertex of the
+  // center direction of each cell in a cube map of directions. The cell
+  // (face, i, j) is at support_cubemap_[(face * R + i) * R + j], where R is
+  // kSupportCubemapResolution and face is 2 * axis (+1 for the negative
+  // side of the axis). The walk from the vertex of the cell of v_C is
+  // usually only a few edges.
+  bool find_extreme_via_cubemap_{false};
+  std::vector<int> support_cubemap_;
+  void initSupportCubemap();
+  int findSupportCubemapCell(const Vector3<S>& v_C) const;
+
   // Empirical evidence suggests that finding the extreme vertex by walking the
   // edges of the mesh is only more efficient if there are more than 32
   // vertices.
   static constexpr int kMinVertCountForEdgeWalking = 32;
+
+  // The cube map is only used (and built) for convex with more vertices than
+  // this, as the cache misses of the map do not pay off for smaller ones.
+  static constexpr int kMinVertCountForSupportCubemap = 256;
+  static constexpr int kSupportCubemapResolution = 16;
 };
 
 // Workaround for https://gcc.gnu.org/bugzilla/show_bug.cgi?id=57728 which
@@ -0,0 +1,231 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+#include "fcl/common/types.h"
+#include "fcl/math/math_simd_details.h"
+
+namespace fcl {
+namespace detail {
+
+/// The vertices of a convex in the SoA layout: x[i], y[i], z[i] of the ith
+/// vertex, where the arrays are padded to a multiple of kConvexSoAPadding
+/// with copies of the vertex 0. Thus, the padded lanes never change the
+/// extreme vertex found by the kernels below. The padding is the number of
+/// vertices processed by one iteration of the kernels.
+#if defined(FCL_SSE_ENABLED) && defined(__AVX__)
+constexpr int kConvexSoAPadding = 8;
+#else
+constexpr int kConvexSoAPadding = 4;
+#endif
+
+/// Return the index of the first vertex i that maximizes
+/// v.dot(Vector3(x[i], y[i], z[i])) in [0, n_padded), which is the same as
+/// the linear search over the vertices. n_padded must be a multiple of
+/// kConvexSoAPadding.
+template <typename S>
+int findExtremeIndexSoA(const S* x, const S* y, const S* z, int n_padded,
+                        const Vector3<S>& v) {
+  int extreme_index = 0;
+  S extreme_value = v[0] * x[0] + v[1] * y[0] + v[2] * z[0];
+  for (int i = 1; i < n_padded; ++i) {
+    const S value = v[0] * x[i] + v[1] * y[i] + v[2] * z[i];
+    if (value > extreme_value) {
+      extreme_index = i;
+      extreme_value = value;
+    }
+  }
+  return extreme_index;
+}
+
+#ifdef FCL_SSE_ENABLED
+namespace internal {
+
+/// The first index of the maximum value in the lanes, without branches
+inline int reduceExtremeLanes(__m128 value, __m128 index) {
+  __m128 max_value =
+      _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+  max_value = _mm_max_ps(
+      max_value, _mm_shuffle_ps(max_value, max_value, _MM_SHUFFLE(1, 0, 3, 2)));
+  const __m128 is_max = _mm_cmpeq_ps(value, max_value);
+  const __m128 invalid_index = _mm_set1_ps(std::numeric_limits<float>::max());
+  __m128 min_index = _mm_or_ps(_mm_and_ps(is_max, index),
+                               _mm_andnot_ps(is_max, invalid_index));
+  min_index = _mm_min_ps(min_index, _mm_shuffle_ps(min_index, min_index,
+                                                   _MM_SHUFFLE(2, 3, 0, 1)));
+  min_index = _mm_min_ps(min_index, _mm_shuffle_ps(min_index, min_index,
+                                                   _MM_SHUFFLE(1, 0, 3, 2)));
+  return static_cast<int>(_mm_cvtss_f32(min_index));
+}
+
+inline int reduceExtremeLanes(__m128d value, __m128d index) {
+  const __m128d max_value = _mm_max_pd(value, _mm_shuffle_pd(value, value, 1));
+  const __m128d is_max = _mm_cmpeq_pd(value, max_value);
+  const __m128d invalid_index = _mm_set1_pd(std::numeric_limits<double>::max());
+  __m128d min_index = _mm_or_pd(_mm_and_pd(is_max, index),
+                                _mm_andnot_pd(is_max, invalid_index));
+  min_index = _mm_min_pd(min_index, _mm_shuffle_pd(min_index, min_index, 1));
+  return static_cast<int>(_mm_cvtsd_f64(min_index));
+}
+
+#if defined(__AVX__)
+/// Merge the upper half into the lower half, then reduce as above
+inline int reduceExtremeLanes(__m256 value, __m256 index) {
+  const __m128 value_low = _mm256_castps256_ps128(value);
+  const __m128 value_high = _mm256_extractf128_ps(value, 1);
+  const __m128 index_low = _mm256_castps256_ps128(index);
+  const __m128 index_high = _mm256_extractf128_ps(index, 1);
+  const __m128 take_high = _mm_or_ps(
+      _mm_cmpgt_ps(value_high, value_low),
+      _mm_and_ps(_mm_cmpeq_ps(value_high, value_low),
+                 _mm_cmplt_ps(index_high, index_low)));
+  return reduceExtremeLanes(_mm_blendv_ps(value_low, value_high, take_high),
+                            _mm_blendv_ps(index_low, index_high, take_high));
+}
+
+inline int reduceExtremeLanes(__m256d value, __m256d index) {
+  const __m128d value_low = _mm256_castpd256_pd128(value);
+  const __m128d value_high = _mm256_extractf128_pd(value, 1);
+  const __m128d index_low = _mm256_castpd256_pd128(index);
+  const __m128d index_high = _mm256_extractf128_pd(index, 1);
+  const __m128d take_high = _mm_or_pd(
+      _mm_cmpgt_pd(value_high, value_low),
+      _mm_and_pd(_mm_cmpeq_pd(value_high, value_low),
+                 _mm_cmplt_pd(index_high, index_low)));
+  return reduceExtremeLanes(_mm_blendv_pd(value_low, value_high, take_high),
+                            _mm_blendv_pd(index_low, index_high, take_high));
+}
+#endif
+
+}  // namespace internal
+
+/// The float version. The indices are kept in float lanes, which are exact
+/// for less than 2^24 vertices.
+inline int findExtremeIndexSoA(const float* x, const float* y, const float* z,
+                               int n_padded, const Vector3<float>& v) {
+  if (n_padded > (1 << 24)) {
+    return findExtremeIndexSoA<float>(x, y, z, n_padded, v);
+  }
+
+#if defined(__AVX__)
+  const __m256 vx = _mm256_set1_ps(v[0]);
+  const __m256 vy = _mm256_set1_ps(v[1]);
+  const __m256 vz = _mm256_set1_ps(v[2]);
+  const __m256 step = _mm256_set1_ps(8.0f);
+  __m256 index = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+  __m256 extreme_value = _mm256_set1_ps(-std::numeric_limits<float>::max());
+  __m256 extreme_index = index;
+  for (int i = 0; i < n_padded; i += 8) {
+    const __m256 value = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(vx, _mm256_loadu_ps(x + i)),
+                      _mm256_mul_ps(vy, _mm256_loadu_ps(y + i))),
+        _mm256_mul_ps(vz, _mm256_loadu_ps(z + i)));
+    const __m256 greater = _mm256_cmp_ps(value, extreme_value, _CMP_GT_OQ);
+    extreme_value = _mm256_blendv_ps(extreme_value, value, greater);
+    extreme_index = _mm256_blendv_ps(extreme_index, index, greater);
+    index = _mm256_add_ps(index, step);
+  }
+  return internal::reduceExtremeLanes(extreme_value, extreme_index);
+#else
+  const __m128 vx = _mm_set1_ps(v[0]);
+  const __m128 vy = _mm_set1_ps(v[1]);
+  const __m128 vz = _mm_set1_ps(v[2]);
+  const __m128 step = _mm_set1_ps(4.0f);
+  __m128 index = _mm_setr_ps(0, 1, 2, 3);
+  __m128 extreme_value = _mm_set1_ps(-std::numeric_limits<float>::max());
+  __m128 extreme_index = index;
+  for (int i = 0; i < n_padded; i += 4) {
+    const __m128 value =
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_loadu_ps(x + i)),
+                              _mm_mul_ps(vy, _mm_loadu_ps(y + i))),
+                   _mm_mul_ps(vz, _mm_loadu_ps(z + i)));
+    // SSE2 has no blend, select by and/andnot/or
+    const __m128 greater = _mm_cmpgt_ps(value, extreme_value);
+    extreme_value = _mm_or_ps(_mm_and_ps(greater, value),
+                              _mm_andnot_ps(greater, extreme_value));
+    extreme_index = _mm_or_ps(_mm_and_ps(greater, index),
+                              _mm_andnot_ps(greater, extreme_index));
+    index = _mm_add_ps(index, step);
+  }
+  return internal::reduceExtremeLanes(extreme_value, extreme_index);
+#endif
+}
+
+/// The double version, the indices are kept in double lanes
+inline int findExtremeIndexSoA(const double* x, const double* y,
+                               const double* z, int n_padded,
+                               const Vector3<double>& v) {
+#if defined(__AVX__)
+  const __m256d vx = _mm256_set1_pd(v[0]);
+  const __m256d vy = _mm256_set1_pd(v[1]);
+  const __m256d vz = _mm256_set1_pd(v[2]);
+  const __m256d step = _mm256_set1_pd(4.0);
+  __m256d index = _mm256_setr_pd(0, 1, 2, 3);
+  __m256d extreme_value = _mm256_set1_pd(-std::numeric_limits<double>::max());
+  __m256d extreme_index = index;
+  for (int i = 0; i < n_padded; i += 4) {
+    const __m256d value = _mm256_add_pd(
+        _mm256_add_pd(_mm256_mul_pd(vx, _mm256_loadu_pd(x + i)),
+                      _mm256_mul_pd(vy, _mm256_loadu_pd(y + i))),
+        _mm256_mul_pd(vz, _mm256_loadu_pd(z + i)));
+    const __m256d greater = _mm256_cmp_pd(value, extreme_value, _CMP_GT_OQ);
+    extreme_value = _mm256_blendv_pd(extreme_value, value, greater);
+    extreme_index = _mm256_blendv_pd(extreme_index, index, greater);
+    index = _mm256_add_pd(index, step);
+  }
+  return internal::reduceExtremeLanes(extreme_value, extreme_index);
+#else
+  // Two vertices per register are too few to hide the latency, thus we keep
+  // two independent accumulators for the vertices i, i+1 and i+2, i+3
+  const __m128d vx = _mm_set1_pd(v[0]);
+  const __m128d vy = _mm_set1_pd(v[1]);
+  const __m128d vz = _mm_set1_pd(v[2]);
+  const __m128d step = _mm_set1_pd(4.0);
+  __m128d index_0 = _mm_setr_pd(0, 1);
+  __m128d index_1 = _mm_setr_pd(2, 3);
+  __m128d extreme_value_0 = _mm_set1_pd(-std::numeric_limits<double>::max());
+  __m128d extreme_value_1 = extreme_value_0;
+  __m128d extreme_index_0 = index_0;
+  __m128d extreme_index_1 = index_1;
+  auto update = [&](int i, const __m128d& index, __m128d& extreme_value,
+                    __m128d& extreme_index) {
+    const __m128d value =
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(vx, _mm_loadu_pd(x + i)),
+                              _mm_mul_pd(vy, _mm_loadu_pd(y + i))),
+                   _mm_mul_pd(vz, _mm_loadu_pd(z + i)));
+    const __m128d greater = _mm_cmpgt_pd(value, extreme_value);
+    extreme_value = _mm_or_pd(_mm_and_pd(greater, value),
+                              _mm_andnot_pd(greater, extreme_value));
+    extreme_index = _mm_or_pd(_mm_and_pd(greater, index),
+                              _mm_andnot_pd(greater, extreme_index));
+  };
+  for (int i = 0; i < n_padded; i += 4) {
+    update(i, index_0, extreme_value_0, extreme_index_0);
+    update(i + 2, index_1, extreme_value_1, extreme_index_1);
+    index_0 = _mm_add_pd(index_0, step);
+    index_1 = _mm_add_pd(index_1, step);
+  }
+
+  // Merge the second accumulator into the first one
+  const __m128d take_1 = _mm_or_pd(
+      _mm_cmpgt_pd(extreme_value_1, extreme_value_0),
+      _mm_and_pd(_mm_cmpeq_pd(extreme_value_1, extreme_value_0),
+                 _mm_cmplt_pd(extreme_index_1, extreme_index_0)));
+  const __m128d extreme_value =
+      _mm_or_pd(_mm_and_pd(take_1, extreme_value_1),
+                _mm_andnot_pd(take_1, extreme_value_0));
+  const __m128d extreme_index =
+      _mm_or_pd(_mm_and_pd(take_1, extreme_index_1),
+                _mm_andnot_pd(take_1, extreme_index_0));
+  return internal::reduceExtremeLanes(extreme_value, extreme_index);
+#endif
+}
+#endif
+
+}  // namespace detail
+}  // namespace fcl
@@ -827,6 +827,31 @@ void computeBV(const Shape& s, const Transform3<typename BV::S>& tf, BV& bv) {
   detail::ComputeBVImpl<S, BV, Shape>::run(s, tf, bv);
 }
 
+//==============================================================================
+template <typename BV, typename Shape>
+void computeBVWithMargin(const Shape& s, const Transform3<typename BV::S>& tf,
+                         typename BV::S margin, BV& bv) {
+  using S = typename BV::S;
+  const NODE_TYPE node_type = s.getNodeType();
+  if (margin <= S(0) || node_type == GEOM_HALFSPACE ||
+      node_type == GEOM_PLANE) {
+    computeBV(s, tf, bv);
+    return;
+  }
+
+  OBB<S> obb;
+  computeBV(s, tf, obb);
+  obb.extent.array() += margin;
+  Vector3<S> corners[8];
+  for (int i = 0; i < 8; i++) {
+    const Vector3<S> corner_in_obb((i & 1) ? obb.extent[0] : -obb.extent[0],
+                                   (i & 2) ? obb.extent[1] : -obb.extent[1],
+                                   (i & 4) ? obb.extent[2] : -obb.extent[2]);
+    corners[i] = obb.To + obb.axis * corner_in_obb;
+  }
+  fit(corners, 8, bv);
+}
+
 //==============================================================================
 template <typename S>
 void constructBox(const AABB<S>& bv, Box<S>& box, Transform3<S>& tf) {
@@ -56,6 +56,14 @@ namespace fcl {
 template <typename BV, typename Shape>
 void computeBV(const Shape& s, const Transform3<typename BV::S>& tf, BV& bv);
 
+/// @brief calculate a bounding volume for the shape inflated by margin (its
+/// Minkowski sum with a ball of radius margin), which is fit to the corners
+/// of the inflated OBB of the shape. The unbounded shapes (halfspace and
+/// plane) use the bounding volume of computeBV().
+template <typename BV, typename Shape>
+void computeBVWithMargin(const Shape& s, const Transform3<typename BV::S>& tf,
+                         typename BV::S margin, BV& bv);
+
 /// @brief construct a box shape (with a configuration) from a given bounding
 /// volume
 template <typename S>
@@ -12,5 +12,6 @@
 #include "fcl/math/math_simd_details.h"
 #include "fcl/math/rng.h"
 #include "fcl/math/mesh_simplex.h"
+#include "fcl/math/pinhole_camera.h"
 #include "fcl/math/variance3.h"
 #include "fcl/math/fixed_rotation_obb_disjoint.h"
\ No newline at end of file
@@ -0,0 +1,36 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include "fcl/common/types.h"
+
+namespace fcl {
+
+/// Intrinsic parameters of a pinhole camera. The camera frame follows the
+/// usual image convention: x points to the right (increasing column), y
+/// points downward (increasing row) and z is the viewing direction. The pixel
+/// (u, v) = (col, row) is centered at its integer coordinate.
+template <typename S>
+struct PinholeCameraIntrinsic {
+  S fx{1};
+  S fy{1};
+  S cx{0};
+  S cy{0};
+  int width{0};
+  int height{0};
+
+  /// The un-normalized viewing direction of a pixel with z == 1.
+  /// Multiplying it with the depth of the pixel gives the 3d point in
+  /// camera frame.
+  inline Vector3<S> pixelToRayDirection(S u, S v) const {
+    return Vector3<S>((u - cx) / fx, (v - cy) / fy, S(1.0));
+  }
+
+  inline std::size_t n_pixels() const {
+    return static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+  }
+};
+
+}  // namespace fcl
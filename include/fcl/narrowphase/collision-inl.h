@@ -75,6 +75,17 @@ std::size_t collide(const CollisionGeometry<S>* o1, const Transform3<S>& tf1,
     return 0;
   }
 
+  // The safety margin is only supported by the pairs with a primitive shape
+  if (request.binaryCollisionMargin() > 0 &&
+      o1->getObjectType() != OT_GEOM && o2->getObjectType() != OT_GEOM) {
+    std::cerr << "Warning: safety margin between node type "
+              << o1->getNodeType() << " and node type " << o2->getNodeType()
+              << " is not supported and ignored\n";
+    CollisionRequest<S> request_no_margin = request;
+    request_no_margin.setSafetyMargin(0);
+    return collide(o1, tf1, o2, tf2, nsolver, request_no_margin, result);
+  }
+
   const auto& looktable = getCollisionFunctionLookTable<S>();
 
   std::size_t res{0};
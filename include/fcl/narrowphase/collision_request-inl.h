@@ -55,7 +55,8 @@ CollisionRequest<S>::CollisionRequest(std::size_t n_max_contacts)
     : num_max_contacts_(n_max_contacts),
       penetration_mode_(detail::CollisionPenetrationType::Disabled),
       binary_collision_tolerance_(Real(1e-6)),
-      distance_tolerance_(Real(1e-6)) {
+      distance_tolerance_(Real(1e-6)),
+      safety_margin_(Real(0)) {
   // Do nothing
 }
 
@@ -137,6 +138,20 @@ void CollisionRequest<S>::setPenetrationDistanceTolerance(Real tolerance) {
   distance_tolerance_ = tolerance;
 }
 
+//==============================================================================
+template <typename S>
+void CollisionRequest<S>::setSafetyMargin(Real margin) {
+  safety_margin_ = margin;
+}
+
+//==============================================================================
+template <typename S>
+typename CollisionRequest<S>::Real CollisionRequest<S>::binaryCollisionMargin()
+    const {
+  if (isPenetrationEnabled() || safety_margin_ <= Real(0)) return Real(0);
+  return safety_margin_;
+}
+
 //==============================================================================
 template <typename S>
 bool CollisionRequest<S>::terminationConditionSatisfied(
@@ -65,6 +65,9 @@ struct CollisionRequest {
   Real binary_collision_tolerance_{1e-6};
   Real distance_tolerance_{1e-6};
 
+  /// @brief The safety margin of the binary collision, see setSafetyMargin()
+  Real safety_margin_{0};
+
  public:
   /// @brief Default constructor
   explicit CollisionRequest();
@@ -90,6 +93,21 @@ struct CollisionRequest {
   Real binaryCollisionTolerance() const { return binary_collision_tolerance_; };
   Real distanceTolerance() const { return distance_tolerance_; }
 
+  /// @brief Safety margin of the binary collision (penetration disabled). If
+  /// it is positive, a pair is reported as colliding iff the distance between
+  /// them is less than the margin, without inflated copies of the geometries.
+  /// The leaf pairs are tested by GJK with the margin, and the bounding
+  /// volumes of the shape are inflated by the margin during the traversal.
+  /// It is supported by the pairs with at least one primitive shape (shape
+  /// vs shape/BVH/octree2/heightmap), and ignored by the other pairs. It is
+  /// also ignored when the penetration is enabled.
+  void setSafetyMargin(Real margin);
+  Real safetyMargin() const { return safety_margin_; }
+
+  /// @brief The margin used by the narrowphase, which is zero if the
+  /// penetration is enabled
+  Real binaryCollisionMargin() const;
+
   /// Whether the termination condition is meet
   bool terminationConditionSatisfied(const CollisionResult<S>& result) const;
 };
@@ -39,6 +39,8 @@
 #define FCL_NARROWPHASE_GJKSOLVERINDEP_INL_H
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 #include "fcl/common/unused.h"
 #include "fcl/cvx_collide/epa.h"
@@ -66,28 +68,207 @@ namespace detail {
 // Global compute option
 constexpr bool use_mpr_if_no_contact = true;
 
+//==============================================================================
+// The binary intersection by MPR, which is warm started from (and updates)
+// the portal of the pair if warm_start is not nullptr
+template <typename S, typename MinkowskiDiffT>
+typename MPR<S>::IntersectStatus mprIntersectWithWarmStart(
+    const GJKSolver<S>& gjk_solver, const MinkowskiDiffT& shape,
+    GJKWarmStart<S>* warm_start) {
+  MPR<S> mpr(gjk_solver.gjk_max_iterations, gjk_solver.gjk_tolerance);
+  if (warm_start == nullptr) return mpr.Intersect(shape);
+
+  using IntersectData = typename MPR<S>::IntersectData;
+  IntersectData data;
+  Vector3<S>* portal_direction[3] = {&data.v1_dir_in_support,
+                                     &data.v2_dir_in_support,
+                                     &data.v3_dir_in_support};
+  typename MPR<S>::IntersectStatus status;
+  if (warm_start->is_mpr_portal_valid) {
+    for (int i = 0; i < 3; i++)
+      *portal_direction[i] = warm_start->mpr_portal_direction[i];
+    status = mpr.IntersectWarmStart(shape, data);
+  } else {
+    // The directions not reached by MPR remain NaN
+    for (int i = 0; i < 3; i++)
+      portal_direction[i]->setConstant(std::numeric_limits<S>::quiet_NaN());
+    status = mpr.Intersect(shape, &data);
+  }
+
+  // Keep the portal for the next query
+  bool is_portal_valid = true;
+  for (int i = 0; i < 3; i++)
+    is_portal_valid = is_portal_valid && portal_direction[i]->allFinite();
+  if (is_portal_valid) {
+    for (int i = 0; i < 3; i++)
+      warm_start->mpr_portal_direction[i] = *portal_direction[i];
+  }
+  warm_start->is_mpr_portal_valid = is_portal_valid;
+  return status;
+}
+
+// The GJK evaluation, the initial direction is the separating direction of
+// the last query of the pair if it is available, otherwise the gjk_guess
+template <typename S, typename MinkowskiDiffT>
+GJK_Status gjkEvaluateWithWarmStart(const GJKSolver<S>& gjk_solver,
+                                    const MinkowskiDiffT& shape,
+                                    GJKSimplex<S>& simplex,
+                                    GJKWarmStart<S>* warm_start) {
+  Vector3<S> direction(-1, 0, 0);
+  if (warm_start != nullptr && warm_start->is_gjk_direction_valid)
+    direction = warm_start->gjk_direction;
+  else if (gjk_solver.is_gjk_guess_valid)
+    direction = -gjk_solver.gjk_guess;
+
+  GJK2<S> gjk2(gjk_solver.gjk_max_iterations, gjk_solver.gjk_tolerance);
+  const GJK_Status status = gjk2.Evaluate(shape, simplex, direction);
+  if (warm_start != nullptr && status == GJK_Status::Separated) {
+    warm_start->is_gjk_direction_valid = true;
+    warm_start->gjk_direction = simplex.separating_direction;
+  }
+  return status;
+}
+
+//==============================================================================
+// The float shape type of the basic shapes in double, whose GJKGeometryData
+// is described by vec3_data only (without user_ptr)
+template <typename S, typename Shape>
+struct FloatGJKShape : std::false_type {};
+template <>
+struct FloatGJKShape<double, Box<double>> : std::true_type {
+  using type = Box<float>;
+};
+template <>
+struct FloatGJKShape<double, Sphere<double>> : std::true_type {
+  using type = Sphere<float>;
+};
+template <>
+struct FloatGJKShape<double, Ellipsoid<double>> : std::true_type {
+  using type = Ellipsoid<float>;
+};
+template <>
+struct FloatGJKShape<double, Capsule<double>> : std::true_type {
+  using type = Capsule<float>;
+};
+template <>
+struct FloatGJKShape<double, Cone<double>> : std::true_type {
+  using type = Cone<float>;
+};
+template <>
+struct FloatGJKShape<double, Cylinder<double>> : std::true_type {
+  using type = Cylinder<float>;
+};
+
+// The distance of a GJK result to the decision boundary, which is the
+// separation certified by the separating direction, or the distance from the
+// origin to the boundary of the simplex that encloses it. Zero if the simplex
+// is not a tetrahedron.
+template <typename T, typename MinkowskiDiffT>
+T gjkDecisionMargin(const MinkowskiDiffT& shape, const GJKSimplex<T>& simplex,
+                    GJK_Status status) {
+  if (status == GJK_Status::Separated) {
+    const Vector3<T>& direction = simplex.separating_direction;
+    const T direction_norm = direction.norm();
+    if (direction_norm <= 0) return 0;
+    return -shape.support(direction).dot(direction) / direction_norm;
+  } else if (status != GJK_Status::Intersect || simplex.n_vertices() != 4) {
+    return 0;
+  }
+
+  constexpr int kFaces[4][3] = {{0, 1, 2}, {0, 1, 3}, {0, 2, 3}, {1, 2, 3}};
+  T depth = std::numeric_limits<T>::max();
+  for (const auto& face : kFaces) {
+    const Vector3<T>& a = simplex.vertices[face[0]].vertex;
+    const Vector3<T>& b = simplex.vertices[face[1]].vertex;
+    const Vector3<T>& c = simplex.vertices[face[2]].vertex;
+    const Vector3<T> normal = (b - a).cross(c - a);
+    const T normal_norm = normal.norm();
+    if (normal_norm <= 0) return 0;
+    depth = std::min(depth, std::abs(normal.dot(a)) / normal_norm);
+  }
+  return depth;
+}
+
+// The binary intersection by the float GJK, which returns false if the
+// result is within mixed_precision_band of the decision boundary (or the
+// pair is not supported) and the query should be evaluated in S
+template <typename S, typename Shape1, typename Shape2,
+          bool = FloatGJKShape<S, Shape1>::value &&
+                 FloatGJKShape<S, Shape2>::value>
+struct ShapeIntersectMixedPrecisionImpl {
+  static bool run(const GJKSolver<S>& /*gjk_solver*/, const Shape1& /*s1*/,
+                  const Transform3<S>& /*tf1*/, const Shape2& /*s2*/,
+                  const Transform3<S>& /*tf2*/, bool& /*intersect*/) {
+    return false;
+  }
+};
+
+template <typename S, typename Shape1, typename Shape2>
+struct ShapeIntersectMixedPrecisionImpl<S, Shape1, Shape2, true> {
+  static bool run(const GJKSolver<S>& gjk_solver, const Shape1& s1,
+                  const Transform3<S>& tf1, const Shape2& s2,
+                  const Transform3<S>& tf2, bool& intersect) {
+    using FloatShape1 = typename FloatGJKShape<S, Shape1>::type;
+    using FloatShape2 = typename FloatGJKShape<S, Shape2>::type;
+    const GJKGeometryData<S> geometry1 = constructGJKGeometry(&s1);
+    const GJKGeometryData<S> geometry2 = constructGJKGeometry(&s2);
+    ShapeMinkowskiDiff<float, FloatShape1, FloatShape2> shape;
+    shape.shapes[0] = GJKGeometryData<float>(
+        geometry1.shape_type, geometry1.vec3_data.template cast<float>());
+    shape.shapes[1] = GJKGeometryData<float>(
+        geometry2.shape_type, geometry2.vec3_data.template cast<float>());
+    shape.toshape1 =
+        (tf2.linear().transpose() * tf1.linear()).template cast<float>();
+    shape.toshape0 = (tf1.inverse(Eigen::Isometry) * tf2).template cast<float>();
+
+    Vector3<float> direction(-1, 0, 0);
+    if (gjk_solver.is_gjk_guess_valid)
+      direction = -gjk_solver.gjk_guess.template cast<float>();
+    GJK2<float> gjk2(gjk_solver.gjk_max_iterations,
+                     static_cast<float>(gjk_solver.gjk_tolerance));
+    GJKSimplex<float> gjk_simplex;
+    const GJK_Status status = gjk2.Evaluate(shape, gjk_simplex, direction);
+    const float decision_margin = gjkDecisionMargin(shape, gjk_simplex, status);
+    const bool is_certified =
+        decision_margin > static_cast<float>(gjk_solver.mixed_precision_band);
+
+    MixedPrecisionCounters* counters = gjk_solver.mixed_precision_counters;
+    if (counters != nullptr) {
+      counters->n_float_queries++;
+      if (!is_certified) counters->n_double_fallbacks++;
+    }
+    if (is_certified) intersect = (status == GJK_Status::Intersect);
+    return is_certified;
+  }
+};
+
 //==============================================================================
 template <typename S, typename Shape1, typename Shape2>
 struct ShapeIntersectIndepImpl {
   static bool run(const GJKSolver<S>& gjk_solver, const Shape1& s1,
                   const Transform3<S>& tf1, const Shape2& s2,
                   const Transform3<S>& tf2,
-                  CollisionPenetrationContactData<S>* contacts) {
+                  CollisionPenetrationContactData<S>* contacts,
+                  GJKWarmStart<S>* warm_start) {
+    // The float GJK first, the warm start is not updated if it is certified
+    bool intersect_in_float = false;
+    if (gjk_solver.use_mixed_precision && contacts == nullptr &&
+        ShapeIntersectMixedPrecisionImpl<S, Shape1, Shape2>::run(
+            gjk_solver, s1, tf1, s2, tf2, intersect_in_float)) {
+      return intersect_in_float;
+    }
+
     // Construct the shape
-    Vector3<S> guess(1, 0, 0);
-    if (gjk_solver.is_gjk_guess_valid) guess = gjk_solver.gjk_guess;
-    MinkowskiDiff<S> shape;
+    ShapeMinkowskiDiff<S, Shape1, Shape2> shape;
     shape.shapes[0] = constructGJKGeometry(&s1);
     shape.shapes[1] = constructGJKGeometry(&s2);
-    shape.support_function = computeSupport<S>;
-    shape.interior_function = computeInterior<S>;
     shape.toshape1.noalias() = tf2.linear().transpose() * tf1.linear();
     shape.toshape0 = tf1.inverse(Eigen::Isometry) * tf2;
 
     // Use mpr if no contact required
     if (use_mpr_if_no_contact && (contacts == nullptr)) {
-      MPR<S> mpr(gjk_solver.gjk_max_iterations, gjk_solver.gjk_tolerance);
-      auto mpr_result = mpr.Intersect(shape);
+      auto mpr_result =
+          mprIntersectWithWarmStart(gjk_solver, shape, warm_start);
 
       // Check the result
       if (mpr_result == MPR<S>::IntersectStatus::Intersect) {
@@ -98,9 +279,9 @@ struct ShapeIntersectIndepImpl {
     }
 
     // Check can we use GJK only
-    GJK2<S> gjk2(gjk_solver.gjk_max_iterations, gjk_solver.gjk_tolerance);
     GJKSimplex<S> gjk_simplex;
-    auto gjk_result = gjk2.Evaluate(shape, gjk_simplex, -guess);
+    auto gjk_result =
+        gjkEvaluateWithWarmStart(gjk_solver, shape, gjk_simplex, warm_start);
     if (contacts == nullptr) {
       return gjk_result == GJK_Status::Intersect;
     }
@@ -113,7 +294,8 @@ struct ShapeIntersectIndepImpl {
       S epa_depth{0};
       Vector3<S> p_on_1, p_on_2;
       auto epa_status_out =
-          epa2.Evaluate(gjk_simplex, shape, &epa_depth, &p_on_1, &p_on_2);
+          epa2.Evaluate(gjk_simplex, shape, &epa_depth, &p_on_1, &p_on_2,
+                        gjk_solver.epaPolytopeCache());
       if (epa_status_out != EPA_Status::Failed) {
         Vector3<S> normal_in_1 = p_on_1 - p_on_2;
         if (normal_in_1.squaredNorm() <= 0)
@@ -141,10 +323,247 @@ template <typename S>
 template <typename Shape1, typename Shape2>
 bool GJKSolver<S>::shapeIntersect(
     const Shape1& s1, const Transform3<S>& tf1, const Shape2& s2,
-    const Transform3<S>& tf2,
-    CollisionPenetrationContactData<S>* contacts) const {
-  return ShapeIntersectIndepImpl<S, Shape1, Shape2>::run(*this, s1, tf1, s2,
-                                                         tf2, contacts);
+    const Transform3<S>& tf2, CollisionPenetrationContactData<S>* contacts,
+    GJKWarmStart<S>* warm_start) const {
+  return ShapeIntersectIndepImpl<S, Shape1, Shape2>::run(
+      *this, s1, tf1, s2, tf2, contacts, warm_start);
+}
+
+//==============================================================================
+template <typename S>
+constexpr std::size_t GJKSolver<S>::kShapeIntersectBatchSize;
+
+template <typename S, typename Shape1, typename Shape2>
+void shapeIntersectBatchImpl(const GJKSolver<S>& gjk_solver, const Shape1* s1,
+                             const Transform3<S>* tf1, const Shape2& s2,
+                             const Transform3<S>& tf2, std::size_t n,
+                             bool* intersect, std::false_type) {
+  for (std::size_t i = 0; i < n; i++) {
+    intersect[i] = ShapeIntersectIndepImpl<S, Shape1, Shape2>::run(
+        gjk_solver, s1[i], tf1[i], s2, tf2, nullptr, nullptr);
+  }
+}
+
+template <typename S, typename Shape1, typename Shape2>
+void shapeIntersectBatchImpl(const GJKSolver<S>& gjk_solver, const Shape1* s1,
+                             const Transform3<S>* tf1, const Shape2& s2,
+                             const Transform3<S>& tf2, std::size_t n,
+                             bool* intersect, std::true_type) {
+  constexpr std::size_t kBatchSize = GJKSolver<S>::kShapeIntersectBatchSize;
+  constexpr std::size_t kBatchLanes = 8;
+  using BatchSolver = MPRBatch<S, kBatchLanes>;
+  using IntersectStatus = typename BatchSolver::IntersectStatus;
+  BatchSolver mpr_batch(gjk_solver.gjk_max_iterations,
+                        gjk_solver.gjk_tolerance);
+  ShapeMinkowskiDiff<S, Shape1, Shape2> shapes[kBatchSize];
+  IntersectStatus status[kBatchSize];
+  for (std::size_t offset = 0; offset < n; offset += kBatchSize) {
+    const std::size_t n_batch =
+        (n - offset < kBatchSize) ? (n - offset) : kBatchSize;
+    for (std::size_t i = 0; i < n_batch; i++) {
+      const Transform3<S>& tf1_i = tf1[offset + i];
+      shapes[i].shapes[0] = constructGJKGeometry(&s1[offset + i]);
+      shapes[i].shapes[1] = constructGJKGeometry(&s2);
+      shapes[i].toshape1.noalias() = tf2.linear().transpose() * tf1_i.linear();
+      shapes[i].toshape0 = tf1_i.inverse(Eigen::Isometry) * tf2;
+    }
+    mpr_batch.Intersect(shapes, n_batch, status);
+
+    // The failed ones (very low probability) move to the scalar path
+    for (std::size_t i = 0; i < n_batch; i++) {
+      const std::size_t shape_i = offset + i;
+      if (status[i] == IntersectStatus::Intersect) {
+        intersect[shape_i] = true;
+      } else if (status[i] == IntersectStatus::Separated) {
+        intersect[shape_i] = false;
+      } else {
+        intersect[shape_i] = ShapeIntersectIndepImpl<S, Shape1, Shape2>::run(
+            gjk_solver, s1[shape_i], tf1[shape_i], s2, tf2, nullptr, nullptr);
+      }
+    }
+  }
+}
+
+template <typename S>
+template <typename Shape1, typename Shape2>
+void GJKSolver<S>::shapeIntersectBatch(const Shape1* s1,
+                                       const Transform3<S>* tf1,
+                                       const Shape2& s2,
+                                       const Transform3<S>& tf2,
+                                       std::size_t n, bool* intersect) const {
+  using BatchByMPR = std::integral_constant<
+      bool, use_mpr_if_no_contact &&
+                ShapeIntersectBatchByMPR<S, Shape1, Shape2>::value>;
+  if (!use_mpr_batch) {
+    shapeIntersectBatchImpl(*this, s1, tf1, s2, tf2, n, intersect,
+                            std::false_type());
+    return;
+  }
+  shapeIntersectBatchImpl(*this, s1, tf1, s2, tf2, n, intersect,
+                          BatchByMPR());
+}
+
+//==============================================================================
+template <typename S, typename Shape1, typename Shape2>
+struct ShapeIntersectMarginImpl {
+  static bool run(const GJKSolver<S>& gjk_solver, const Shape1& s1,
+                  const Transform3<S>& tf1, const Shape2& s2,
+                  const Transform3<S>& tf2, S margin) {
+    cvx_collide::MarginMinkowskiDiff<S, ShapeMinkowskiDiff<S, Shape1, Shape2>>
+        shape;
+    shape.margin = margin;
+    shape.base.shapes[0] = constructGJKGeometry(&s1);
+    shape.base.shapes[1] = constructGJKGeometry(&s2);
+    shape.base.toshape1.noalias() = tf2.linear().transpose() * tf1.linear();
+    shape.base.toshape0 = tf1.inverse(Eigen::Isometry) * tf2;
+
+    // Only the separating direction is required, not the distance
+    GJKSimplex<S> gjk_simplex;
+    const GJK_Status gjk_result =
+        gjkEvaluateWithWarmStart<S>(gjk_solver, shape, gjk_simplex, nullptr);
+    return gjk_result == GJK_Status::Intersect;
+  }
+};
+
+// Whether the shape s at tf is within margin of the halfspace h at tf_h, by
+// the min of h.n.dot(x) over the points x of s
+template <typename S, typename Shape>
+bool halfspaceShapeIntersectWithMargin(const Halfspace<S>& h,
+                                       const Transform3<S>& tf_h,
+                                       const Shape& s, const Transform3<S>& tf,
+                                       S margin) {
+  const Vector3<S> n = tf_h.linear() * h.n;
+  const S d = h.d + n.dot(tf_h.translation());
+  const Vector3<S> n_in_s = tf.linear().transpose() * n;
+  const Vector3<S> min_point = ShapeGJKSupport<S, Shape>::support(
+      constructGJKGeometry(&s), -n_in_s);
+  return n_in_s.dot(min_point) + n.dot(tf.translation()) <= d + margin;
+}
+
+// The plane p within margin is the intersection of two halfspaces
+template <typename S, typename Shape>
+bool planeShapeIntersectWithMargin(const Plane<S>& p, const Transform3<S>& tf_p,
+                                   const Shape& s, const Transform3<S>& tf,
+                                   S margin) {
+  return halfspaceShapeIntersectWithMargin(Halfspace<S>(p.n, p.d), tf_p, s,
+                                           tf, margin) &&
+         halfspaceShapeIntersectWithMargin(Halfspace<S>(-p.n, -p.d), tf_p, s,
+                                           tf, margin);
+}
+
+template <typename S, typename Shape1>
+struct ShapeIntersectMarginImpl<S, Shape1, Halfspace<S>> {
+  static bool run(const GJKSolver<S>& /*gjk_solver*/, const Shape1& s1,
+                  const Transform3<S>& tf1, const Halfspace<S>& s2,
+                  const Transform3<S>& tf2, S margin) {
+    return halfspaceShapeIntersectWithMargin(s2, tf2, s1, tf1, margin);
+  }
+};
+
+template <typename S, typename Shape2>
+struct ShapeIntersectMarginImpl<S, Halfspace<S>, Shape2> {
+  static bool run(const GJKSolver<S>& /*gjk_solver*/, const Halfspace<S>& s1,
+                  const Transform3<S>& tf1, const Shape2& s2,
+                  const Transform3<S>& tf2, S margin) {
+    return halfspaceShapeIntersectWithMargin(s1, tf1, s2, tf2, margin);
+  }
+};
+
+template <typename S, typename Shape1>
+struct ShapeIntersectMarginImpl<S, Shape1, Plane<S>> {
+  static bool run(const GJKSolver<S>& /*gjk_solver*/, const Shape1& s1,
+                  const Transform3<S>& tf1, const Plane<S>& s2,
+                  const Transform3<S>& tf2, S margin) {
+    return planeShapeIntersectWithMargin(s2, tf2, s1, tf1, margin);
+  }
+};
+
+template <typename S, typename Shape2>
+struct ShapeIntersectMarginImpl<S, Plane<S>, Shape2> {
+  static bool run(const GJKSolver<S>& /*gjk_solver*/, const Plane<S>& s1,
+                  const Transform3<S>& tf1, const Shape2& s2,
+                  const Transform3<S>& tf2, S margin) {
+    return planeShapeIntersectWithMargin(s1, tf1, s2, tf2, margin);
+  }
+};
+
+// The pairs of halfspace and plane intersect unless they are parallel, and
+// the parallel ones are tested by their intervals of n1.dot(x)
+template <typename S>
+bool unboundedShapePairIntersectWithMargin(
+    const Vector3<S>& n1_local, S d1, bool s1_is_plane,
+    const Transform3<S>& tf1, const Vector3<S>& n2_local, S d2,
+    bool s2_is_plane, const Transform3<S>& tf2, S margin) {
+  const Vector3<S> n1 = tf1.linear() * n1_local;
+  const Vector3<S> n2 = tf2.linear() * n2_local;
+  if (n1.cross(n2).squaredNorm() >= std::numeric_limits<S>::epsilon())
+    return true;
+
+  const S offset1 = d1 + n1.dot(tf1.translation());
+  const S offset2 = d2 + n2.dot(tf2.translation());
+  constexpr S kInf = std::numeric_limits<S>::infinity();
+  const S lower1 = s1_is_plane ? offset1 : -kInf;
+  const S upper1 = offset1;
+  S lower2, upper2;
+  if (n1.dot(n2) > 0) {
+    lower2 = s2_is_plane ? offset2 : -kInf;
+    upper2 = offset2;
+  } else {
+    lower2 = -offset2;
+    upper2 = s2_is_plane ? -offset2 : kInf;
+  }
+  return lower1 <= upper2 + margin && lower2 <= upper1 + margin;
+}
+
+template <typename S>
+struct ShapeIntersectMarginImpl<S, Halfspace<S>, Halfspace<S>> {
+  static bool run(const GJKSolver<S>& /*gjk_solver*/, const Halfspace<S>& s1,
+                  const Transform3<S>& tf1, const Halfspace<S>& s2,
+                  const Transform3<S>& tf2, S margin) {
+    return unboundedShapePairIntersectWithMargin(s1.n, s1.d, false, tf1, s2.n,
+                                                 s2.d, false, tf2, margin);
+  }
+};
+
+template <typename S>
+struct ShapeIntersectMarginImpl<S, Halfspace<S>, Plane<S>> {
+  static bool run(const GJKSolver<S>& /*gjk_solver*/, const Halfspace<S>& s1,
+                  const Transform3<S>& tf1, const Plane<S>& s2,
+                  const Transform3<S>& tf2, S margin) {
+    return unboundedShapePairIntersectWithMargin(s1.n, s1.d, false, tf1, s2.n,
+                                                 s2.d, true, tf2, margin);
+  }
+};
+
+template <typename S>
+struct ShapeIntersectMarginImpl<S, Plane<S>, Halfspace<S>> {
+  static bool run(const GJKSolver<S>& /*gjk_solver*/, const Plane<S>& s1,
+                  const Transform3<S>& tf1, const Halfspace<S>& s2,
+                  const Transform3<S>& tf2, S margin) {
+    return unboundedShapePairIntersectWithMargin(s1.n, s1.d, true, tf1, s2.n,
+                                                 s2.d, false, tf2, margin);
+  }
+};
+
+template <typename S>
+struct ShapeIntersectMarginImpl<S, Plane<S>, Plane<S>> {
+  static bool run(const GJKSolver<S>& /*gjk_solver*/, const Plane<S>& s1,
+                  const Transform3<S>& tf1, const Plane<S>& s2,
+                  const Transform3<S>& tf2, S margin) {
+    return unboundedShapePairIntersectWithMargin(s1.n, s1.d, true, tf1, s2.n,
+                                                 s2.d, true, tf2, margin);
+  }
+};
+
+template <typename S>
+template <typename Shape1, typename Shape2>
+bool GJKSolver<S>::shapeIntersectWithMargin(const Shape1& s1,
+                                            const Transform3<S>& tf1,
+                                            const Shape2& s2,
+                                            const Transform3<S>& tf2,
+                                            S margin) const {
+  return ShapeIntersectMarginImpl<S, Shape1, Shape2>::run(*this, s1, tf1, s2,
+                                                          tf2, margin);
 }
 
 // clang-format off
@@ -181,7 +600,8 @@ bool GJKSolver<S>::shapeIntersect(
     static bool run(const GJKSolver<S>& /*gjk_solver*/, const SHAPE1<S>& s1, \
                     const Transform3<S>& tf1, const SHAPE2<S>& s2,           \
                     const Transform3<S>& tf2,                                \
-                    CollisionPenetrationContactData<S>* contacts) {          \
+                    CollisionPenetrationContactData<S>* contacts,            \
+                    GJKWarmStart<S>* /*warm_start*/) {                       \
       return ALG(s1, tf1, s2, tf2, contacts);                                \
     }                                                                        \
   };
@@ -192,7 +612,8 @@ bool GJKSolver<S>::shapeIntersect(
     static bool run(const GJKSolver<S>& /*gjk_solver*/, const SHAPE2<S>& s1, \
                     const Transform3<S>& tf1, const SHAPE1<S>& s2,           \
                     const Transform3<S>& tf2,                                \
-                    CollisionPenetrationContactData<S>* contacts) {          \
+                    CollisionPenetrationContactData<S>* contacts,            \
+                    GJKWarmStart<S>* /*warm_start*/) {                       \
       const bool res = ALG(s2, tf2, s1, tf1, contacts);                      \
       if (contacts) flipNormal(*contacts);                                   \
       return res;                                                            \
@@ -242,12 +663,26 @@ FCL_GJK_INDEP_SHAPE_SHAPE_INTERSECT(Cylinder, Plane,
                                     detail::cylinderPlaneIntersect)
 FCL_GJK_INDEP_SHAPE_SHAPE_INTERSECT(Cone, Plane, detail::conePlaneIntersect)
 
+// The pairs of box (such as the octree voxels) and the shapes that go
+// through the MPR of the generic ShapeIntersectIndepImpl
+#define FCL_GJK_INDEP_SHAPE_SHAPE_INTERSECT_BATCH_BY_MPR(SHAPE1, SHAPE2) \
+  template <typename S>                                                  \
+  struct ShapeIntersectBatchByMPR<S, SHAPE1<S>, SHAPE2<S>>               \
+      : std::true_type {};
+
+FCL_GJK_INDEP_SHAPE_SHAPE_INTERSECT_BATCH_BY_MPR(Box, Ellipsoid)
+FCL_GJK_INDEP_SHAPE_SHAPE_INTERSECT_BATCH_BY_MPR(Box, Capsule)
+FCL_GJK_INDEP_SHAPE_SHAPE_INTERSECT_BATCH_BY_MPR(Box, Cone)
+FCL_GJK_INDEP_SHAPE_SHAPE_INTERSECT_BATCH_BY_MPR(Box, Cylinder)
+FCL_GJK_INDEP_SHAPE_SHAPE_INTERSECT_BATCH_BY_MPR(Box, Convex)
+
 template <typename S>
 struct ShapeIntersectIndepImpl<S, Halfspace<S>, Halfspace<S>> {
   static bool run(const GJKSolver<S>& /*gjk_solver*/, const Halfspace<S>& s1,
                   const Transform3<S>& tf1, const Halfspace<S>& s2,
                   const Transform3<S>& tf2,
-                  CollisionPenetrationContactData<S>* contacts) {
+                  CollisionPenetrationContactData<S>* contacts,
+                  GJKWarmStart<S>* /*warm_start*/) {
     FCL_UNUSED(contacts);
 
     Halfspace<S> s;
@@ -263,7 +698,8 @@ struct ShapeIntersectIndepImpl<S, Plane<S>, Plane<S>> {
   static bool run(const GJKSolver<S>& /*gjk_solver*/, const Plane<S>& s1,
                   const Transform3<S>& tf1, const Plane<S>& s2,
                   const Transform3<S>& tf2,
-                  CollisionPenetrationContactData<S>* contacts) {
+                  CollisionPenetrationContactData<S>* contacts,
+                  GJKWarmStart<S>* /*warm_start*/) {
     return detail::planeIntersect(s1, tf1, s2, tf2, contacts);
   }
 };
@@ -273,7 +709,8 @@ struct ShapeIntersectIndepImpl<S, Plane<S>, Halfspace<S>> {
   static bool run(const GJKSolver<S>& /*gjk_solver*/, const Plane<S>& s1,
                   const Transform3<S>& tf1, const Halfspace<S>& s2,
                   const Transform3<S>& tf2,
-                  CollisionPenetrationContactData<S>* contacts) {
+                  CollisionPenetrationContactData<S>* contacts,
+                  GJKWarmStart<S>* /*warm_start*/) {
     FCL_UNUSED(contacts);
 
     Plane<S> pl;
@@ -290,7 +727,8 @@ struct ShapeIntersectIndepImpl<S, Halfspace<S>, Plane<S>> {
   static bool run(const GJKSolver<S>& /*gjk_solver*/, const Halfspace<S>& s1,
                   const Transform3<S>& tf1, const Plane<S>& s2,
                   const Transform3<S>& tf2,
-                  CollisionPenetrationContactData<S>* contacts) {
+                  CollisionPenetrationContactData<S>* contacts,
+                  GJKWarmStart<S>* /*warm_start*/) {
     FCL_UNUSED(contacts);
 
     Plane<S> pl;
@@ -316,11 +754,9 @@ bool shapeTriangleIntersectImplRun(const GJKSolver<S>& gjk_solver,
   if (gjk_solver.is_gjk_guess_valid) guess = gjk_solver.gjk_guess;
 
   // Make the space
-  MinkowskiDiff<S> shape;
+  ShapeMinkowskiDiff<S, Shape, TriangleP<S>> shape;
   shape.shapes[0] = constructGJKGeometry(&s);
   shape.shapes[1] = constructGJKGeometry(&tri);
-  shape.support_function = computeSupport<S>;
-  shape.interior_function = computeInterior<S>;
   shape.toshape1 = tf.linear();
   shape.toshape0 = tf.inverse(Eigen::Isometry);
 
@@ -348,7 +784,8 @@ bool shapeTriangleIntersectImplRun(const GJKSolver<S>& gjk_solver,
     S epa_depth{0};
     Vector3<S> p_on_0, p_on_1;
     auto epa_status_out =
-        epa2.Evaluate(gjk_simplex, shape, &epa_depth, &p_on_0, &p_on_1);
+        epa2.Evaluate(gjk_simplex, shape, &epa_depth, &p_on_0, &p_on_1,
+                      gjk_solver.epaPolytopeCache());
     if (epa_status_out != EPA_Status::Failed) {
       // Assign the contact point, the middle of two points
       if (contact_points != nullptr) {
@@ -453,33 +890,28 @@ bool shapeTransformedTriangleIntersectIndepImplRun(
     const GJKSolver<S>& gjk_solver, const Shape& s, const Transform3<S>& tf1,
     const Vector3<S>& P1, const Vector3<S>& P2, const Vector3<S>& P3,
     const Transform3<S>& tf2, Vector3<S>* contact_points, S* penetration_depth,
-    Vector3<S>* normal) {
+    Vector3<S>* normal, GJKWarmStart<S>* warm_start) {
   // Construct the triangle
   TriangleP<S> tri(P1, P2, P3);
-  Vector3<S> guess(1, 0, 0);
-  if (gjk_solver.is_gjk_guess_valid) guess = gjk_solver.gjk_guess;
 
   // The shape and transform
-  MinkowskiDiff<S> shape;
+  ShapeMinkowskiDiff<S, Shape, TriangleP<S>> shape;
   shape.shapes[0] = constructGJKGeometry(&s);
   shape.shapes[1] = constructGJKGeometry(&tri);
-  shape.support_function = computeSupport<S>;
-  shape.interior_function = computeInterior<S>;
   shape.toshape1.noalias() = tf2.linear().transpose() * tf1.linear();
   shape.toshape0 = tf1.inverse(Eigen::Isometry) * tf2;
 
   // The compute option allows MPR only
   if (use_mpr_if_no_contact && contact_points == nullptr &&
       penetration_depth == nullptr && normal == nullptr) {
-    MPR<S> mpr(gjk_solver.gjk_max_iterations, gjk_solver.gjk_tolerance);
-    auto mpr_result = mpr.Intersect(shape);
+    auto mpr_result = mprIntersectWithWarmStart(gjk_solver, shape, warm_start);
     return mpr_result == MPR<S>::IntersectStatus::Intersect;
   }
 
   // Check can we use GJK only
-  GJK2<S> gjk2(gjk_solver.gjk_max_iterations, gjk_solver.gjk_tolerance);
   GJKSimplex<S> gjk_simplex;
-  auto gjk_result = gjk2.Evaluate(shape, gjk_simplex, -guess);
+  auto gjk_result =
+      gjkEvaluateWithWarmStart(gjk_solver, shape, gjk_simplex, warm_start);
   if (contact_points == nullptr && penetration_depth == nullptr &&
       normal == nullptr) {
     return gjk_result == GJK_Status::Intersect;
@@ -492,7 +924,8 @@ bool shapeTransformedTriangleIntersectIndepImplRun(
     S epa_depth{0};
     Vector3<S> p_on_1, p_on_2;
     auto epa_status_out =
-        epa2.Evaluate(gjk_simplex, shape, &epa_depth, &p_on_1, &p_on_2);
+        epa2.Evaluate(gjk_simplex, shape, &epa_depth, &p_on_1, &p_on_2,
+                      gjk_solver.epaPolytopeCache());
     if (epa_status_out != EPA_Status::Failed) {
       // Assign the contact point, the middle of two points
       if (contact_points != nullptr) {
@@ -532,10 +965,11 @@ struct ShapeTransformedTriangleIntersectIndepImpl {
                   const Transform3<S>& tf1, const Vector3<S>& P1,
                   const Vector3<S>& P2, const Vector3<S>& P3,
                   const Transform3<S>& tf2, Vector3<S>* contact_points,
-                  S* penetration_depth, Vector3<S>* normal) {
+                  S* penetration_depth, Vector3<S>* normal,
+                  GJKWarmStart<S>* warm_start) {
     return shapeTransformedTriangleIntersectIndepImplRun<S, Shape>(
         gjk_solver, s, tf1, P1, P2, P3, tf2, contact_points, penetration_depth,
-        normal);
+        normal, warm_start);
   }
 };
 
@@ -545,16 +979,17 @@ template <typename Shape>
 bool GJKSolver<S>::shapeTriangleIntersect(
     const Shape& s, const Transform3<S>& tf1, const Vector3<S>& P1,
     const Vector3<S>& P2, const Vector3<S>& P3, const Transform3<S>& tf2,
-    CollisionPenetrationContactData<S>* penetration_contacts) const {
+    CollisionPenetrationContactData<S>* penetration_contacts,
+    GJKWarmStart<S>* warm_start) const {
   if (penetration_contacts == nullptr) {
     return ShapeTransformedTriangleIntersectIndepImpl<S, Shape>::run(
-        *this, s, tf1, P1, P2, P3, tf2, nullptr, nullptr, nullptr);
+        *this, s, tf1, P1, P2, P3, tf2, nullptr, nullptr, nullptr, warm_start);
   } else {
     ContactPoint<S> contact;
     const bool intersect =
         ShapeTransformedTriangleIntersectIndepImpl<S, Shape>::run(
             *this, s, tf1, P1, P2, P3, tf2, &contact.pos,
-            &contact.penetration_depth, &contact.normal);
+            &contact.penetration_depth, &contact.normal, warm_start);
     if (intersect) {
       penetration_contacts->emplace_back(std::move(contact));
     }
@@ -569,7 +1004,8 @@ struct ShapeTransformedTriangleIntersectIndepImpl<S, Sphere<S>> {
                   const Transform3<S>& tf1, const Vector3<S>& P1,
                   const Vector3<S>& P2, const Vector3<S>& P3,
                   const Transform3<S>& tf2, Vector3<S>* contact_points,
-                  S* penetration_depth, Vector3<S>* normal) {
+                  S* penetration_depth, Vector3<S>* normal,
+                  GJKWarmStart<S>* /*warm_start*/) {
     return detail::sphereTriangleIntersect(s, tf1, tf2 * P1, tf2 * P2, tf2 * P3,
                                            contact_points, penetration_depth,
                                            normal);
@@ -583,14 +1019,15 @@ struct ShapeTransformedTriangleIntersectIndepImpl<S, Box<S>> {
                   const Transform3<S>& tf1, const Vector3<S>& P1,
                   const Vector3<S>& P2, const Vector3<S>& P3,
                   const Transform3<S>& tf2, Vector3<S>* contact_points,
-                  S* penetration_depth, Vector3<S>* normal) {
+                  S* penetration_depth, Vector3<S>* normal,
+                  GJKWarmStart<S>* warm_start) {
     if (contact_points == nullptr && penetration_depth == nullptr &&
         normal == nullptr) {
       return detail::boxTriangleIntersect(s, tf1, P1, P2, P3, tf2);
     }
     return shapeTransformedTriangleIntersectIndepImplRun<S>(
         gjk_solver, s, tf1, P1, P2, P3, tf2, contact_points, penetration_depth,
-        normal);
+        normal, warm_start);
   }
 };
 
@@ -601,7 +1038,8 @@ struct ShapeTransformedTriangleIntersectIndepImpl<S, Halfspace<S>> {
                   const Transform3<S>& tf1, const Vector3<S>& P1,
                   const Vector3<S>& P2, const Vector3<S>& P3,
                   const Transform3<S>& tf2, Vector3<S>* contact_points,
-                  S* penetration_depth, Vector3<S>* normal) {
+                  S* penetration_depth, Vector3<S>* normal,
+                  GJKWarmStart<S>* /*warm_start*/) {
     return detail::halfspaceTriangleIntersect(
         s, tf1, P1, P2, P3, tf2, contact_points, penetration_depth, normal);
   }
@@ -614,7 +1052,8 @@ struct ShapeTransformedTriangleIntersectIndepImpl<S, Plane<S>> {
                   const Transform3<S>& tf1, const Vector3<S>& P1,
                   const Vector3<S>& P2, const Vector3<S>& P3,
                   const Transform3<S>& tf2, Vector3<S>* contact_points,
-                  S* penetration_depth, Vector3<S>* normal) {
+                  S* penetration_depth, Vector3<S>* normal,
+                  GJKWarmStart<S>* /*warm_start*/) {
     return detail::planeTriangleIntersect(
         s, tf1, P1, P2, P3, tf2, contact_points, penetration_depth, normal);
   }
@@ -626,33 +1065,28 @@ bool shapeTransformedTetrahedronIntersectIndepImplRun(
     const GJKSolver<S>& gjk_solver, const Shape& s, const Transform3<S>& tf1,
     const Vector3<S>& P1, const Vector3<S>& P2, const Vector3<S>& P3,
     const Vector3<S>& P4, const Transform3<S>& tf2, Vector3<S>* contact_points,
-    S* penetration_depth, Vector3<S>* normal) {
+    S* penetration_depth, Vector3<S>* normal, GJKWarmStart<S>* warm_start) {
   // Construct the triangle
   Tetrahedron<S> tet(P1, P2, P3, P4);
-  Vector3<S> guess(1, 0, 0);
-  if (gjk_solver.is_gjk_guess_valid) guess = gjk_solver.gjk_guess;
 
   // The shape and transform
-  MinkowskiDiff<S> shape;
+  ShapeMinkowskiDiff<S, Shape, Tetrahedron<S>> shape;
   shape.shapes[0] = constructGJKGeometry(&s);
   shape.shapes[1] = constructGJKGeometry(&tet);
-  shape.support_function = computeSupport<S>;
-  shape.interior_function = computeInterior<S>;
   shape.toshape1.noalias() = tf2.linear().transpose() * tf1.linear();
   shape.toshape0 = tf1.inverse(Eigen::Isometry) * tf2;
 
   // The compute option allows MPR only
   if (use_mpr_if_no_contact && contact_points == nullptr &&
       penetration_depth == nullptr && normal == nullptr) {
-    MPR<S> mpr(gjk_solver.gjk_max_iterations, gjk_solver.gjk_tolerance);
-    auto mpr_result = mpr.Intersect(shape);
+    auto mpr_result = mprIntersectWithWarmStart(gjk_solver, shape, warm_start);
     return mpr_result == MPR<S>::IntersectStatus::Intersect;
   }
 
   // Check can we use GJK only
-  GJK2<S> gjk2(gjk_solver.gjk_max_iterations, gjk_solver.gjk_tolerance);
   GJKSimplex<S> gjk_simplex;
-  auto gjk_result = gjk2.Evaluate(shape, gjk_simplex, -guess);
+  auto gjk_result =
+      gjkEvaluateWithWarmStart(gjk_solver, shape, gjk_simplex, warm_start);
   if (contact_points == nullptr && penetration_depth == nullptr &&
       normal == nullptr) {
     return gjk_result == GJK_Status::Intersect;
@@ -665,7 +1099,8 @@ bool shapeTransformedTetrahedronIntersectIndepImplRun(
     S epa_depth{0};
     Vector3<S> p_on_1, p_on_2;
     auto epa_status_out =
-        epa2.Evaluate(gjk_simplex, shape, &epa_depth, &p_on_1, &p_on_2);
+        epa2.Evaluate(gjk_simplex, shape, &epa_depth, &p_on_1, &p_on_2,
+                      gjk_solver.epaPolytopeCache());
     if (epa_status_out != EPA_Status::Failed) {
       // Assign the contact point, the middle of two points
       if (contact_points != nullptr) {
@@ -706,10 +1141,10 @@ struct ShapeTransformedTetrahedronIntersectIndepImpl {
                   const Vector3<S>& P2, const Vector3<S>& P3,
                   const Vector3<S>& P4, const Transform3<S>& tf2,
                   Vector3<S>* contact_points, S* penetration_depth,
-                  Vector3<S>* normal) {
+                  Vector3<S>* normal, GJKWarmStart<S>* warm_start) {
     return shapeTransformedTetrahedronIntersectIndepImplRun<S, Shape>(
         gjk_solver, s, tf1, P1, P2, P3, P4, tf2, contact_points,
-        penetration_depth, normal);
+        penetration_depth, normal, warm_start);
   }
 };
 
@@ -721,7 +1156,7 @@ struct ShapeTransformedTetrahedronIntersectIndepImpl<S, Box<S>> {
                   const Vector3<S>& P2, const Vector3<S>& P3,
                   const Vector3<S>& P4, const Transform3<S>& tf2,
                   Vector3<S>* contact_points, S* penetration_depth,
-                  Vector3<S>* normal) {
+                  Vector3<S>* normal, GJKWarmStart<S>* warm_start) {
     if (contact_points == nullptr && penetration_depth == nullptr &&
         normal == nullptr) {
       Tetrahedron<S> tetrahedron(P1, P2, P3, P4);
@@ -729,7 +1164,7 @@ struct ShapeTransformedTetrahedronIntersectIndepImpl<S, Box<S>> {
     }
     return shapeTransformedTetrahedronIntersectIndepImplRun<S>(
         gjk_solver, s, tf1, P1, P2, P3, P4, tf2, contact_points,
-        penetration_depth, normal);
+        penetration_depth, normal, warm_start);
   }
 };
 
@@ -740,16 +1175,18 @@ bool GJKSolver<S>::shapeTetrahedronIntersect(
     const Shape& s, const Transform3<S>& tf1, const Vector3<S>& P1,
     const Vector3<S>& P2, const Vector3<S>& P3, const Vector3<S>& P4,
     const Transform3<S>& tf2,
-    CollisionPenetrationContactData<S>* penetration_contacts) const {
+    CollisionPenetrationContactData<S>* penetration_contacts,
+    GJKWarmStart<S>* warm_start) const {
   if (penetration_contacts == nullptr) {
     return ShapeTransformedTetrahedronIntersectIndepImpl<S, Shape>::run(
-        *this, s, tf1, P1, P2, P3, P4, tf2, nullptr, nullptr, nullptr);
+        *this, s, tf1, P1, P2, P3, P4, tf2, nullptr, nullptr, nullptr,
+        warm_start);
   } else {
     ContactPoint<S> contact;
     const bool intersect =
         ShapeTransformedTetrahedronIntersectIndepImpl<S, Shape>::run(
             *this, s, tf1, P1, P2, P3, P4, tf2, &contact.pos,
-            &contact.penetration_depth, &contact.normal);
+            &contact.penetration_depth, &contact.normal, warm_start);
     if (intersect) {
       penetration_contacts->emplace_back(std::move(contact));
     }
@@ -768,11 +1205,9 @@ struct ShapeDistanceIndepImpl {
     if (gjk_solver.is_gjk_guess_valid) guess = gjk_solver.gjk_guess;
 
     // Construct the shape
-    MinkowskiDiff<S> shape;
+    ShapeMinkowskiDiff<S, Shape1, Shape2> shape;
     shape.shapes[0] = constructGJKGeometry(&s1);
     shape.shapes[1] = constructGJKGeometry(&s2);
-    shape.support_function = computeSupport<S>;
-    shape.interior_function = computeInterior<S>;
     shape.toshape1.noalias() = tf2.linear().transpose() * tf1.linear();
     shape.toshape0 = tf1.inverse(Eigen::Isometry) * tf2;
 
@@ -817,11 +1252,9 @@ struct ShapeSignedDistanceIndepImpl {
     if (gjk_solver.is_gjk_guess_valid) guess = gjk_solver.gjk_guess;
 
     // Construct the shape
-    MinkowskiDiff<S> shape;
+    ShapeMinkowskiDiff<S, Shape1, Shape2> shape;
     shape.shapes[0] = constructGJKGeometry(&s1);
     shape.shapes[1] = constructGJKGeometry(&s2);
-    shape.support_function = computeSupport<S>;
-    shape.interior_function = computeInterior<S>;
     shape.toshape1.noalias() = tf2.linear().transpose() * tf1.linear();
     shape.toshape0 = tf1.inverse(Eigen::Isometry) * tf2;
 
@@ -845,8 +1278,9 @@ struct ShapeSignedDistanceIndepImpl {
                    gjk_solver.epa_tolerance);
       Vector3<S> p_on_1, p_on_2;
       S depth_if_penetration;
-      auto epa_status = epa2.Evaluate(simplex, shape, &depth_if_penetration,
-                                      &p_on_1, &p_on_2);
+      auto epa_status =
+          epa2.Evaluate(simplex, shape, &depth_if_penetration, &p_on_1,
+                        &p_on_2, gjk_solver.epaPolytopeCache());
       if (epa_status != EPA_Status::Failed) {
         if (p1 != nullptr) *p1 = tf1 * p_on_1;
         if (p2 != nullptr) *p2 = tf1 * p_on_2;
@@ -997,11 +1431,9 @@ struct ShapeTriangleDistanceIndepImpl {
     if (gjk_solver.is_gjk_guess_valid) guess = gjk_solver.gjk_guess;
 
     // Construct the shape
-    MinkowskiDiff<S> shape;
+    ShapeMinkowskiDiff<S, Shape, TriangleP<S>> shape;
     shape.shapes[0] = constructGJKGeometry(&s);
     shape.shapes[1] = constructGJKGeometry(&tri);
-    shape.support_function = computeSupport<S>;
-    shape.interior_function = computeInterior<S>;
     shape.toshape1 = tf.linear();
     shape.toshape0 = tf.inverse(Eigen::Isometry);
 
@@ -1063,11 +1495,9 @@ struct ShapeTransformedTriangleDistanceIndepImpl {
     if (gjk_solver.is_gjk_guess_valid) guess = gjk_solver.gjk_guess;
 
     // Construct the shape
-    MinkowskiDiff<S> shape;
+    ShapeMinkowskiDiff<S, Shape, TriangleP<S>> shape;
     shape.shapes[0] = constructGJKGeometry(&s);
     shape.shapes[1] = constructGJKGeometry(&tri);
-    shape.support_function = computeSupport<S>;
-    shape.interior_function = computeInterior<S>;
     shape.toshape1.noalias() = tf2.linear().transpose() * tf1.linear();
     shape.toshape0 = tf1.inverse(Eigen::Isometry) * tf2;
 
@@ -1116,6 +1546,16 @@ struct ShapeTransformedTriangleDistanceIndepImpl<S, Sphere<S>> {
   }
 };
 
+//==============================================================================
+template <typename S>
+Polytope<S>* GJKSolver<S>::epaPolytopeCache() const {
+  // EPA never runs recursively, thus one polytope per thread is enough.
+  // The polytope keeps its buffers after Reset, so only the first EPA of a
+  // thread (or with a larger epa_max_face_num) allocates.
+  static thread_local Polytope<S> polytope(epa_max_face_num);
+  return &polytope;
+}
+
 //==============================================================================
 template <typename S>
 GJKSolver<S>::GJKSolver() {
@@ -1127,6 +1567,11 @@ GJKSolver<S>::GJKSolver() {
   epa_tolerance = constants<S>::gjk_default_tolerance();
   is_gjk_guess_valid = false;
   gjk_guess = Vector3<S>(1, 0, 0);
+  use_mpr_batch = false;
+  warm_start_cache = nullptr;
+  use_mixed_precision = false;
+  mixed_precision_band = 1e-4;
+  mixed_precision_counters = nullptr;
 }
 
 }  // namespace detail
@@ -38,28 +38,79 @@
 #ifndef FCL_NARROWPHASE_GJKSOLVERINDEP_H
 #define FCL_NARROWPHASE_GJKSOLVERINDEP_H
 
+#include <cstddef>
 #include <iostream>
+#include <type_traits>
 
 #include "fcl/common/types.h"
 #include "fcl/narrowphase/contact_point.h"
 #include "fcl/narrowphase/detail/collision_penetration_mode.h"
+#include "fcl/narrowphase/detail/gjk_warm_start_cache.h"
 
 namespace fcl {
 
 namespace detail {
 
+/// @brief Whether the binary intersection (without contacts) of Shape1 and
+/// Shape2 is solved by MPR. For these pairs, GJKSolver::shapeIntersectBatch
+/// runs the MPR of a batch in lockstep, see MPRBatch.
+template <typename S, typename Shape1, typename Shape2>
+struct ShapeIntersectBatchByMPR : std::false_type {};
+
+/// @brief The counters of the mixed precision binary intersection, see
+/// GJKSolver::use_mixed_precision
+struct MixedPrecisionCounters {
+  /// The number of queries evaluated by the float GJK
+  std::size_t n_float_queries{0};
+
+  /// The number of these queries re-evaluated in double, as the float result
+  /// is within mixed_precision_band of the decision boundary
+  std::size_t n_double_fallbacks{0};
+
+  void reset() {
+    n_float_queries = 0;
+    n_double_fallbacks = 0;
+  }
+};
+
 /// @brief collision and distance solver based on GJK algorithm implemented in
 /// fcl (rewritten the code from the GJK in bullet)
 template <typename S_>
 struct GJKSolver {
   using S = S_;
 
-  /// @brief intersection checking between two shapes
+  /// @brief intersection checking between two shapes. If warm_start is not
+  /// nullptr, the GJK/MPR is warm started from the last query of this pair
+  /// and the warm start is updated, see GJKWarmStartCache.
   template <typename Shape1, typename Shape2>
   bool shapeIntersect(
       const Shape1& s1, const Transform3<S>& tf1, const Shape2& s2,
       const Transform3<S>& tf2,
-      CollisionPenetrationContactData<S>* penetration_contacts = nullptr) const;
+      CollisionPenetrationContactData<S>* penetration_contacts = nullptr,
+      GJKWarmStart<S>* warm_start = nullptr) const;
+
+  /// @brief binary intersection checking between n shapes s1[i] at tf1[i]
+  /// and a shape s2 at tf2, the result of s1[i] is written to intersect[i].
+  /// The result is the same as shapeIntersect(s1[i], tf1[i], s2, tf2). If
+  /// use_mpr_batch, the pairs in ShapeIntersectBatchByMPR are evaluated by
+  /// MPRBatch with kShapeIntersectBatchSize pairs in each call.
+  static constexpr std::size_t kShapeIntersectBatchSize = 32;
+  template <typename Shape1, typename Shape2>
+  void shapeIntersectBatch(const Shape1* s1, const Transform3<S>* tf1,
+                           const Shape2& s2, const Transform3<S>& tf2,
+                           std::size_t n, bool* intersect) const;
+
+  /// @brief binary intersection checking between two shapes inflated by a
+  /// safety margin, which returns true iff the distance between the shapes
+  /// is less than margin (up to gjk_tolerance). The convex pairs are solved
+  /// by GJK on cvx_collide::MarginMinkowskiDiff, which stops at the first
+  /// direction separating the inflated shapes. A halfspace (or plane) is
+  /// tested by the projection of the other shape on its normal, and a pair of
+  /// halfspaces/planes only by their offsets if they are parallel.
+  template <typename Shape1, typename Shape2>
+  bool shapeIntersectWithMargin(const Shape1& s1, const Transform3<S>& tf1,
+                                const Shape2& s2, const Transform3<S>& tf2,
+                                S margin) const;
 
   /// @brief intersection checking between one shape and a triangle
   template <typename Shape>
@@ -74,7 +125,8 @@ struct GJKSolver {
   bool shapeTriangleIntersect(
       const Shape& s, const Transform3<S>& tf1, const Vector3<S>& P1,
       const Vector3<S>& P2, const Vector3<S>& P3, const Transform3<S>& tf2,
-      CollisionPenetrationContactData<S>* penetration_contacts = nullptr) const;
+      CollisionPenetrationContactData<S>* penetration_contacts = nullptr,
+      GJKWarmStart<S>* warm_start = nullptr) const;
 
   //// @brief intersection checking between one shape and a tetrahedron with
   /// transformation
@@ -83,7 +135,8 @@ struct GJKSolver {
       const Shape& s, const Transform3<S>& tf1, const Vector3<S>& P1,
       const Vector3<S>& P2, const Vector3<S>& P3, const Vector3<S>& P4,
       const Transform3<S>& tf2,
-      CollisionPenetrationContactData<S>* penetration_contacts = nullptr) const;
+      CollisionPenetrationContactData<S>* penetration_contacts = nullptr,
+      GJKWarmStart<S>* warm_start = nullptr) const;
 
   /// @brief distance computation between two shapes
   template <typename Shape1, typename Shape2>
@@ -116,6 +169,11 @@ struct GJKSolver {
                              S* distance = nullptr, Vector3<S>* p1 = nullptr,
                              Vector3<S>* p2 = nullptr) const;
 
+  /// @brief The EPA polytope of this thread that is reused by all the EPA
+  /// evaluations of GJKSolver, so that they do not allocate after the first
+  /// one. It is shared by all GJKSolver<S> in the same thread.
+  Polytope<S>* epaPolytopeCache() const;
+
   /// @brief default setting for GJK algorithm
   GJKSolver();
 
@@ -162,6 +220,42 @@ struct GJKSolver {
   bool is_gjk_guess_valid{false};
   Vector3<S> gjk_guess;
 
+  /// @brief Whether the binary intersections of the pairs in
+  ///        ShapeIntersectBatchByMPR are evaluated by the lockstep
+  ///        MPRBatch, both in shapeIntersectBatch and the leaf pairs of the
+  ///        octree traversal. Its lane loops run every phase of MPR on all
+  ///        the lanes, and it is only faster than the scalar MPR if these
+  ///        loops are vectorized by the compiler (which requires the flags
+  ///        such as -fno-trapping-math). Thus, it is disabled by default.
+  bool use_mpr_batch{false};
+
+  /// @brief The per-pair warm start of GJK/MPR, keyed by the (geometry,
+  ///        primitive index) of both shapes in ContactMeta. It is used by
+  ///        the shape-shape, shape-triangle and shape-tetrahedron queries
+  ///        issued from the collision traversal. It is owned by the user and
+  ///        disabled if nullptr (the default). As the cache is updated by
+  ///        the queries, a solver with warm_start_cache must not be shared
+  ///        by threads.
+  GJKWarmStartCache<S>* warm_start_cache{nullptr};
+
+  /// @brief Whether the binary intersection of the basic shapes (box,
+  ///        sphere, ellipsoid, capsule, cone and cylinder) solved by GJK/MPR
+  ///        runs the float GJK first. The float result is kept if it is
+  ///        certified farther than mixed_precision_band from the decision
+  ///        boundary, by the separating direction or by the depth of the
+  ///        origin in the GJK simplex. Otherwise, the query is re-evaluated
+  ///        in S. The band should cover the float rounding error of the
+  ///        shapes, which is proportional to their size and distance. Only
+  ///        used by GJKSolver<double>.
+  bool use_mixed_precision{false};
+  S mixed_precision_band{1e-4};
+
+  /// @brief The counters of the mixed precision queries. It is owned by the
+  ///        user and not updated if nullptr (the default). Like
+  ///        warm_start_cache, a solver with the counters must not be shared
+  ///        by threads.
+  MixedPrecisionCounters* mixed_precision_counters{nullptr};
+
   friend std::ostream& operator<<(std::ostream& out, const GJKSolver& solver) {
     out << "GJKSolver"
         << "\n    gjk tolerance:       " << solver.gjk_tolerance
@@ -170,6 +264,9 @@ struct GJKSolver {
         << "\n    epa max face num:    " << solver.epa_max_face_num
         << "\n    epa max vertex num:  " << solver.epa_max_vertex_num
         << "\n    epa max iterations:  " << solver.epa_max_iterations
+        << "\n    enable mpr batch:    " << solver.use_mpr_batch
+        << "\n    enable warm start:   " << (solver.warm_start_cache != nullptr)
+        << "\n    mixed precision:     " << solver.use_mixed_precision
         << "\n    enable cached guess: " << solver.is_gjk_guess_valid;
     if (solver.is_gjk_guess_valid) out << solver.gjk_guess.transpose();
     return out;
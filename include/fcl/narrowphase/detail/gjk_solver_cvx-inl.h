@@ -143,5 +143,32 @@ Vector3<T> computeInterior(const GJKGeometryData<T>& gjk_geometry) {
   }
 }
 
+template <typename T>
+struct ShapeGJKSupport<T, Box<T>> : cvx_collide::BoxGJKSupport<T> {};
+template <typename T>
+struct ShapeGJKSupport<T, Sphere<T>> : cvx_collide::SphereGJKSupport<T> {};
+template <typename T>
+struct ShapeGJKSupport<T, Ellipsoid<T>> : cvx_collide::EllipsoidGJKSupport<T> {
+};
+template <typename T>
+struct ShapeGJKSupport<T, Capsule<T>> : cvx_collide::CapsuleGJKSupport<T> {};
+template <typename T>
+struct ShapeGJKSupport<T, Cone<T>> : cvx_collide::ConeGJKSupport<T> {};
+template <typename T>
+struct ShapeGJKSupport<T, Cylinder<T>> : cvx_collide::CylinderGJKSupport<T> {
+};
+template <typename T>
+struct ShapeGJKSupport<T, TriangleP<T>>
+    : cvx_collide::GJKSupportPolicy<T, triangleSupport<T>,
+                                    computeInteriorExceptSweptVolume<T>> {};
+template <typename T>
+struct ShapeGJKSupport<T, Tetrahedron<T>>
+    : cvx_collide::GJKSupportPolicy<T, tetrahedronSupport<T>,
+                                    computeInteriorExceptSweptVolume<T>> {};
+template <typename T>
+struct ShapeGJKSupport<T, Convex<T>>
+    : cvx_collide::GJKSupportPolicy<T, convexSupport<T>,
+                                    computeInteriorExceptSweptVolume<T>> {};
+
 }  // namespace detail
 }  // namespace fcl
\ No newline at end of file
@@ -17,6 +17,23 @@ Vector3<T> computeSupport(const GJKGeometryData<T>& gjk_geometry,
                           const Vector3<T>& direction);
 template <typename T>
 Vector3<T> computeInterior(const GJKGeometryData<T>& gjk_geometry);
+template <typename T>
+Vector3<T> computeInteriorExceptSweptVolume(
+    const GJKGeometryData<T>& gjk_geometry);
+
+/// The support policy of fcl::Shape for cvx_collide::StaticMinkowskiDiff.
+/// The shapes without a specialization (such as ShapeBase) are dispatched
+/// at run time by computeSupport/computeInterior.
+template <typename T, typename Shape>
+struct ShapeGJKSupport
+    : cvx_collide::GJKSupportPolicy<T, computeSupport<T>, computeInterior<T>> {
+};
+
+/// The MinkowskiDiff of two fcl::Shape types known at compile time
+template <typename T, typename Shape0, typename Shape1>
+using ShapeMinkowskiDiff =
+    cvx_collide::StaticMinkowskiDiff<T, ShapeGJKSupport<T, Shape0>,
+                                     ShapeGJKSupport<T, Shape1>>;
 
 }  // namespace detail
 }  // namespace fcl
@@ -0,0 +1,65 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include <functional>
+#include <iterator>
+
+#include "fcl/narrowphase/detail/gjk_warm_start_cache.h"
+
+namespace fcl {
+namespace detail {
+
+inline std::size_t GJKWarmStartKeyHash::operator()(
+    const GJKWarmStartKey& key) const {
+  // The boost::hash_combine
+  std::size_t seed = std::hash<const void*>()(key.o1);
+  auto combine = [&seed](std::size_t value) {
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  };
+  combine(std::hash<const void*>()(key.o2));
+  combine(std::hash<intptr_t>()(key.b1));
+  combine(std::hash<intptr_t>()(key.b2));
+  return seed;
+}
+
+template <typename S>
+GJKWarmStartCache<S>::GJKWarmStartCache(std::size_t capacity)
+    : capacity_(capacity > 0 ? capacity : 1) {
+  key_to_pair_.reserve(capacity_);
+}
+
+template <typename S>
+GJKWarmStart<S>* GJKWarmStartCache<S>::findOrInsert(
+    const GJKWarmStartKey& key) {
+  auto iter = key_to_pair_.find(key);
+  if (iter != key_to_pair_.end()) {
+    // Move to the front
+    pairs_.splice(pairs_.begin(), pairs_, iter->second);
+    return &iter->second->second;
+  }
+
+  // Reuse the node of the least recently used pair if full
+  if (pairs_.size() >= capacity_) {
+    key_to_pair_.erase(pairs_.back().first);
+    pairs_.splice(pairs_.begin(), pairs_, std::prev(pairs_.end()));
+    pairs_.front().first = key;
+  } else {
+    pairs_.emplace_front(key, GJKWarmStart<S>());
+  }
+  GJKWarmStart<S>& warm_start = pairs_.front().second;
+  warm_start.reset();
+  key_to_pair_.emplace(key, pairs_.begin());
+  return &warm_start;
+}
+
+template <typename S>
+void GJKWarmStartCache<S>::clear() {
+  pairs_.clear();
+  key_to_pair_.clear();
+}
+
+}  // namespace detail
+}  // namespace fcl
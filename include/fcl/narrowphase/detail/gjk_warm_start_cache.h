@@ -0,0 +1,93 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+#include "fcl/common/types.h"
+
+namespace fcl {
+namespace detail {
+
+/// The warm start of GJK and MPR for one pair of shapes. The directions are
+/// expressed in the frame of the first shape of the query. They only affect
+/// the number of iterations, the result of a query is certified regardless of
+/// the warm start.
+template <typename S>
+struct GJKWarmStart {
+  /// The direction d that certified separation in the last GJK, such that
+  /// dot(d, minkowski_diff.support(d)) < 0
+  bool is_gjk_direction_valid{false};
+  Vector3<S> gjk_direction;
+
+  /// The support directions of the portal in the last MPR
+  bool is_mpr_portal_valid{false};
+  Vector3<S> mpr_portal_direction[3];
+
+  void reset() {
+    is_gjk_direction_valid = false;
+    is_mpr_portal_valid = false;
+  }
+};
+
+/// The key of a pair of shapes: the geometry and the primitive index (such as
+/// the triangle in a mesh) of both shapes, the same as ContactMeta.
+struct GJKWarmStartKey {
+  const void* o1{nullptr};
+  const void* o2{nullptr};
+  intptr_t b1{-1};
+  intptr_t b2{-1};
+
+  bool operator==(const GJKWarmStartKey& other) const {
+    return o1 == other.o1 && o2 == other.o2 && b1 == other.b1 &&
+           b2 == other.b2;
+  }
+};
+
+struct GJKWarmStartKeyHash {
+  std::size_t operator()(const GJKWarmStartKey& key) const;
+};
+
+/// The warm start of GJK/MPR for the shape pairs that are queried
+/// repeatedly, such as the robot links along a temporally coherent
+/// trajectory. At most capacity pairs are kept, and the least recently used
+/// pair is evicted when a new pair is inserted into a full cache.
+/// It is not thread-safe, use one cache (and one GJKSolver) per thread.
+template <typename S>
+class GJKWarmStartCache {
+ public:
+  explicit GJKWarmStartCache(std::size_t capacity = 4096);
+
+  /// Find the warm start of the pair, or insert an invalid one (which evicts
+  /// the least recently used pair if full). Either way, the pair becomes the
+  /// most recently used one. The returned pointer is valid until the pair is
+  /// evicted or the cache is cleared.
+  GJKWarmStart<S>* findOrInsert(const GJKWarmStartKey& key);
+
+  /// Remove all pairs, such as after the scene is reset
+  void clear();
+
+  std::size_t size() const { return pairs_.size(); }
+  std::size_t capacity() const { return capacity_; }
+
+ private:
+  using PairList = std::list<std::pair<GJKWarmStartKey, GJKWarmStart<S>>>;
+  std::size_t capacity_;
+
+  // From the most recently used to the least recently used
+  PairList pairs_;
+  std::unordered_map<GJKWarmStartKey, typename PairList::iterator,
+                     GJKWarmStartKeyHash>
+      key_to_pair_;
+};
+
+}  // namespace detail
+}  // namespace fcl
+
+#include "fcl/narrowphase/detail/gjk_warm_start_cache-inl.h"
@@ -44,6 +44,18 @@ void ContactMeta<S>::writeToContact(Contact<S>& contact) const {
   }
 }
 
+template <typename S_>
+GJKWarmStart<S_>* ShapePairIntersectSolver<S_>::findWarmStart(
+    const ContactMeta<S>& contact_meta) const {
+  if (gjk_solver->warm_start_cache == nullptr) return nullptr;
+  GJKWarmStartKey key;
+  key.o1 = contact_meta.o1;
+  key.o2 = contact_meta.o2;
+  key.b1 = contact_meta.b1;
+  key.b2 = contact_meta.b2;
+  return gjk_solver->warm_start_cache->findOrInsert(key);
+}
+
 template <typename S_>
 template <typename Shape1, typename Shape2>
 void ShapePairIntersectSolver<S_>::ShapeIntersect(
@@ -66,8 +78,12 @@ void ShapePairIntersectSolver<S_>::ShapeIntersect(
 
   // Do NOT need penetration
   if (!request.isPenetrationEnabled()) {
+    const S margin = request.binaryCollisionMargin();
     const bool is_intersect =
-        gjk_solver->shapeIntersect(s1, tf1, s2, tf2, nullptr);
+        (margin > S(0))
+            ? gjk_solver->shapeIntersectWithMargin(s1, tf1, s2, tf2, margin)
+            : gjk_solver->shapeIntersect(s1, tf1, s2, tf2, nullptr,
+                                         findWarmStart(contact_meta));
     if (is_intersect) {
       assert(result.numContacts() < request.maxNumContacts());
       Contact<S> contact;
@@ -81,8 +97,8 @@ void ShapePairIntersectSolver<S_>::ShapeIntersect(
 
   assert(request.isPenetrationEnabled());
   CollisionPenetrationContactData<S> contacts;
-  const bool is_intersect =
-      gjk_solver->shapeIntersect(s1, tf1, s2, tf2, &contacts);
+  const bool is_intersect = gjk_solver->shapeIntersect(
+      s1, tf1, s2, tf2, &contacts, findWarmStart(contact_meta));
   if (!is_intersect) {
     // No collision, direct return
     return;
@@ -146,10 +162,30 @@ void ShapePairIntersectSolver<S_>::ShapeSimplexIntersect(
     return;
   }
 
+  // The simplex within the safety margin
+  const S margin = request.binaryCollisionMargin();
+  if (margin > S(0)) {
+    const bool intersect =
+        s2.is_triangle()
+            ? gjk_solver->shapeIntersectWithMargin(
+                  s1, tf1, TriangleP<S>(s2[0], s2[1], s2[2]), tf2, margin)
+            : gjk_solver->shapeIntersectWithMargin(
+                  s1, tf1, Tetrahedron<S>(s2[0], s2[1], s2[2], s2[3]), tf2,
+                  margin);
+    if (intersect) {
+      assert(result.numContacts() < request.maxNumContacts());
+      Contact<S> this_contact;
+      contact_meta.writeToContact(this_contact);
+      result.addContact(std::move(this_contact));
+    }
+    return;
+  }
+
   if (s2.is_triangle()) {
     if (!request.isPenetrationEnabled()) {
-      bool intersect = gjk_solver->shapeTriangleIntersect(s1, tf1, s2[0], s2[1],
-                                                          s2[2], tf2, nullptr);
+      bool intersect = gjk_solver->shapeTriangleIntersect(
+          s1, tf1, s2[0], s2[1], s2[2], tf2, nullptr,
+          findWarmStart(contact_meta));
       if (intersect) {
         assert(result.numContacts() < request.maxNumContacts());
         Contact<S> this_contact;
@@ -160,7 +196,8 @@ void ShapePairIntersectSolver<S_>::ShapeSimplexIntersect(
       // The contact result
       CollisionPenetrationContactData<S> penetration_data;
       bool intersect = gjk_solver->shapeTriangleIntersect(
-          s1, tf1, s2[0], s2[1], s2[2], tf2, &penetration_data);
+          s1, tf1, s2[0], s2[1], s2[2], tf2, &penetration_data,
+          findWarmStart(contact_meta));
       if (intersect) {
         assert(result.numContacts() < request.maxNumContacts());
         assert(penetration_data.size() == 1u);
@@ -173,7 +210,8 @@ void ShapePairIntersectSolver<S_>::ShapeSimplexIntersect(
   } else {
     if (!request.isPenetrationEnabled()) {
       bool intersect = gjk_solver->shapeTetrahedronIntersect(
-          s1, tf1, s2[0], s2[1], s2[2], s2[3], tf2, nullptr);
+          s1, tf1, s2[0], s2[1], s2[2], s2[3], tf2, nullptr,
+          findWarmStart(contact_meta));
       if (intersect) {
         assert(result.numContacts() < request.maxNumContacts());
         Contact<S> this_contact;
@@ -184,7 +222,8 @@ void ShapePairIntersectSolver<S_>::ShapeSimplexIntersect(
       // The contact result
       CollisionPenetrationContactData<S> penetration_data;
       bool intersect = gjk_solver->shapeTetrahedronIntersect(
-          s1, tf1, s2[0], s2[1], s2[2], s2[3], tf2, &penetration_data);
+          s1, tf1, s2[0], s2[1], s2[2], s2[3], tf2, &penetration_data,
+          findWarmStart(contact_meta));
       if (intersect) {
         assert(result.numContacts() < request.maxNumContacts());
         assert(penetration_data.size() == 1u);
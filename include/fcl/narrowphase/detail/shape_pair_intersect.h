@@ -75,6 +75,10 @@ struct ShapePairIntersectSolver {
   const GJKSolver<S>* gjk_solver;
 
  private:
+  // The warm start of the pair in contact_meta if the gjk solver has a
+  // warm_start_cache, else nullptr
+  GJKWarmStart<S>* findWarmStart(const ContactMeta<S>& contact_meta) const;
+
   void trianglePairIntersect(const Simplex<S>& s1, const Transform3<S>& tf1,
                              const Simplex<S>& s2, const Transform3<S>& tf2,
                              const Matrix3<S>& rotation_2to1,
@@ -13,9 +13,9 @@ void OrientedNodeBVHSolver<BV>::MeshShapeIntersect(
     return;
   }
 
-  // Compute the bv for shape_2
+  // Compute the bv for shape_2, inflated by the safety margin
   BV shape_bv;
-  computeBV(shape_2, tf2, shape_bv);
+  computeBVWithMargin(shape_2, tf2, request.binaryCollisionMargin(), shape_bv);
 
   // The task stack contains only the bv id
   std::stack<int> bv_id_stack;
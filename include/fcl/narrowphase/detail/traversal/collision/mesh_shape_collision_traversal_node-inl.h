@@ -118,7 +118,8 @@ bool initialize(MeshShapeCollisionTraversalNode<BV, Shape>& node,
   node.tf2 = tf2;
   node.nsolver = nsolver;
 
-  computeBV(model2, tf2, node.model2_bv);
+  computeBVWithMargin(model2, tf2, request.binaryCollisionMargin(),
+                      node.model2_bv);
   node.request = request;
   node.result = &result;
   node.cost_density = model1.cost_density * model2.cost_density;
@@ -276,7 +277,8 @@ bool setupMeshShapeCollisionOrientedNode(
   node.tf2 = tf2;
   node.nsolver = nsolver;
 
-  computeBV(model2, tf2, node.model2_bv);
+  computeBVWithMargin(model2, tf2, request.binaryCollisionMargin(),
+                      node.model2_bv);
   node.request = request;
   node.result = &result;
   node.cost_density = model1.cost_density * model2.cost_density;
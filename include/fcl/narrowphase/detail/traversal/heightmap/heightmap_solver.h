@@ -1,6 +1,7 @@
 #pragma once
 
 #include "fcl/geometry/bvh/BVH_model.h"
+#include "fcl/geometry/heightmap/heightmap_column_kernel.h"
 #include "fcl/geometry/heightmap/heightmap_collision_geometry.h"
 #include "fcl/geometry/octree2/octree_collision_geometry.h"
 #include "fcl/math/fixed_rotation_obb_disjoint.h"
@@ -36,9 +37,20 @@ namespace detail {
 /// In flatHeightMapShapeIntersectImpl, an heightmap-frame AABB of
 /// the geometry is first computed. Then, xOy component of the shape
 /// AABB is intersect with the heightmap xOy range to compute a
-/// region of interest. All heightmap pixel (box) in that region is
-/// collision checked with the given geometry.
+/// region of interest. In each row of that region, the cross-section of
+/// the shape OBB gives the exact interval of pixels under the shape, and
+/// the interval is rejected at once if its max height is below the shape.
+/// The remaining pixel (box) is collision checked with the given geometry.
 /// This method would be suitable when the region of interest is small.
+///
+/// Aligned Algorithm:
+/// When two heightmaps have the same square resolution and their frames
+/// differ by a yaw of multiple of 90 degrees and a translation of integer
+/// pixels in xOy (such as two bins on the same floor), each bottom pixel of
+/// one map lies exactly on a bottom pixel of the other. Then, the pixels of
+/// the second map are resampled into the rows of the first one, and each
+/// pair of columns is compared in z with SIMD instead of the traversal.
+/// The pairs of pixels that only touch on their sides are not reported.
 template <typename S>
 class HeightMapCollisionSolver {
  private:
@@ -156,6 +168,13 @@ class HeightMapCollisionSolver {
       const HeightMapCollisionGeometry<S>& hm_1_geometry,
       const HeightMapCollisionGeometry<S>& hm_2_geometry,
       const Transform3<S>& tf1, const Transform3<S>& tf2) const;
+  // The fast path of heightMapPairIntersect when the pixel grids of the two
+  // bottom layers coincide, return false if it is not applicable
+  bool heightMapPairAlignedIntersect(
+      const HeightMapCollisionGeometry<S>& hm_1_geometry,
+      const HeightMapCollisionGeometry<S>& hm_2_geometry,
+      const Transform3<S>& tf1, const Transform3<S>& tf2,
+      const FixedRotationBoxDisjoint<S>& obb_disjoint) const;
   void heightMapOctreeIntersect(
       const HeightMapCollisionGeometry<S>* hm_geometry,
       const Octree2CollisionGeometry<S>* octree, const Transform3<S>& tf_hm,
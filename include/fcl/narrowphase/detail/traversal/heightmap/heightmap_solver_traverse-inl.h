@@ -11,6 +11,238 @@ struct HeightMapNode {
       : layer(layer_in), pixel(pixel_in) {}
 };
 
+/// A stack with fixed capacity on the call stack, for the traversal whose
+/// depth is bounded (such as the layers of a heightmap).
+template <typename T, std::size_t Capacity>
+class HeightMapInlineStack {
+ public:
+  bool empty() const { return size_ == 0; }
+  void push(const T& element) {
+    assert(size_ < Capacity);
+    data_[size_++] = element;
+  }
+  const T& top() const {
+    assert(size_ > 0);
+    return data_[size_ - 1];
+  }
+  void pop() {
+    assert(size_ > 0);
+    size_--;
+  }
+
+ private:
+  std::array<T, Capacity> data_;
+  std::size_t size_{0};
+};
+
+/// The cross-section of an OBB (in the heightmap frame) with the slab
+/// y_0 <= y <= y_1, which is a convex polytope whose vertices are either
+/// the corners of the OBB in the slab or the intersections of its edges
+/// with the two planes. Thus, its x range and min z are attained on them.
+template <typename S>
+class HeightMapOBBScanline {
+ public:
+  explicit HeightMapOBBScanline(const OBB<S>& obb) {
+    for (int i = 0; i < 8; i++) {
+      const Vector3<S> sign((i & 1) ? S(1.0) : S(-1.0),
+                            (i & 2) ? S(1.0) : S(-1.0),
+                            (i & 4) ? S(1.0) : S(-1.0));
+      corners_[i] = obb.To + obb.axis * sign.cwiseProduct(obb.extent);
+    }
+  }
+
+  /// Return false if the slab does not intersect the OBB
+  bool sliceY(S y_0, S y_1, S& x_min, S& x_max, S& z_min) const {
+    bool is_empty = true;
+    auto add_point = [&](const Vector3<S>& point) {
+      if (is_empty) {
+        x_min = x_max = point.x();
+        z_min = point.z();
+        is_empty = false;
+        return;
+      }
+      x_min = std::min(x_min, point.x());
+      x_max = std::max(x_max, point.x());
+      z_min = std::min(z_min, point.z());
+    };
+
+    for (int i = 0; i < 8; i++) {
+      const Vector3<S>& corner = corners_[i];
+      if (corner.y() >= y_0 && corner.y() <= y_1) add_point(corner);
+
+      // The 12 edges connect the corners that differ in one bit
+      for (int bit = 1; bit < 8; bit <<= 1) {
+        if (i & bit) continue;
+        const Vector3<S>& other = corners_[i | bit];
+        for (const S plane_y : {y_0, y_1}) {
+          const S d_0 = corner.y() - plane_y;
+          const S d_1 = other.y() - plane_y;
+          if ((d_0 < S(0.0)) == (d_1 < S(0.0)) || d_0 == d_1) continue;
+          add_point(corner + (d_0 / (d_0 - d_1)) * (other - corner));
+        }
+      }
+    }
+    return !is_empty;
+  }
+
+ private:
+  std::array<Vector3<S>, 8> corners_;
+};
+
+/// The pixels of row y in roi under the OBB, and the min z of the OBB over
+/// that row. Return false if the OBB does not cover any pixel of the row.
+template <typename S>
+bool heightMapOBBRowROI(const heightmap::FlatHeightMap<S>& heightmap,
+                        const HeightMapOBBScanline<S>& scanline,
+                        const heightmap::PixelSpaceROI& roi, uint16_t y,
+                        S& z_min, heightmap::PixelSpaceROI& row_roi) {
+  using heightmap::Pixel;
+  using heightmap::PixelToPoint2DType;
+  heightmap::Point2D<S> row_min, row_max;
+  heightmap.pixelToPoint2D(Pixel(roi.top_left.x, y), row_min,
+                           PixelToPoint2DType::TopLeft);
+  heightmap.pixelToPoint2D(Pixel(roi.top_left.x, y), row_max,
+                           PixelToPoint2DType::BottomRight);
+  S x_min, x_max;
+  if (!scanline.sliceY(row_min.y(), row_max.y(), x_min, x_max, z_min)) {
+    return false;
+  }
+
+  // Convert to pixels and clamp by the roi
+  const int x_begin = std::max<int>(
+      static_cast<int>(std::floor(x_min / heightmap.resolution_x())) +
+          heightmap.half_shape_x(),
+      roi.top_left.x);
+  const int x_end = std::min<int>(
+      static_cast<int>(std::floor(x_max / heightmap.resolution_x())) +
+          heightmap.half_shape_x(),
+      roi.bottom_right.x);
+  if (x_begin > x_end) return false;
+  row_roi.top_left = Pixel(static_cast<uint16_t>(x_begin), y);
+  row_roi.bottom_right = Pixel(static_cast<uint16_t>(x_end), y);
+  return true;
+}
+
+/// The bottom pixels of the second heightmap mapped onto the ones of the
+/// first heightmap by p_1 = rotation * p_2 + offset, where the rotation is
+/// a yaw of multiple of 90 degrees. z_offset is the height of the second
+/// heightmap plane in the frame of the first one.
+template <typename S>
+struct HeightMapGridAlignment {
+  int cos_yaw{1};
+  int sin_yaw{0};
+  int offset_x{0};
+  int offset_y{0};
+  S z_offset{0};
+
+  void map2To1(int x_2, int y_2, int& x_1, int& y_1) const {
+    x_1 = cos_yaw * x_2 - sin_yaw * y_2 + offset_x;
+    y_1 = sin_yaw * x_2 + cos_yaw * y_2 + offset_y;
+  }
+  void map1To2(int x_1, int y_1, int& x_2, int& y_2) const {
+    x_2 = cos_yaw * (x_1 - offset_x) + sin_yaw * (y_1 - offset_y);
+    y_2 = -sin_yaw * (x_1 - offset_x) + cos_yaw * (y_1 - offset_y);
+  }
+};
+
+/// Compute the alignment given the pose of heightmap 2 in the frame of
+/// heightmap 1. Return false if the pixel grids do not coincide, where
+/// the mismatch of any point of heightmap 2 must be within a tolerance
+/// relative to the resolution.
+template <typename S>
+bool computeHeightMapGridAlignment(const heightmap::FlatHeightMap<S>& hm_1,
+                                   const heightmap::FlatHeightMap<S>& hm_2,
+                                   const Transform3<S>& tf_2_in_1,
+                                   HeightMapGridAlignment<S>& alignment) {
+  constexpr S kRelativeTolerance = 1e-4;
+  const S resolution = hm_1.resolution_x();
+  const S tolerance = kRelativeTolerance * resolution;
+  for (const S resolution_i :
+       {hm_1.resolution_y(), hm_2.resolution_x(), hm_2.resolution_y()}) {
+    if (std::abs(resolution_i - resolution) > S(1e-6) * resolution) {
+      return false;
+    }
+  }
+
+  // The rotation must be a yaw of multiple of 90 degrees
+  const Matrix3<S>& rotation = tf_2_in_1.linear();
+  alignment.cos_yaw = static_cast<int>(std::round(rotation(0, 0)));
+  alignment.sin_yaw = static_cast<int>(std::round(rotation(1, 0)));
+  if (std::abs(alignment.cos_yaw) + std::abs(alignment.sin_yaw) != 1) {
+    return false;
+  }
+  Matrix3<S> grid_rotation = Matrix3<S>::Identity();
+  grid_rotation(0, 0) = grid_rotation(1, 1) = S(alignment.cos_yaw);
+  grid_rotation(1, 0) = S(alignment.sin_yaw);
+  grid_rotation(0, 1) = -S(alignment.sin_yaw);
+  const S max_point_norm =
+      std::sqrt(hm_2.half_range_x() * hm_2.half_range_x() +
+                hm_2.half_range_y() * hm_2.half_range_y()) +
+      hm_2.height_upper_bound_meter();
+  const S rotation_error = (rotation - grid_rotation).cwiseAbs().maxCoeff();
+  if (S(3.0) * rotation_error * max_point_norm > tolerance) return false;
+
+  // The center of pixel (x, y) is ((x - half_shape_x + 0.5) * resolution,
+  // (y - half_shape_y + 0.5) * resolution), the offset must be integer
+  const Vector3<S>& translation = tf_2_in_1.translation();
+  const S center_2_x = S(0.5) - S(hm_2.half_shape_x());
+  const S center_2_y = S(0.5) - S(hm_2.half_shape_y());
+  const S offset_x = S(alignment.cos_yaw) * center_2_x -
+                     S(alignment.sin_yaw) * center_2_y +
+                     translation.x() / resolution - S(0.5) +
+                     S(hm_1.half_shape_x());
+  const S offset_y = S(alignment.sin_yaw) * center_2_x +
+                     S(alignment.cos_yaw) * center_2_y +
+                     translation.y() / resolution - S(0.5) +
+                     S(hm_1.half_shape_y());
+  alignment.offset_x = static_cast<int>(std::round(offset_x));
+  alignment.offset_y = static_cast<int>(std::round(offset_y));
+  if (std::abs(offset_x - S(alignment.offset_x)) * resolution > tolerance ||
+      std::abs(offset_y - S(alignment.offset_y)) * resolution > tolerance) {
+    return false;
+  }
+  alignment.z_offset = translation.z();
+  return true;
+}
+
+/// The roi of a layer that covers the bottom_roi, where each upper layer
+/// halves the pixel coordinate.
+inline heightmap::PixelSpaceROI bottomROIToLayerROI(
+    const heightmap::PixelSpaceROI& bottom_roi, std::size_t n_layers_above) {
+  heightmap::PixelSpaceROI roi = bottom_roi;
+  roi.top_left.x >>= n_layers_above;
+  roi.top_left.y >>= n_layers_above;
+  roi.bottom_right.x >>= n_layers_above;
+  roi.bottom_right.y >>= n_layers_above;
+  return roi;
+}
+
+inline std::size_t pixelSpaceROISize(const heightmap::PixelSpaceROI& roi) {
+  if (roi.bottom_right.x < roi.top_left.x ||
+      roi.bottom_right.y < roi.top_left.y)
+    return 0;
+  return std::size_t(roi.bottom_right.x - roi.top_left.x + 1) *
+         std::size_t(roi.bottom_right.y - roi.top_left.y + 1);
+}
+
+/// The traversal of heightmap-shape is seeded from the deepest layer where
+/// the roi covers no more than this number of pixels (or the top layer).
+constexpr std::size_t kHeightMapMaxSeedPixels = 16;
+
+template <typename S>
+std::size_t heightMapSeedLayer(const heightmap::LayeredHeightMap<S>& height_map,
+                               const heightmap::PixelSpaceROI& bottom_roi) {
+  std::size_t seed_layer = 0;
+  const std::size_t bottom_layer = height_map.n_layers() - 1;
+  for (std::size_t layer = 1; layer <= bottom_layer; layer++) {
+    const heightmap::PixelSpaceROI layer_roi =
+        bottomROIToLayerROI(bottom_roi, bottom_layer - layer);
+    if (pixelSpaceROISize(layer_roi) > kHeightMapMaxSeedPixels) break;
+    seed_layer = layer;
+  }
+  return seed_layer;
+}
+
 template <typename S>
 bool heightMapNodeToAABB(const heightmap::LayeredHeightMap<S>& height_map,
                          const HeightMapNode& node, AABB<S>& aabb) {
@@ -18,6 +250,62 @@ bool heightMapNodeToAABB(const heightmap::LayeredHeightMap<S>& height_map,
   return hm_layer.pixelToBox(node.pixel, aabb);
 }
 
+/// The core of a node is the sub-column [0, min height] of its footprint,
+/// which is fully occupied. Return false if the core is empty.
+template <typename S>
+bool heightMapNodeToCoreAABB(const heightmap::LayeredHeightMap<S>& height_map,
+                             const HeightMapNode& node, AABB<S>& core) {
+  const uint16_t min_height_in_mm =
+      height_map.pixelMinHeight(node.layer, node.pixel);
+  if (min_height_in_mm == 0) return false;
+  if (!heightMapNodeToAABB<S>(height_map, node, core)) return false;
+  core.max_.z() = static_cast<S>(min_height_in_mm) * S(0.001);
+  return true;
+}
+
+/// Descend from a pair of nodes whose cores overlap to a pair of bottom
+/// pixels that overlap, by following the children whose cores overlap.
+/// As the cores of the children cover the core of their parent, such a
+/// child always exists up to the numerical error of the disjoint test.
+/// On success, the nodes and cores are updated to the bottom pixels.
+template <typename S>
+bool heightMapPairDescendByCores(
+    const heightmap::LayeredHeightMap<S>& hm_1,
+    const heightmap::LayeredHeightMap<S>& hm_2,
+    const FixedRotationBoxDisjoint<S>& obb_disjoint, HeightMapNode& node_1,
+    HeightMapNode& node_2, AABB<S>& core_1, AABB<S>& core_2) {
+  using heightmap::Pixel;
+  while (!(hm_1.is_bottom_layer(node_1.layer) &&
+           hm_2.is_bottom_layer(node_2.layer))) {
+    // The same expansion rule as heightMapPairIntersect
+    bool continue_on_1 = hm_2.is_bottom_layer(node_2.layer);
+    continue_on_1 |= ((!hm_1.is_bottom_layer(node_1.layer)) &&
+                      node_1.layer < node_2.layer);
+    const heightmap::LayeredHeightMap<S>& hm = continue_on_1 ? hm_1 : hm_2;
+    HeightMapNode& parent = continue_on_1 ? node_1 : node_2;
+    AABB<S>& parent_core = continue_on_1 ? core_1 : core_2;
+
+    bool found_child = false;
+    for (uint16_t i = 0; i < 4 && !found_child; i++) {
+      const Pixel child_pixel(
+          static_cast<uint16_t>(parent.pixel.x * 2 + (i & 1)),
+          static_cast<uint16_t>(parent.pixel.y * 2 + (i >> 1)));
+      const HeightMapNode child{parent.layer + 1, child_pixel};
+      AABB<S> child_core;
+      if (!heightMapNodeToCoreAABB<S>(hm, child, child_core)) continue;
+      const bool is_disjoint =
+          continue_on_1 ? obb_disjoint.isDisjoint(child_core, core_2, true)
+                        : obb_disjoint.isDisjoint(core_1, child_core, true);
+      if (is_disjoint) continue;
+      parent = child;
+      parent_core = child_core;
+      found_child = true;
+    }
+    if (!found_child) return false;
+  }
+  return true;
+}
+
 template <typename S>
 template <typename Shape>
 void HeightMapCollisionSolver<S>::heightMapShapeIntersectImpl(
@@ -31,6 +319,11 @@ void HeightMapCollisionSolver<S>::heightMapShapeIntersectImpl(
   AABB<S> shape_aabb_in_hm;
   computeBV(shape, tf_shape_to_map, shape_aabb_in_hm);
 
+  // Inflate by the safety margin
+  const S margin = request->binaryCollisionMargin();
+  shape_aabb_in_hm.min_.array() -= margin;
+  shape_aabb_in_hm.max_.array() += margin;
+
   // Check z
   if (shape_aabb_in_hm.max_.z() < 0) return;
   if (shape_aabb_in_hm.min_.z() > heightmap.height_upper_bound_meter()) return;
@@ -44,22 +337,33 @@ void HeightMapCollisionSolver<S>::heightMapShapeIntersectImpl(
   bool use_flat_impl = (option_code == ShapeHeightMapCollisionType::Flat);
   if ((!use_flat_impl) &&
       (option_code != ShapeHeightMapCollisionType::Traversal)) {
-    // Determine automatically by roi size
-    std::size_t total_size =
-        heightmap.full_shape_x() * heightmap.full_shape_y();
-    uint16_t roi_delta_x = roi.bottom_right.x >= roi.top_left.x
-                               ? (roi.bottom_right.x - roi.top_left.x + 1)
-                               : 0;
-    uint16_t roi_delta_y = roi.bottom_right.y >= roi.top_left.y
-                               ? (roi.bottom_right.y - roi.top_left.y + 1)
-                               : 0;
-    std::size_t roi_size = roi_delta_x * roi_delta_y;
+    // Determine automatically by the cost model
+    const std::size_t roi_size = pixelSpaceROISize(roi);
     assert(roi_size > 0);
 
-    constexpr std::size_t kSmallROI_Ratio = 8;
-    if (roi_size * kSmallROI_Ratio < total_size) {
-      use_flat_impl = true;
+    // The fraction of the heightmap-frame AABB occupied by the shape
+    AABB<S> shape_aabb_local;
+    computeBV(shape, Transform3<S>::Identity(), shape_aabb_local);
+    const S aabb_volume_in_hm = shape_aabb_in_hm.volume();
+    S fill_ratio = S(1.0);
+    if (aabb_volume_in_hm > S(0.0)) {
+      fill_ratio =
+          std::min(S(1.0), shape_aabb_local.volume() / aabb_volume_in_hm);
     }
+
+    // Seed info of the traversal
+    const LayeredHeightMap& layered_heightmap =
+        *heightmap_geometry.raw_heightmap();
+    const std::size_t seed_layer = heightMapSeedLayer(layered_heightmap, roi);
+    const std::size_t n_seeds = pixelSpaceROISize(bottomROIToLayerROI(
+        roi, layered_heightmap.n_layers() - 1 - seed_layer));
+    const std::size_t seed_depth = layered_heightmap.n_layers() - seed_layer;
+
+    const auto& cost_model = heightmap_geometry.shape_collision_cost_model();
+    use_flat_impl =
+        cost_model.flatCost(S(roi_size)) <=
+        cost_model.traversalCost(S(roi_size), fill_ratio, S(n_seeds),
+                                 S(seed_depth));
   }
 
   // Forward to impl
@@ -78,19 +382,30 @@ void HeightMapCollisionSolver<S>::flatHeightMapShapeIntersectImpl(
     const HeightMapCollisionGeometry<S>& heightmap_geometry, const Shape& shape,
     const AABB<S>& shape_aabb_in_hm, const heightmap::PixelSpaceROI& bottom_roi,
     const Transform3<S>& tf_hm, const Transform3<S>& tf_shape) const {
-  // Visit functor
-  const S half_resolution_x =
-      S(0.5) * heightmap_geometry.raw_heightmap()->bottom().resolution_x();
-  const S half_resolution_y =
-      S(0.5) * heightmap_geometry.raw_heightmap()->bottom().resolution_y();
+  // The OBB of the shape in the heightmap frame, whose cross-section with
+  // each row gives the exact interval of pixels under it
+  const FlatHeightMap& heightmap = heightmap_geometry.raw_heightmap()->bottom();
+  OBB<S> shape_obb_in_hm;
+  computeBV(shape, tf_hm.inverse() * tf_shape, shape_obb_in_hm);
+  // The narrowphase reports the touching pixels within its tolerance, thus
+  // the OBB is padded to keep them (the OBB of a box is exact). It is also
+  // inflated by the safety margin.
+  shape_obb_in_hm.extent.array() +=
+      solver->gjk_tolerance + request->binaryCollisionMargin();
+  const HeightMapOBBScanline<S> scanline(shape_obb_in_hm);
+
+  // Visit functor, row_z_min is the lower bound of the shape in this row
+  const S half_resolution_x = S(0.5) * heightmap.resolution_x();
+  const S half_resolution_y = S(0.5) * heightmap.resolution_y();
+  S row_z_min = shape_aabb_in_hm.min_.z();
+  bool terminated = false;
   auto check_collision = [&](const heightmap::Pixel& pixel,
                              const heightmap::Point2D<S>& box_bottom_center,
                              uint16_t height_in_mm) -> bool {
     // Basic check
-    (void)(box_bottom_center);
     if (height_in_mm == 0) return false;
     const S height_in_meter = static_cast<S>(height_in_mm) * S(0.001);
-    if (shape_aabb_in_hm.min_.z() > height_in_meter) {
+    if (row_z_min > height_in_meter) {
       return false;
     }
 
@@ -106,12 +421,26 @@ void HeightMapCollisionSolver<S>::flatHeightMapShapeIntersectImpl(
     // Process leaves
     boxToShapeProcessLeafPair(heightmap_geometry, tf_hm, shape, tf_shape, pixel,
                               pixel_aabb);
-    return request->terminationConditionSatisfied(*result);
+    terminated = request->terminationConditionSatisfied(*result);
+    return terminated;
   };
 
-  // Visit within roi
-  heightmap_geometry.raw_heightmap()->bottom().visitHeightMap(check_collision,
-                                                              &bottom_roi);
+  // Visit the interval of each row in roi
+  for (uint16_t y = bottom_roi.top_left.y;
+       y <= bottom_roi.bottom_right.y && !terminated; y++) {
+    heightmap::PixelSpaceROI row_roi;
+    if (!heightMapOBBRowROI(heightmap, scanline, bottom_roi, y, row_z_min,
+                            row_roi)) {
+      continue;
+    }
+    row_z_min = std::max(row_z_min, shape_aabb_in_hm.min_.z());
+
+    // Early rejection by the max height of the interval
+    const uint16_t row_max_height_in_mm = heightmap.maxHeightInRow(
+        y, row_roi.top_left.x, row_roi.bottom_right.x);
+    if (static_cast<S>(row_max_height_in_mm) * S(0.001) < row_z_min) continue;
+    heightmap.visitNonZeroHeights(check_collision, &row_roi);
+  }
 }
 
 template <typename S>
@@ -120,22 +449,18 @@ void HeightMapCollisionSolver<S>::traversalHeightMapShapeIntersectImpl(
     const HeightMapCollisionGeometry<S>& heightmap_geometry, const Shape& shape,
     const AABB<S>& shape_aabb_in_hm, const heightmap::PixelSpaceROI& bottom_roi,
     const Transform3<S>& tf_hm, const Transform3<S>& tf_shape) const {
-  // The task stack contains the element for checking
-  (void)(bottom_roi);
-  // The task stack contains the element for checking
+  // The task stack contains the element for checking, the traversal from a
+  // seed node pushes at most 3 nodes for each layer
   using heightmap::Pixel;
   const LayeredHeightMap& heightmap = *heightmap_geometry.raw_heightmap();
-  std::stack<HeightMapNode> task_stack;
+  constexpr std::size_t kMaxNumberOfLayers = 17;
+  assert(heightmap.n_layers() <= kMaxNumberOfLayers);
+  HeightMapInlineStack<HeightMapNode, 3 * kMaxNumberOfLayers + 1> task_stack;
 
-  // Init the task stack
-  {
-    const FlatHeightMap& hm_top = heightmap.top();
-    for (uint16_t y = 0; y < hm_top.full_shape_y(); y++) {
-      for (uint16_t x = 0; x < hm_top.full_shape_x(); x++) {
-        task_stack.push(HeightMapNode(0, Pixel(x, y)));
-      }
-    }
-  }
+  // Only seed from the pixels covering the roi
+  const std::size_t seed_layer = heightMapSeedLayer(heightmap, bottom_roi);
+  const heightmap::PixelSpaceROI seed_roi = bottomROIToLayerROI(
+      bottom_roi, heightmap.n_layers() - 1 - seed_layer);
 
   // Compute obb
   FixedRotationBoxDisjoint<S> obb_disjoint;
@@ -144,9 +469,11 @@ void HeightMapCollisionSolver<S>::traversalHeightMapShapeIntersectImpl(
     OBB<S> shape_obb_world;
     computeBV(shape, tf_shape, shape_obb_world);
 
-    // Convert OBB to local AABB and a tf_AABB on that AABB
-    shape_obb_local_AABB.max_ = shape_obb_world.extent;
-    shape_obb_local_AABB.min_ = -shape_obb_world.extent;
+    // Convert OBB to local AABB and a tf_AABB on that AABB, which is
+    // inflated by the safety margin
+    shape_obb_local_AABB.max_ =
+        shape_obb_world.extent.array() + request->binaryCollisionMargin();
+    shape_obb_local_AABB.min_ = -shape_obb_local_AABB.max_;
 
     // Make tf_AABB frame
     Transform3<S> tf_shape_AABB;
@@ -156,31 +483,39 @@ void HeightMapCollisionSolver<S>::traversalHeightMapShapeIntersectImpl(
     obb_disjoint.initialize(tf_hm, tf_shape_AABB);
   }
 
-  // The processing loop
-  while (!task_stack.empty()) {
-    // Pop the stack
-    const HeightMapNode hm_node = task_stack.top();
-    task_stack.pop();
-    AABB<S> aabb_local;
-    if (!heightMapNodeToAABB<S>(heightmap, hm_node, aabb_local)) continue;
-    if (!shape_aabb_in_hm.overlap(aabb_local)) continue;
+  // The processing loop for each seed
+  for (uint16_t seed_y = seed_roi.top_left.y; seed_y <= seed_roi.bottom_right.y;
+       seed_y++) {
+    for (uint16_t seed_x = seed_roi.top_left.x;
+         seed_x <= seed_roi.bottom_right.x; seed_x++) {
+      task_stack.push(
+          HeightMapNode(static_cast<int>(seed_layer), Pixel(seed_x, seed_y)));
+      while (!task_stack.empty()) {
+        // Pop the stack
+        const HeightMapNode hm_node = task_stack.top();
+        task_stack.pop();
+        AABB<S> aabb_local;
+        if (!heightMapNodeToAABB<S>(heightmap, hm_node, aabb_local)) continue;
+        if (!shape_aabb_in_hm.overlap(aabb_local)) continue;
 
-    // Check OBB
-    if (obb_disjoint.isDisjoint(aabb_local, shape_obb_local_AABB, false))
-      continue;
+        // Check OBB
+        if (obb_disjoint.isDisjoint(aabb_local, shape_obb_local_AABB, false))
+          continue;
 
-    if (heightmap.is_bottom_layer(hm_node.layer)) {
-      // Both are leaf nodes
-      boxToShapeProcessLeafPair(heightmap_geometry, tf_hm, shape, tf_shape,
-                                hm_node.pixel, aabb_local);
-      if (request->terminationConditionSatisfied(*result)) return;
-    } else {  // at least one is not leaf
-      // clang-format off
-      task_stack.push(HeightMapNode{hm_node.layer + 1, Pixel(hm_node.pixel.x * 2 + 0, hm_node.pixel.y * 2 + 0)});
-      task_stack.push(HeightMapNode{hm_node.layer + 1, Pixel(hm_node.pixel.x * 2 + 1, hm_node.pixel.y * 2 + 0)});
-      task_stack.push(HeightMapNode{hm_node.layer + 1, Pixel(hm_node.pixel.x * 2 + 0, hm_node.pixel.y * 2 + 1)});
-      task_stack.push(HeightMapNode{hm_node.layer + 1, Pixel(hm_node.pixel.x * 2 + 1, hm_node.pixel.y * 2 + 1)});
-      // clang-format on
+        if (heightmap.is_bottom_layer(hm_node.layer)) {
+          // Both are leaf nodes
+          boxToShapeProcessLeafPair(heightmap_geometry, tf_hm, shape, tf_shape,
+                                    hm_node.pixel, aabb_local);
+          if (request->terminationConditionSatisfied(*result)) return;
+        } else {  // at least one is not leaf
+          // clang-format off
+          task_stack.push(HeightMapNode{hm_node.layer + 1, Pixel(hm_node.pixel.x * 2 + 0, hm_node.pixel.y * 2 + 0)});
+          task_stack.push(HeightMapNode{hm_node.layer + 1, Pixel(hm_node.pixel.x * 2 + 1, hm_node.pixel.y * 2 + 0)});
+          task_stack.push(HeightMapNode{hm_node.layer + 1, Pixel(hm_node.pixel.x * 2 + 0, hm_node.pixel.y * 2 + 1)});
+          task_stack.push(HeightMapNode{hm_node.layer + 1, Pixel(hm_node.pixel.x * 2 + 1, hm_node.pixel.y * 2 + 1)});
+          // clang-format on
+        }
+      }
     }
   }
 }
@@ -200,6 +535,16 @@ void HeightMapCollisionSolver<S>::heightMapPairIntersect(
   };
   std::stack<TaskFrame> task_stack;
 
+  // Init for disjoint
+  FixedRotationBoxDisjoint<S> obb_disjoint;
+  obb_disjoint.initialize(tf1, tf2);
+
+  // The pixel grids coincide
+  if (heightMapPairAlignedIntersect(hm_1_geometry, hm_2_geometry, tf1, tf2,
+                                    obb_disjoint)) {
+    return;
+  }
+
   // Init the task stack
   {
     const FlatHeightMap& hm1_top = hm_1.top();
@@ -218,9 +563,12 @@ void HeightMapCollisionSolver<S>::heightMapPairIntersect(
     }
   }
 
-  // Init for disjoint
-  FixedRotationBoxDisjoint<S> obb_disjoint;
-  obb_disjoint.initialize(tf1, tf2);
+  // With the min-height channel, a pair of nodes whose cores overlap must
+  // contain a colliding pair of bottom pixels. When only one contact is
+  // required, we descend to that pair directly.
+  const bool descend_by_cores = request->maxNumContacts() == 1 &&
+                                hm_1.min_height_channel_enabled() &&
+                                hm_2.min_height_channel_enabled();
 
   // The processing loop
   while (!task_stack.empty()) {
@@ -246,6 +594,24 @@ void HeightMapCollisionSolver<S>::heightMapPairIntersect(
       // Check OBB bv
       if (obb_disjoint.isDisjoint(aabb_1, aabb_2, false)) continue;
 
+      // Check the cores
+      AABB<S> core_1, core_2;
+      if (descend_by_cores &&
+          heightMapNodeToCoreAABB<S>(hm_1, node_1, core_1) &&
+          heightMapNodeToCoreAABB<S>(hm_2, node_2, core_2) &&
+          !obb_disjoint.isDisjoint(core_1, core_2, true)) {
+        HeightMapNode leaf_1 = node_1;
+        HeightMapNode leaf_2 = node_2;
+        if (heightMapPairDescendByCores<S>(hm_1, hm_2, obb_disjoint, leaf_1,
+                                           leaf_2, core_1, core_2)) {
+          boxToBoxProcessLeafPair(
+              &hm_1_geometry, tf1, core_1, heightmap::encodePixel(leaf_1.pixel),
+              &hm_2_geometry, tf2, core_2, heightmap::encodePixel(leaf_2.pixel),
+              obb_disjoint);
+          if (request->terminationConditionSatisfied(*result)) return;
+        }
+      }
+
       // Need to continue on box
       bool continue_on_1 = hm_2.is_bottom_layer(node_2.layer);
       continue_on_1 |= ((!hm_1.is_bottom_layer(node_1.layer)) &&
@@ -293,6 +659,101 @@ void HeightMapCollisionSolver<S>::heightMapPairIntersect(
   }
 }
 
+template <typename S>
+bool HeightMapCollisionSolver<S>::heightMapPairAlignedIntersect(
+    const HeightMapCollisionGeometry<S>& hm_1_geometry,
+    const HeightMapCollisionGeometry<S>& hm_2_geometry,
+    const Transform3<S>& tf1, const Transform3<S>& tf2,
+    const FixedRotationBoxDisjoint<S>& obb_disjoint) const {
+  using heightmap::Pixel;
+  const FlatHeightMap& hm_1 = hm_1_geometry.raw_heightmap()->bottom();
+  const FlatHeightMap& hm_2 = hm_2_geometry.raw_heightmap()->bottom();
+  HeightMapGridAlignment<S> alignment;
+  if (!computeHeightMapGridAlignment(hm_1, hm_2, tf1.inverse() * tf2,
+                                     alignment)) {
+    return false;
+  }
+
+  // Two boxes [0, h_1] and [z_offset, z_offset + h_2] intersect iff
+  // h_1 >= z_offset and h_2 >= -z_offset, and both are non-zero
+  auto lower_height_in_mm = [](S lower_in_meter, uint16_t& lower) -> bool {
+    const S lower_in_mm = std::ceil(lower_in_meter * S(1000.0));
+    if (lower_in_mm > S(std::numeric_limits<uint16_t>::max())) return false;
+    lower = static_cast<uint16_t>(std::max(S(1.0), lower_in_mm));
+    return true;
+  };
+  uint16_t lower_1 = 0, lower_2 = 0;
+  if (!lower_height_in_mm(alignment.z_offset, lower_1) ||
+      !lower_height_in_mm(-alignment.z_offset, lower_2)) {
+    return true;
+  }
+
+  // The range of heightmap 2 in the pixels of heightmap 1
+  int x_1_begin = 0, y_1_begin = 0, x_1_end = 0, y_1_end = 0;
+  {
+    int corner_x_1[2], corner_y_1[2];
+    alignment.map2To1(0, 0, corner_x_1[0], corner_y_1[0]);
+    alignment.map2To1(hm_2.full_shape_x() - 1, hm_2.full_shape_y() - 1,
+                      corner_x_1[1], corner_y_1[1]);
+    x_1_begin = std::max(0, std::min(corner_x_1[0], corner_x_1[1]));
+    y_1_begin = std::max(0, std::min(corner_y_1[0], corner_y_1[1]));
+    x_1_end = std::min(hm_1.full_shape_x() - 1,
+                       std::max(corner_x_1[0], corner_x_1[1]));
+    y_1_end = std::min(hm_1.full_shape_y() - 1,
+                       std::max(corner_y_1[0], corner_y_1[1]));
+    if (x_1_begin > x_1_end || y_1_begin > y_1_end) return true;
+  }
+
+  // Along a row of heightmap 1, the pixel of heightmap 2 moves by
+  // (cos_yaw, -sin_yaw), which is either a row or a column of heightmap 2
+  const std::size_t n_columns = x_1_end - x_1_begin + 1;
+  const int step_x_2 = alignment.cos_yaw;
+  const int step_y_2 = -alignment.sin_yaw;
+  std::vector<uint16_t> row_1(n_columns), row_2(n_columns);
+  std::vector<uint16_t> columns(n_columns);
+  for (int y_1 = y_1_begin; y_1 <= y_1_end; y_1++) {
+    // Resample heightmap 2 into this row
+    int x_2_begin, y_2_begin, x_2_end, y_2_end;
+    alignment.map1To2(x_1_begin, y_1, x_2_begin, y_2_begin);
+    alignment.map1To2(x_1_end, y_1, x_2_end, y_2_end);
+    if (step_y_2 == 0) {
+      hm_2.copyRow(static_cast<uint16_t>(y_2_begin),
+                   static_cast<uint16_t>(std::min(x_2_begin, x_2_end)),
+                   static_cast<uint16_t>(std::max(x_2_begin, x_2_end)),
+                   row_2.data());
+    } else {
+      hm_2.copyColumn(static_cast<uint16_t>(x_2_begin),
+                      static_cast<uint16_t>(std::min(y_2_begin, y_2_end)),
+                      static_cast<uint16_t>(std::max(y_2_begin, y_2_end)),
+                      row_2.data());
+    }
+    if (step_x_2 + step_y_2 < 0) std::reverse(row_2.begin(), row_2.end());
+    hm_1.copyRow(static_cast<uint16_t>(y_1), static_cast<uint16_t>(x_1_begin),
+                 static_cast<uint16_t>(x_1_end), row_1.data());
+
+    // Compare the columns and process the pairs
+    const std::size_t n_found = heightmap::internal::findColumnsAboveBoth(
+        row_1.data(), row_2.data(), n_columns, lower_1, lower_2,
+        columns.data());
+    for (std::size_t i = 0; i < n_found; i++) {
+      const int column = columns[i];
+      const Pixel pixel_1(static_cast<uint16_t>(x_1_begin + column),
+                          static_cast<uint16_t>(y_1));
+      const Pixel pixel_2(static_cast<uint16_t>(x_2_begin + step_x_2 * column),
+                          static_cast<uint16_t>(y_2_begin + step_y_2 * column));
+      AABB<S> aabb_1, aabb_2;
+      hm_1.pixelToBox(pixel_1, aabb_1);
+      hm_2.pixelToBox(pixel_2, aabb_2);
+      boxToBoxProcessLeafPair(
+          &hm_1_geometry, tf1, aabb_1, heightmap::encodePixel(pixel_1),
+          &hm_2_geometry, tf2, aabb_2, heightmap::encodePixel(pixel_2),
+          obb_disjoint);
+      if (request->terminationConditionSatisfied(*result)) return true;
+    }
+  }
+  return true;
+}
+
 template <typename S>
 template <typename BV>
 void HeightMapCollisionSolver<S>::heightMapBVHIntersect(
@@ -13,6 +13,7 @@
 #include "fcl/narrowphase/collision_request.h"
 #include "fcl/narrowphase/detail/gjk_solver.h"
 #include "fcl/narrowphase/detail/shape_pair_intersect.h"
+#include "fcl/narrowphase/detail/traversal/octree2/octree2_swept_sphere.h"
 
 namespace fcl {
 namespace detail {
@@ -59,6 +60,18 @@ class CollisionSolverOctree2 {
     Transform3<S> shape1_tf, shape2_tf;
     Box<S> box1, box2;
     ContactMeta<S> contact_meta;
+
+    // The buffered leaf pairs of box and shape, see boxToShapeBufferLeafPair
+    static constexpr std::size_t kLeafBatchSize =
+        GJKSolver<S>::kShapeIntersectBatchSize;
+    struct LeafBatch {
+      std::size_t n{0};
+      std::int64_t encoded_octree_node_idx[kLeafBatchSize];
+      AABB<S> voxel_aabb[kLeafBatchSize];
+      Box<S> box[kLeafBatchSize];
+      Transform3<S> box_tf[kLeafBatchSize];
+      bool intersect[kLeafBatchSize];
+    } leaf_batch;
   };
 
   template <typename Shape>
@@ -74,6 +87,35 @@ class CollisionSolverOctree2 {
                                  std::int64_t encoded_octree_node_idx,
                                  const AABB<S>& voxel_aabb,
                                  OctreeLeafComputeCache& cache) const;
+  /// If GJKSolver::use_mpr_batch and penetration is not required, the leaf
+  /// pairs of box and the shapes in ShapeIntersectBatchByMPR are buffered
+  /// and then evaluated by GJKSolver::shapeIntersectBatch, other pairs are
+  /// processed immediately. The contacts are added in the same order as
+  /// boxToShapeProcessLeafPair, but a batch might be evaluated after the
+  /// termination condition is satisfied by its first pairs.
+  /// Both of them return whether the termination condition is satisfied.
+  template <typename Shape>
+  bool boxToShapeBufferLeafPair(const Octree2CollisionGeometry<S>& octree,
+                                const Transform3<S>& tf_octree,
+                                const Shape& shape,
+                                const Transform3<S>& tf_shape,
+                                std::int64_t encoded_octree_node_idx,
+                                const AABB<S>& voxel_aabb,
+                                OctreeLeafComputeCache& cache) const;
+  template <typename Shape>
+  bool boxToShapeFlushLeafBatch(const Octree2CollisionGeometry<S>& octree,
+                                const Transform3<S>& tf_octree,
+                                const Shape& shape,
+                                const Transform3<S>& tf_shape,
+                                OctreeLeafComputeCache& cache) const;
+  template <typename Shape>
+  void sweptSphereProcessLeafPair(const Octree2CollisionGeometry<S>& octree,
+                                  const Transform3<S>& tf_octree,
+                                  const Shape& shape,
+                                  const Transform3<S>& tf_shape,
+                                  std::int64_t encoded_octree_node_idx,
+                                  const AABB<S>& voxel_aabb,
+                                  OctreeLeafComputeCache& cache) const;
 
   /// Collision between heightmap and bvh
  public:
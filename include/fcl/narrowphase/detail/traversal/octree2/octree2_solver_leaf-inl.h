@@ -41,6 +41,105 @@ void CollisionSolverOctree2<S>::boxToShapeProcessLeafPair(
       box, box_tf, shape, tf_shape, *request, contact, *result);
 }
 
+template <typename S>
+template <typename Shape>
+bool CollisionSolverOctree2<S>::boxToShapeBufferLeafPair(
+    const Octree2CollisionGeometry<S>& octree, const Transform3<S>& tf_octree,
+    const Shape& shape, const Transform3<S>& tf_shape,
+    std::int64_t encoded_octree_node_idx, const AABB<S>& voxel_aabb,
+    OctreeLeafComputeCache& cache) const {
+  const bool use_batch =
+      ShapeIntersectBatchByMPR<S, Box<S>, Shape>::value &&
+      solver->use_mpr_batch && (!request->isPenetrationEnabled()) &&
+      request->binaryCollisionMargin() <= S(0);
+  if (!use_batch) {
+    boxToShapeProcessLeafPair<Shape>(octree, tf_octree, shape, tf_shape,
+                                     encoded_octree_node_idx, voxel_aabb,
+                                     cache);
+    return request->terminationConditionSatisfied(*result);
+  }
+
+  // Push into the batch
+  auto& batch = cache.leaf_batch;
+  assert(batch.n < OctreeLeafComputeCache::kLeafBatchSize);
+  batch.encoded_octree_node_idx[batch.n] = encoded_octree_node_idx;
+  batch.voxel_aabb[batch.n] = voxel_aabb;
+  batch.n++;
+  if (batch.n < OctreeLeafComputeCache::kLeafBatchSize) return false;
+  return boxToShapeFlushLeafBatch<Shape>(octree, tf_octree, shape, tf_shape,
+                                         cache);
+}
+
+template <typename S>
+template <typename Shape>
+bool CollisionSolverOctree2<S>::boxToShapeFlushLeafBatch(
+    const Octree2CollisionGeometry<S>& octree, const Transform3<S>& tf_octree,
+    const Shape& shape, const Transform3<S>& tf_shape,
+    OctreeLeafComputeCache& cache) const {
+  auto& batch = cache.leaf_batch;
+  const std::size_t n_pairs = batch.n;
+  batch.n = 0;
+  if (n_pairs == 0 || result->numContacts() >= request->maxNumContacts() ||
+      !shape.isOccupied()) {
+    return request->terminationConditionSatisfied(*result);
+  }
+
+  // Run solver
+  for (std::size_t i = 0; i < n_pairs; i++) {
+    constructBox(batch.voxel_aabb[i], tf_octree, batch.box[i],
+                 batch.box_tf[i]);
+  }
+  solver->shapeIntersectBatch(batch.box, batch.box_tf, shape, tf_shape,
+                              n_pairs, batch.intersect);
+
+  // Write the contacts in the order of the pairs
+  auto& contact = cache.contact_meta;
+  for (std::size_t i = 0; i < n_pairs; i++) {
+    if (!batch.intersect[i]) continue;
+    if (result->numContacts() >= request->maxNumContacts()) break;
+    contact.reset();
+    contact.o1 = &octree;
+    contact.o2 = &shape;
+    contact.b1 = batch.encoded_octree_node_idx[i];
+    contact.b2 = Contact<S>::NONE;
+    contact.o1_bv = batch.voxel_aabb[i];
+    Contact<S> this_contact;
+    contact.writeToContact(this_contact);
+    result->addContact(this_contact);
+  }
+  return request->terminationConditionSatisfied(*result);
+}
+
+template <typename S>
+template <typename Shape>
+void CollisionSolverOctree2<S>::sweptSphereProcessLeafPair(
+    const Octree2CollisionGeometry<S>& octree, const Transform3<S>& tf_octree,
+    const Shape& shape, const Transform3<S>& tf_shape,
+    std::int64_t encoded_octree_node_idx, const AABB<S>& voxel_aabb,
+    OctreeLeafComputeCache& cache) const {
+  // The penetration still requires the solver
+  if (request->isPenetrationEnabled()) {
+    boxToShapeProcessLeafPair<Shape>(octree, tf_octree, shape, tf_shape,
+                                     encoded_octree_node_idx, voxel_aabb,
+                                     cache);
+    return;
+  }
+
+  // Already tested analytically, just write the contact
+  if (result->numContacts() >= request->maxNumContacts()) return;
+  if (!shape.isOccupied()) return;
+  auto& contact = cache.contact_meta;
+  contact.reset();
+  contact.o1 = &octree;
+  contact.o2 = &shape;
+  contact.b1 = encoded_octree_node_idx;
+  contact.b2 = Contact<S>::NONE;
+  contact.o1_bv = voxel_aabb;
+  Contact<S> this_contact;
+  contact.writeToContact(this_contact);
+  result->addContact(this_contact);
+}
+
 template <typename S>
 void CollisionSolverOctree2<S>::boxToSimplexProcessLeafPair(
     const Octree2CollisionGeometry<S>& octree, const Transform3<S>& tf_octree,
@@ -22,7 +22,8 @@ void CollisionSolverOctree2<S>::octreeShapeIntersectImpl(
   const bool try_prune_inner_nodes = (prune_internal_nodes != nullptr);
   assert(inner_nodes.size() == inner_nodes_full.size());
 
-  // Make disjoint
+  // Make disjoint, the shape is inflated by the safety margin
+  const S margin = request->binaryCollisionMargin();
   FixedRotationBoxDisjoint<S> disjoint;
   AABB<S> shape_local_AABB;
   {
@@ -31,8 +32,8 @@ void CollisionSolverOctree2<S>::octreeShapeIntersectImpl(
     computeBV(shape, tf_shape, shape_obb_world);
 
     // Convert OBB to local AABB and a tf_AABB on that AABB
-    shape_local_AABB.max_ = shape_obb_world.extent;
-    shape_local_AABB.min_ = -shape_obb_world.extent;
+    shape_local_AABB.max_ = shape_obb_world.extent.array() + margin;
+    shape_local_AABB.min_ = -shape_local_AABB.max_;
 
     // Make tf_AABB frame
     Transform3<S> tf_shape_AABB;
@@ -42,10 +43,17 @@ void CollisionSolverOctree2<S>::octreeShapeIntersectImpl(
     disjoint.initialize(tf_octree, tf_shape_AABB);
   }
 
+  // Sphere and capsule are tested analytically in the octree frame
+  Octree2SweptSphere<S> swept_sphere;
+  const bool use_swept_sphere =
+      makeOctree2SweptSphere(shape, tf_octree, tf_shape, swept_sphere);
+  swept_sphere.radius += margin;
+
   // Make the stack
   using StackElement = octree2::OctreeTraverseStackElement<S>;
   std::stack<StackElement> task_stack;
   task_stack.push(StackElement::MakeRoot(octree_geom.octree_root_bv()));
+  cache.leaf_batch.n = 0;
 
   // Process loop
   AABB<S> local_aabb;
@@ -66,6 +74,37 @@ void CollisionSolverOctree2<S>::octreeShapeIntersectImpl(
     if (is_disjoint) {
       continue;
     }
+    if (use_swept_sphere && !sweptSphereAABBOverlap(swept_sphere, this_task.bv))
+      continue;
+
+    // Test all the children of the leaf at once
+    if (use_swept_sphere && this_task.is_leaf_node) {
+      assert(this_task.node_vector_index < leaf_nodes.size());
+      const auto& leaf_node = leaf_nodes[this_task.node_vector_index];
+      if (leaf_node.is_fully_occupied()) {
+        const auto encoded_node_idx =
+            encodeOctree2Node(this_task.node_vector_index, true);
+        sweptSphereProcessLeafPair<Shape>(octree_geom, tf_octree, shape,
+                                          tf_shape, encoded_node_idx,
+                                          this_task.bv, cache);
+        if (request->terminationConditionSatisfied(*result)) return;
+        continue;
+      }
+
+      const octree2::Bitset8 overlapped = sweptSphereLeafChildrenOverlap(
+          swept_sphere, this_task.bv, leaf_node.child_occupied);
+      for (std::uint8_t child_i = 0; child_i < 8; child_i++) {
+        if (!overlapped.test_i(child_i)) continue;
+        octree2::computeChildAABB(this_task.bv, child_i, local_aabb);
+        const auto encoded_node_idx =
+            encodeOctree2Node(this_task.node_vector_index, true, child_i);
+        sweptSphereProcessLeafPair<Shape>(octree_geom, tf_octree, shape,
+                                          tf_shape, encoded_node_idx,
+                                          local_aabb, cache);
+        if (request->terminationConditionSatisfied(*result)) return;
+      }
+      continue;
+    }
 
     // If this is a leaf
     if (this_task.is_leaf_node) {
@@ -74,10 +113,10 @@ void CollisionSolverOctree2<S>::octreeShapeIntersectImpl(
       if (leaf_node.is_fully_occupied()) {
         const auto encoded_node_idx =
             encodeOctree2Node(this_task.node_vector_index, true);
-        boxToShapeProcessLeafPair<Shape>(octree_geom, tf_octree, shape,
-                                         tf_shape, encoded_node_idx,
-                                         this_task.bv, cache);
-        if (request->terminationConditionSatisfied(*result)) return;
+        if (boxToShapeBufferLeafPair<Shape>(octree_geom, tf_octree, shape,
+                                            tf_shape, encoded_node_idx,
+                                            this_task.bv, cache))
+          return;
       } else {
         // Not fully occupied
         assert(!leaf_node.is_fully_occupied());
@@ -88,10 +127,10 @@ void CollisionSolverOctree2<S>::octreeShapeIntersectImpl(
           // Invoke processor
           const auto encoded_node_idx =
               encodeOctree2Node(this_task.node_vector_index, true, child_i);
-          boxToShapeProcessLeafPair<Shape>(octree_geom, tf_octree, shape,
-                                           tf_shape, encoded_node_idx,
-                                           local_aabb, cache);
-          if (request->terminationConditionSatisfied(*result)) return;
+          if (boxToShapeBufferLeafPair<Shape>(octree_geom, tf_octree, shape,
+                                              tf_shape, encoded_node_idx,
+                                              local_aabb, cache))
+            return;
         }
       }
 
@@ -110,9 +149,17 @@ void CollisionSolverOctree2<S>::octreeShapeIntersectImpl(
       // Handle the node here
       const auto encoded_node_idx =
           encodeOctree2Node(this_task.node_vector_index, false);
-      boxToShapeProcessLeafPair<Shape>(octree_geom, tf_octree, shape, tf_shape,
-                                       encoded_node_idx, this_task.bv, cache);
-      if (request->terminationConditionSatisfied(*result)) return;
+      if (use_swept_sphere) {
+        sweptSphereProcessLeafPair<Shape>(octree_geom, tf_octree, shape,
+                                          tf_shape, encoded_node_idx,
+                                          this_task.bv, cache);
+        if (request->terminationConditionSatisfied(*result)) return;
+      } else {
+        if (boxToShapeBufferLeafPair<Shape>(octree_geom, tf_octree, shape,
+                                            tf_shape, encoded_node_idx,
+                                            this_task.bv, cache))
+          return;
+      }
 
       // To next node
       continue;
@@ -131,6 +178,10 @@ void CollisionSolverOctree2<S>::octreeShapeIntersectImpl(
       task_stack.push(std::move(child_frame));
     }
   }
+
+  // The remaining buffered leaf pairs
+  boxToShapeFlushLeafBatch<Shape>(octree_geom, tf_octree, shape, tf_shape,
+                                  cache);
 }
 
 template <typename S>
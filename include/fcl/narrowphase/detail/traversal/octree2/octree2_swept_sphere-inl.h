@@ -0,0 +1,182 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+namespace fcl {
+namespace detail {
+
+template <typename S, typename Shape>
+bool makeOctree2SweptSphere(const Shape&, const Transform3<S>&,
+                            const Transform3<S>&, Octree2SweptSphere<S>&) {
+  return false;
+}
+
+template <typename S>
+bool makeOctree2SweptSphere(const Sphere<S>& sphere,
+                            const Transform3<S>& tf_octree,
+                            const Transform3<S>& tf_shape,
+                            Octree2SweptSphere<S>& swept_sphere) {
+  swept_sphere.p0 = tf_octree.inverse(Eigen::Isometry) * tf_shape.translation();
+  swept_sphere.p1 = swept_sphere.p0;
+  swept_sphere.radius = sphere.radius;
+  swept_sphere.segment_aabb = AABB<S>(swept_sphere.p0);
+  return true;
+}
+
+template <typename S>
+bool makeOctree2SweptSphere(const Capsule<S>& capsule,
+                            const Transform3<S>& tf_octree,
+                            const Transform3<S>& tf_shape,
+                            Octree2SweptSphere<S>& swept_sphere) {
+  // The capsule is along the z axis of its frame
+  const Transform3<S> tf_shape_in_octree =
+      tf_octree.inverse(Eigen::Isometry) * tf_shape;
+  const Vector3<S> half_axis =
+      tf_shape_in_octree.linear().col(2) * (S(0.5) * capsule.lz);
+  swept_sphere.p0 = tf_shape_in_octree.translation() - half_axis;
+  swept_sphere.p1 = tf_shape_in_octree.translation() + half_axis;
+  swept_sphere.radius = capsule.radius;
+  swept_sphere.segment_aabb = AABB<S>(swept_sphere.p0, swept_sphere.p1);
+  return true;
+}
+
+template <typename S>
+S segmentAABBSquaredDistance(const Vector3<S>& p0, const Vector3<S>& p1,
+                             const Vector3<S>& box_min,
+                             const Vector3<S>& box_max) {
+  // The squared distance along p0 + t * d is convex and piecewise quadratic
+  // in t, with breaks where the point crosses a face plane of the box
+  const Vector3<S> d = p1 - p0;
+  std::array<S, 8> breaks;
+  int n_breaks = 0;
+  breaks[n_breaks++] = S(0.0);
+  breaks[n_breaks++] = S(1.0);
+  for (auto i = 0; i < 3; i++) {
+    if (d[i] == S(0.0)) continue;
+    const S t_min = (box_min[i] - p0[i]) / d[i];
+    const S t_max = (box_max[i] - p0[i]) / d[i];
+    if (t_min > S(0.0) && t_min < S(1.0)) breaks[n_breaks++] = t_min;
+    if (t_max > S(0.0) && t_max < S(1.0)) breaks[n_breaks++] = t_max;
+  }
+  std::sort(breaks.begin(), breaks.begin() + n_breaks);
+
+  // Minimize the quadratic within each piece
+  S min_distance_square = std::numeric_limits<S>::max();
+  for (int piece = 0; piece + 1 < n_breaks; piece++) {
+    const S t_a = breaks[piece];
+    const S t_b = breaks[piece + 1];
+    const S t_mid = S(0.5) * (t_a + t_b);
+    S a = 0, b = 0, c = 0;
+    for (auto i = 0; i < 3; i++) {
+      const S x_mid = p0[i] + t_mid * d[i];
+      S offset;
+      if (x_mid < box_min[i]) {
+        offset = p0[i] - box_min[i];
+      } else if (x_mid > box_max[i]) {
+        offset = p0[i] - box_max[i];
+      } else {
+        continue;
+      }
+      a += d[i] * d[i];
+      b += S(2.0) * offset * d[i];
+      c += offset * offset;
+    }
+
+    S t = t_a;
+    if (a > S(0.0)) t = std::min(t_b, std::max(t_a, -b / (S(2.0) * a)));
+    const S distance_square = std::max(S(0.0), (a * t + b) * t + c);
+    min_distance_square = std::min(min_distance_square, distance_square);
+    if (min_distance_square == S(0.0)) break;
+  }
+  return min_distance_square;
+}
+
+template <typename S>
+bool sweptSphereAABBOverlap(const Octree2SweptSphere<S>& swept_sphere,
+                            const AABB<S>& bv) {
+  const S radius_square = swept_sphere.radius * swept_sphere.radius;
+
+  // Lower bound by the box of the segment, which is exact for sphere
+  S distance_square = 0;
+  for (auto i = 0; i < 3; i++) {
+    const S gap = std::max(
+        {bv.min_[i] - swept_sphere.segment_aabb.max_[i],
+         swept_sphere.segment_aabb.min_[i] - bv.max_[i], S(0.0)});
+    distance_square += gap * gap;
+  }
+  if (distance_square > radius_square) return false;
+  if (swept_sphere.p0 == swept_sphere.p1) return true;
+
+  return segmentAABBSquaredDistance(swept_sphere.p0, swept_sphere.p1, bv.min_,
+                                    bv.max_) <= radius_square;
+}
+
+namespace internal {
+
+/// Squared distance from the 8 children of a node to a box (or a point if
+/// query_min == query_max), computed in lanes
+template <typename S>
+void octreeChildrenSquaredDistance(const AABB<S>& parent_bv,
+                                   const Vector3<S>& query_min,
+                                   const Vector3<S>& query_max,
+                                   std::array<S, 8>& distance_square) {
+  const Vector3<S> half_size = S(0.5) * (parent_bv.max_ - parent_bv.min_);
+  distance_square.fill(S(0.0));
+  for (auto i = 0; i < 3; i++) {
+    // The children with bit i set are at the upper half of axis i
+    const std::uint8_t axis_bit = static_cast<std::uint8_t>(1 << i);
+    const S lower_gap = std::max(
+        {parent_bv.min_[i] - query_max[i],
+         query_min[i] - (parent_bv.min_[i] + half_size[i]), S(0.0)});
+    const S upper_gap = std::max(
+        {(parent_bv.min_[i] + half_size[i]) - query_max[i],
+         query_min[i] - parent_bv.max_[i], S(0.0)});
+    const S lower_gap_square = lower_gap * lower_gap;
+    const S upper_gap_square = upper_gap * upper_gap;
+    for (std::uint8_t child_i = 0; child_i < 8; child_i++) {
+      distance_square[child_i] +=
+          (child_i & axis_bit) ? upper_gap_square : lower_gap_square;
+    }
+  }
+}
+
+}  // namespace internal
+
+template <typename S>
+octree2::Bitset8 sweptSphereLeafChildrenOverlap(
+    const Octree2SweptSphere<S>& swept_sphere, const AABB<S>& leaf_bv,
+    octree2::Bitset8 child_occupied) {
+  const S radius_square = swept_sphere.radius * swept_sphere.radius;
+  const bool is_sphere = (swept_sphere.p0 == swept_sphere.p1);
+
+  // Lower bound by the box of the segment, which is exact for sphere
+  std::array<S, 8> distance_square;
+  internal::octreeChildrenSquaredDistance(
+      leaf_bv, swept_sphere.segment_aabb.min_, swept_sphere.segment_aabb.max_,
+      distance_square);
+  octree2::Bitset8 overlapped;
+  for (std::uint8_t child_i = 0; child_i < 8; child_i++) {
+    if (distance_square[child_i] <= radius_square) overlapped.set_i(child_i);
+  }
+  overlapped.bitset &= child_occupied.bitset;
+  if (is_sphere || overlapped.is_all_cleared()) return overlapped;
+
+  // The exact test for capsule
+  AABB<S> child_bv;
+  for (std::uint8_t child_i = 0; child_i < 8; child_i++) {
+    if (!overlapped.test_i(child_i)) continue;
+    octree2::computeChildAABB(leaf_bv, child_i, child_bv);
+    const S segment_distance_square = segmentAABBSquaredDistance(
+        swept_sphere.p0, swept_sphere.p1, child_bv.min_, child_bv.max_);
+    if (segment_distance_square > radius_square) overlapped.clear_i(child_i);
+  }
+  return overlapped;
+}
+
+}  // namespace detail
+}  // namespace fcl
@@ -0,0 +1,66 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#pragma once
+
+#include "fcl/geometry/octree2/octree_util.h"
+#include "fcl/geometry/shape/capsule.h"
+#include "fcl/geometry/shape/sphere.h"
+#include "fcl/math/bv/AABB.h"
+
+namespace fcl {
+namespace detail {
+
+/// Sphere and capsule are both a segment inflated by a radius, which is
+/// expressed in the octree frame. Their collision with the axis-aligned voxels
+/// can be computed analytically without the generic GJK/MPR solver.
+/// Touching is considered as collision, the same as the sphere-box algorithm.
+template <typename S>
+struct Octree2SweptSphere {
+  Vector3<S> p0;
+  Vector3<S> p1;
+  S radius{0};
+  AABB<S> segment_aabb;
+};
+
+/// Make the swept sphere for supported shapes, return false for other shapes
+template <typename S, typename Shape>
+bool makeOctree2SweptSphere(const Shape& shape, const Transform3<S>& tf_octree,
+                            const Transform3<S>& tf_shape,
+                            Octree2SweptSphere<S>& swept_sphere);
+template <typename S>
+bool makeOctree2SweptSphere(const Sphere<S>& sphere,
+                            const Transform3<S>& tf_octree,
+                            const Transform3<S>& tf_shape,
+                            Octree2SweptSphere<S>& swept_sphere);
+template <typename S>
+bool makeOctree2SweptSphere(const Capsule<S>& capsule,
+                            const Transform3<S>& tf_octree,
+                            const Transform3<S>& tf_shape,
+                            Octree2SweptSphere<S>& swept_sphere);
+
+/// Squared distance between the segment from p0 to p1 and the box
+template <typename S>
+S segmentAABBSquaredDistance(const Vector3<S>& p0, const Vector3<S>& p1,
+                             const Vector3<S>& box_min,
+                             const Vector3<S>& box_max);
+
+/// Overlap test of the swept sphere with a box in octree frame
+template <typename S>
+bool sweptSphereAABBOverlap(const Octree2SweptSphere<S>& swept_sphere,
+                            const AABB<S>& bv);
+
+/// Test the occupied children of a leaf node (whose bv is leaf_bv) at once.
+/// The distances of the 8 children are computed in lanes, and only the
+/// undecided children of a capsule fall back to the exact segment test.
+/// Return the children that overlap with the swept sphere.
+template <typename S>
+octree2::Bitset8 sweptSphereLeafChildrenOverlap(
+    const Octree2SweptSphere<S>& swept_sphere, const AABB<S>& leaf_bv,
+    octree2::Bitset8 child_occupied);
+
+}  // namespace detail
+}  // namespace fcl
+
+#include "fcl/narrowphase/detail/traversal/octree2/octree2_swept_sphere-inl.h"
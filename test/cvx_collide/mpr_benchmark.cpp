@@ -2,11 +2,15 @@
 // Created by mech-mind_gw on 2/8/2022.
 //
 
+#include <algorithm>
 #include <chrono>
 
 #include "retired_gjk.h"
+#include "fcl/narrowphase/detail/gjk_solver.h"
 #include "fcl/narrowphase/detail/gjk_solver_cvx.h"
 #include "fcl/cvx_collide/mpr.h"
+#include "fcl/cvx_collide/mpr_batch.h"
+#include "test_fcl_utility.h"
 
 using namespace fcl;
 
@@ -48,6 +52,47 @@ void triangleBoxBenchmark() {
           .count();
   std::cout << "MPR Time in ms " << ms_time << std::endl;
 
+  // Test the mpr with static dispatch
+  using StaticMinkowskiDiff =
+      detail::ShapeMinkowskiDiff<S, fcl::Box<S>, fcl::TriangleP<S>>;
+  start = std::chrono::high_resolution_clock::now();
+  for (auto i = 0; i < test_n; i++) {
+    StaticMinkowskiDiff minkowski_diff;
+    minkowski_diff.shapes[0] = detail::constructGJKGeometry(&box);
+    minkowski_diff.shapes[1] = detail::constructGJKGeometry(&triangles_vector[i]);
+    minkowski_diff.toshape0.setIdentity();
+    minkowski_diff.toshape1.setIdentity();
+    mpr.Intersect(minkowski_diff);
+  }
+  end = std::chrono::high_resolution_clock::now();
+  ms_time = std::chrono::duration_cast<std::chrono::milliseconds>((end - start))
+                .count();
+  std::cout << "Static MPR Time in ms " << ms_time << std::endl;
+
+  // Test the batched mpr
+  constexpr std::size_t kBatchSize = 32;
+  detail::MPRBatch<S, 8> mpr_batch(1000, 1e-6);
+  StaticMinkowskiDiff batch_minkowski_diff[kBatchSize];
+  typename detail::MPR<S>::IntersectStatus batch_status[kBatchSize];
+  start = std::chrono::high_resolution_clock::now();
+  for (auto i = 0; i < test_n; i += kBatchSize) {
+    const std::size_t n_batch =
+        std::min<std::size_t>(kBatchSize, test_n - i);
+    for (std::size_t j = 0; j < n_batch; j++) {
+      StaticMinkowskiDiff& minkowski_diff = batch_minkowski_diff[j];
+      minkowski_diff.shapes[0] = detail::constructGJKGeometry(&box);
+      minkowski_diff.shapes[1] =
+          detail::constructGJKGeometry(&triangles_vector[i + j]);
+      minkowski_diff.toshape0.setIdentity();
+      minkowski_diff.toshape1.setIdentity();
+    }
+    mpr_batch.Intersect(batch_minkowski_diff, n_batch, batch_status);
+  }
+  end = std::chrono::high_resolution_clock::now();
+  ms_time = std::chrono::duration_cast<std::chrono::milliseconds>((end - start))
+                .count();
+  std::cout << "Batched MPR Time in ms " << ms_time << std::endl;
+
   // Test with gjk
   detail::GJK<S> gjk(1000, 1e-6);
   start = std::chrono::high_resolution_clock::now();
@@ -67,9 +112,109 @@ void triangleBoxBenchmark() {
   std::cout << "GJK Time in ms " << ms_time << std::endl;
 }
 
+template <typename S>
+void trajectoryWarmStartBenchmark() {
+  // A box moving along a smooth trajectory around a capsule
+  constexpr int test_n = 1e6;
+  using StaticMinkowskiDiff =
+      detail::ShapeMinkowskiDiff<S, fcl::Box<S>, fcl::Capsule<S>>;
+  fcl::Box<S> box(0.1, 0.1, 0.1);
+  fcl::Capsule<S> capsule(0.05, 0.2);
+  aligned_vector<StaticMinkowskiDiff> minkowski_diff_vector(test_n);
+  for (auto i = 0; i < test_n; i++) {
+    const S t = S(i) * S(1e-4);
+    Transform3<S> box_pose;
+    box_pose.linear() =
+        Eigen::AngleAxis<S>(t, Vector3<S>(1, 2, 3).normalized())
+            .toRotationMatrix();
+    box_pose.translation() =
+        Vector3<S>(S(0.12) * std::cos(3 * t), S(0.12) * std::sin(5 * t),
+                   S(0.1) * std::sin(t));
+    StaticMinkowskiDiff& minkowski_diff = minkowski_diff_vector[i];
+    minkowski_diff.shapes[0] = detail::constructGJKGeometry(&box);
+    minkowski_diff.shapes[1] = detail::constructGJKGeometry(&capsule);
+    minkowski_diff.toshape1 = box_pose.linear().transpose();
+    minkowski_diff.toshape0 = box_pose.inverse(Eigen::Isometry);
+  }
+
+  detail::MPR<S> mpr(1000, 1e-6);
+  auto start = std::chrono::high_resolution_clock::now();
+  for (auto i = 0; i < test_n; i++) {
+    mpr.Intersect(minkowski_diff_vector[i]);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  auto ms_time =
+      std::chrono::duration_cast<std::chrono::milliseconds>((end - start))
+          .count();
+  std::cout << "Trajectory MPR Time in ms " << ms_time << std::endl;
+
+  // Warm started from the portal of the last step
+  typename detail::MPR<S>::IntersectData intersect_data;
+  intersect_data.v1_dir_in_support = Vector3<S>::UnitX();
+  intersect_data.v2_dir_in_support = Vector3<S>::UnitY();
+  intersect_data.v3_dir_in_support = Vector3<S>::UnitZ();
+  start = std::chrono::high_resolution_clock::now();
+  for (auto i = 0; i < test_n; i++) {
+    mpr.IntersectWarmStart(minkowski_diff_vector[i], intersect_data);
+  }
+  end = std::chrono::high_resolution_clock::now();
+  ms_time = std::chrono::duration_cast<std::chrono::milliseconds>((end - start))
+                .count();
+  std::cout << "Trajectory warm started MPR Time in ms " << ms_time
+            << std::endl;
+}
+
+void mixedPrecisionBenchmark() {
+  // Random boxes around an ellipsoid, which goes through the generic MPR
+  constexpr int test_n = 1e6;
+  using S = double;
+  fcl::Ellipsoid<S> ellipsoid(0.05, 0.1, 0.2);
+  fcl::Box<S> box(0.1, 0.1, 0.1);
+  aligned_vector<Transform3<S>> box_poses(test_n);
+  std::array<S, 6> extent{-0.3, -0.3, -0.3, 0.3, 0.3, 0.3};
+  for (auto i = 0; i < test_n; i++)
+    test::generateRandomTransform(extent, box_poses[i]);
+
+  detail::GJKSolver<S> solver;
+  std::size_t n_intersect = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (auto i = 0; i < test_n; i++) {
+    if (solver.shapeIntersect(box, box_poses[i], ellipsoid,
+                              Transform3<S>::Identity()))
+      n_intersect++;
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  auto ms_time =
+      std::chrono::duration_cast<std::chrono::milliseconds>((end - start))
+          .count();
+  std::cout << "Double solver Time in ms " << ms_time << ", intersect "
+            << n_intersect << std::endl;
+
+  detail::MixedPrecisionCounters counters;
+  solver.use_mixed_precision = true;
+  solver.mixed_precision_counters = &counters;
+  n_intersect = 0;
+  start = std::chrono::high_resolution_clock::now();
+  for (auto i = 0; i < test_n; i++) {
+    if (solver.shapeIntersect(box, box_poses[i], ellipsoid,
+                              Transform3<S>::Identity()))
+      n_intersect++;
+  }
+  end = std::chrono::high_resolution_clock::now();
+  ms_time = std::chrono::duration_cast<std::chrono::milliseconds>((end - start))
+                .count();
+  std::cout << "Mixed precision solver Time in ms " << ms_time
+            << ", intersect " << n_intersect << ", double fallbacks "
+            << counters.n_double_fallbacks << " of "
+            << counters.n_float_queries << std::endl;
+}
+
 int main() {
   std::cout << "Test with float" << std::endl;
   triangleBoxBenchmark<float>();
+  trajectoryWarmStartBenchmark<float>();
   std::cout << "Test with double" << std::endl;
   triangleBoxBenchmark<double>();
+  trajectoryWarmStartBenchmark<double>();
+  mixedPrecisionBenchmark();
 }
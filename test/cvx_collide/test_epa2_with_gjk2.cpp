@@ -5,11 +5,14 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <thread>
 
 #include "create_primitive_mesh.h"
 #include "fcl/cvx_collide/epa.h"
 #include "fcl/cvx_collide/gjk.h"
 #include "fcl/narrowphase/detail/primitive_shape_algorithm/box_box.h"
+#include "fcl/narrowphase/detail/gjk_solver.h"
+#include "fcl/narrowphase/detail/gjk_solver_cvx.h"
 #include "fcl/narrowphase/detail/primitive_shape_algorithm/capsule_capsule.h"
 #include "retired_epa.h"
 #include "retired_gjk.h"
@@ -254,6 +257,126 @@ void testCapsulePenetration(bool use_cached_polytope) {
   }
 }
 
+template <typename S, typename Shape>
+void testStaticMinkowskiDiffVsTriangle(const Shape& shape) {
+  int test_n = 1e4;
+  std::array<S, 6> extent{-0.3, -0.3, -0.3, 0.3, 0.3, 0.3};
+  std::size_t collide_count = 0;
+  for (auto test_idx = 0; test_idx < test_n; test_idx++) {
+    fcl::Transform3<S> obj1_pose, obj2_pose;
+    test::generateRandomTransform(extent, obj1_pose);
+    test::generateRandomTransform(extent, obj2_pose);
+    Vector3<S> a, b, c;
+    a.setRandom();
+    b.setRandom();
+    c.setRandom();
+    fcl::TriangleP<S> triangle(a, b, c);
+
+    // The type-erased one and the statically dispatched one
+    detail::MinkowskiDiff<S> minkowski_diff;
+    minkowski_diff.shapes[0] = constructGJKGeometry(&shape);
+    minkowski_diff.shapes[1] = constructGJKGeometry(&triangle);
+    minkowski_diff.support_function = detail::computeSupport<S>;
+    minkowski_diff.interior_function = detail::computeInterior<S>;
+    minkowski_diff.toshape0 = obj1_pose.inverse() * obj2_pose;
+    minkowski_diff.toshape1 =
+        minkowski_diff.toshape0.inverse().rotation().matrix();
+    ShapeMinkowskiDiff<S, Shape, TriangleP<S>> static_diff;
+    static_diff.shapes[0] = minkowski_diff.shapes[0];
+    static_diff.shapes[1] = minkowski_diff.shapes[1];
+    static_diff.toshape0 = minkowski_diff.toshape0;
+    static_diff.toshape1 = minkowski_diff.toshape1;
+
+    // Support and interior
+    const Vector3<S> d = Vector3<S>::Random();
+    EXPECT_TRUE(minkowski_diff.support(d).isApprox(static_diff.support(d)));
+    EXPECT_TRUE(minkowski_diff.interior().isApprox(static_diff.interior()));
+
+    // MPR
+    MPR<S> mpr(1000, 1e-6);
+    EXPECT_EQ(mpr.Intersect(minkowski_diff), mpr.Intersect(static_diff));
+
+    // GJK/EPA
+    GJK2<S> gjk(1000, 1e-6);
+    GJKSimplex<S> simplex, static_simplex;
+    auto gjk_status = gjk.Evaluate(minkowski_diff, simplex);
+    auto static_gjk_status = gjk.Evaluate(static_diff, static_simplex);
+    EXPECT_EQ(gjk_status, static_gjk_status);
+    if (gjk_status != GJK_Status::Intersect ||
+        static_gjk_status != GJK_Status::Intersect)
+      continue;
+    collide_count++;
+
+    EPA2<S> epa(128);
+    S depth, static_depth;
+    auto epa_status =
+        epa.Evaluate(simplex, minkowski_diff, &depth, nullptr, nullptr);
+    auto static_epa_status =
+        epa.Evaluate(static_simplex, static_diff, &static_depth, nullptr,
+                     nullptr);
+    EXPECT_EQ(epa_status, static_epa_status);
+    if (epa_status != EPA_Status::Failed &&
+        static_epa_status != EPA_Status::Failed) {
+      EXPECT_NEAR(depth, static_depth, S(1e-4));
+    }
+  }
+  EXPECT_GT(collide_count, 0);
+}
+
+template <typename S>
+void testSolverPolytopeCache() {
+  // One polytope per thread
+  GJKSolver<S> solver, another_solver;
+  EXPECT_EQ(solver.epaPolytopeCache(), another_solver.epaPolytopeCache());
+  Polytope<S>* polytope_in_thread = nullptr;
+  std::thread thread(
+      [&]() -> void { polytope_in_thread = solver.epaPolytopeCache(); });
+  thread.join();
+  EXPECT_NE(polytope_in_thread, nullptr);
+  EXPECT_NE(polytope_in_thread, solver.epaPolytopeCache());
+
+  // The solver with the reused polytope should match a new polytope
+  fcl::Capsule<S> capsule(0.1, 0.4);
+  fcl::Ellipsoid<S> ellipsoid(0.1, 0.2, 0.3);
+  std::array<S, 6> extent{-0.2, -0.2, -0.2, 0.2, 0.2, 0.2};
+  int test_n = 1e4;
+  std::size_t penetration_count = 0;
+  for (auto test_idx = 0; test_idx < test_n; test_idx++) {
+    fcl::Transform3<S> obj1_pose, obj2_pose;
+    test::generateRandomTransform(extent, obj1_pose);
+    test::generateRandomTransform(extent, obj2_pose);
+    CollisionPenetrationContactData<S> contacts;
+    solver.shapeIntersect(capsule, obj1_pose, ellipsoid, obj2_pose,
+                          &contacts);
+
+    ShapeMinkowskiDiff<S, Capsule<S>, Ellipsoid<S>> minkowski_diff;
+    minkowski_diff.shapes[0] = constructGJKGeometry(&capsule);
+    minkowski_diff.shapes[1] = constructGJKGeometry(&ellipsoid);
+    minkowski_diff.toshape1.noalias() =
+        obj2_pose.linear().transpose() * obj1_pose.linear();
+    minkowski_diff.toshape0 = obj1_pose.inverse(Eigen::Isometry) * obj2_pose;
+    GJK2<S> gjk(solver.gjk_max_iterations, solver.gjk_tolerance);
+    GJKSimplex<S> simplex;
+    auto gjk_status =
+        gjk.Evaluate(minkowski_diff, simplex, -Vector3<S>::UnitX());
+    if (gjk_status != GJK_Status::Intersect) {
+      EXPECT_TRUE(contacts.empty());
+      continue;
+    }
+
+    EPA2<S> epa(solver.epa_max_face_num, solver.epa_max_iterations,
+                solver.epa_tolerance);
+    S depth;
+    auto epa_status =
+        epa.Evaluate(simplex, minkowski_diff, &depth, nullptr, nullptr);
+    if (epa_status == EPA_Status::Failed) continue;
+    penetration_count++;
+    EXPECT_EQ(contacts.size(), std::size_t(1));
+    if (contacts.size() == 1) EXPECT_EQ(contacts[0].penetration_depth, depth);
+  }
+  EXPECT_GT(penetration_count, 0);
+}
+
 }  // namespace detail
 }  // namespace fcl
 
@@ -282,6 +405,22 @@ GTEST_TEST(EPA2_W_GJK2_Test, capsule_cached_polytope_test) {
   fcl::detail::testCapsulePenetration<float>(true);
 }
 
+GTEST_TEST(EPA2_W_GJK2_Test, static_minkowski_diff_test) {
+  fcl::detail::testStaticMinkowskiDiffVsTriangle<double>(
+      fcl::Box<double>(0.2, 0.1, 0.3));
+  fcl::detail::testStaticMinkowskiDiffVsTriangle<double>(
+      fcl::Capsule<double>(0.1, 0.4));
+  fcl::detail::testStaticMinkowskiDiffVsTriangle<float>(
+      fcl::Box<float>(0.2, 0.1, 0.3));
+  fcl::detail::testStaticMinkowskiDiffVsTriangle<float>(
+      fcl::Capsule<float>(0.1, 0.4));
+}
+
+GTEST_TEST(EPA2_W_GJK2_Test, solver_polytope_cache_test) {
+  fcl::detail::testSolverPolytopeCache<double>();
+  fcl::detail::testSolverPolytopeCache<float>();
+}
+
 int main(int argc, char* argv[]) {
   std::cout.precision(std::numeric_limits<float>::max_digits10 + 10);
   ::testing::InitGoogleTest(&argc, argv);
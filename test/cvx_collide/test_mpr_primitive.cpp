@@ -7,7 +7,9 @@
 #include <memory>
 
 #include "fcl/cvx_collide/mpr.h"
+#include "fcl/cvx_collide/mpr_batch.h"
 #include "fcl/narrowphase/detail/gjk_solver.h"
+#include "fcl/narrowphase/detail/gjk_solver_cvx.h"
 #include "fcl/narrowphase/detail/primitive_shape_algorithm/box_box.h"
 #include "fcl/narrowphase/detail/primitive_shape_algorithm/capsule_capsule.h"
 #include "retired_gjk.h"
@@ -282,6 +284,169 @@ void testMPRWithCapsulePair() {
   }
 }
 
+template <typename S, typename Shape>
+void testMPRBatchVsScalar(const Shape& shape) {
+  constexpr std::size_t kBatchSize = 24;
+  constexpr std::size_t kBatchLanes = 4;
+  using MinkowskiDiffT = detail::ShapeMinkowskiDiff<S, Box<S>, Shape>;
+  using IntersectStatus = typename detail::MPR<S>::IntersectStatus;
+  fcl::Box<S> box(0.1, 0.1, 0.1);
+  detail::GJKSolver<S> solver;
+  solver.use_mpr_batch = true;
+  detail::MPR<S> mpr(solver.gjk_max_iterations, solver.gjk_tolerance);
+  detail::MPRBatch<S, kBatchLanes> mpr_batch(solver.gjk_max_iterations,
+                                             solver.gjk_tolerance);
+  std::array<S, 6> extent{-0.3, -0.3, -0.3, 0.3, 0.3, 0.3};
+  int test_n = 2e3;
+  for (auto test_idx = 0; test_idx < test_n; test_idx++) {
+    // The lanes are refilled, or partially filled
+    const std::size_t n_shapes = 1 + test_idx % kBatchSize;
+    fcl::Transform3<S> shape_pose;
+    test::generateRandomTransform(extent, shape_pose);
+    fcl::Box<S> boxes[kBatchSize];
+    fcl::Transform3<S> box_poses[kBatchSize];
+    MinkowskiDiffT minkowski_diff[kBatchSize];
+    for (std::size_t i = 0; i < n_shapes; i++) {
+      boxes[i] = box;
+      test::generateRandomTransform(extent, box_poses[i]);
+      minkowski_diff[i].shapes[0] = detail::constructGJKGeometry(&box);
+      minkowski_diff[i].shapes[1] = detail::constructGJKGeometry(&shape);
+      minkowski_diff[i].toshape1.noalias() =
+          shape_pose.linear().transpose() * box_poses[i].linear();
+      minkowski_diff[i].toshape0 =
+          box_poses[i].inverse(Eigen::Isometry) * shape_pose;
+    }
+
+    // Each lane should follow the scalar MPR
+    IntersectStatus batch_status[kBatchSize];
+    mpr_batch.Intersect(minkowski_diff, n_shapes, batch_status);
+    for (std::size_t i = 0; i < n_shapes; i++) {
+      EXPECT_TRUE(batch_status[i] == mpr.Intersect(minkowski_diff[i]));
+    }
+
+    // And the batched solver should match the solver
+    bool intersect[kBatchSize];
+    solver.shapeIntersectBatch(boxes, box_poses, shape, shape_pose, n_shapes,
+                               intersect);
+    for (std::size_t i = 0; i < n_shapes; i++) {
+      EXPECT_EQ(intersect[i], solver.shapeIntersect(boxes[i], box_poses[i],
+                                                    shape, shape_pose));
+    }
+  }
+}
+
+template <typename S, typename Shape>
+void testWarmStartAlongTrajectory(const Shape& shape) {
+  fcl::Box<S> box(0.1, 0.1, 0.1);
+  detail::GJKSolver<S> solver;
+  detail::GJKWarmStart<S> warm_start;
+  std::array<S, 6> extent{-0.2, -0.2, -0.2, 0.2, 0.2, 0.2};
+  fcl::Transform3<S> shape_pose, box_pose, box_step;
+  test::generateRandomTransform(extent, shape_pose);
+  test::generateRandomTransform(extent, box_pose);
+  int test_n = 2e3;
+  for (auto test_idx = 0; test_idx < test_n; test_idx++) {
+    // A temporally coherent trajectory with a new direction every 50 steps
+    if (test_idx % 50 == 0) {
+      std::array<S, 6> step_extent{-0.01, -0.01, -0.01, 0.01, 0.01, 0.01};
+      test::generateRandomTransform(step_extent, box_step);
+      box_step.linear() =
+          Eigen::AngleAxis<S>(0.02, Vector3<S>::UnitZ()).toRotationMatrix();
+    }
+    box_pose = box_pose * box_step;
+    if (box_pose.translation().norm() > 0.3) box_pose.translation().setZero();
+
+    // The warm started MPR gives the same result as the one from scratch
+    const bool intersect = solver.shapeIntersect(box, box_pose, shape,
+                                                 shape_pose, nullptr, nullptr);
+    EXPECT_EQ(intersect, solver.shapeIntersect(box, box_pose, shape,
+                                               shape_pose, nullptr,
+                                               &warm_start));
+
+    // So does the GJK/EPA
+    CollisionPenetrationContactData<S> contacts;
+    CollisionPenetrationContactData<S> warm_start_contacts;
+    const bool gjk_intersect =
+        solver.shapeIntersect(box, box_pose, shape, shape_pose, &contacts);
+    EXPECT_EQ(gjk_intersect,
+              solver.shapeIntersect(box, box_pose, shape, shape_pose,
+                                    &warm_start_contacts, &warm_start));
+    EXPECT_EQ(contacts.size(), warm_start_contacts.size());
+  }
+  EXPECT_TRUE(warm_start.is_mpr_portal_valid);
+}
+
+template <typename S>
+void testWarmStartCacheEviction() {
+  detail::GJKWarmStartCache<S> cache(2);
+  fcl::Box<S> box_0(0.1, 0.1, 0.1), box_1(0.1, 0.1, 0.1);
+  detail::GJKWarmStartKey key_00, key_01, key_10;
+  key_00.o1 = key_01.o1 = &box_0;
+  key_10.o1 = &box_1;
+  key_00.b1 = key_10.b1 = 0;
+  key_01.b1 = 1;
+
+  // The inserted warm start is invalid
+  detail::GJKWarmStart<S>* warm_start_00 = cache.findOrInsert(key_00);
+  EXPECT_FALSE(warm_start_00->is_gjk_direction_valid);
+  EXPECT_FALSE(warm_start_00->is_mpr_portal_valid);
+  warm_start_00->is_gjk_direction_valid = true;
+  warm_start_00->gjk_direction = Vector3<S>::UnitY();
+  cache.findOrInsert(key_01);
+  EXPECT_EQ(cache.size(), 2u);
+
+  // Touch key_00, then key_01 is the least recently used one
+  EXPECT_EQ(cache.findOrInsert(key_00), warm_start_00);
+  cache.findOrInsert(key_10);
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_EQ(cache.findOrInsert(key_00), warm_start_00);
+  EXPECT_TRUE(warm_start_00->is_gjk_direction_valid);
+  EXPECT_FALSE(cache.findOrInsert(key_01)->is_gjk_direction_valid);
+  EXPECT_EQ(cache.size(), 2u);
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0u);
+}
+
+template <typename Shape>
+void testMixedPrecisionVsDouble(const Shape& shape) {
+  using S = double;
+  fcl::Box<S> box(0.1, 0.1, 0.1);
+  detail::GJKSolver<S> solver;
+  detail::GJKSolver<S> mixed_precision_solver;
+  detail::MixedPrecisionCounters counters;
+  mixed_precision_solver.use_mixed_precision = true;
+  mixed_precision_solver.mixed_precision_counters = &counters;
+  std::array<S, 6> extent{-0.3, -0.3, -0.3, 0.3, 0.3, 0.3};
+  int test_n = 2e3;
+  for (auto test_idx = 0; test_idx < test_n; test_idx++) {
+    fcl::Transform3<S> box_pose, shape_pose;
+    test::generateRandomTransform(extent, box_pose);
+    test::generateRandomTransform(extent, shape_pose);
+    EXPECT_EQ(solver.shapeIntersect(box, box_pose, shape, shape_pose),
+              mixed_precision_solver.shapeIntersect(box, box_pose, shape,
+                                                    shape_pose));
+  }
+  EXPECT_EQ(counters.n_float_queries, std::size_t(test_n));
+  EXPECT_LT(counters.n_double_fallbacks, counters.n_float_queries);
+
+  // The shape touching the box is within the band, and falls back to double
+  counters.reset();
+  fcl::Transform3<S> box_pose = fcl::Transform3<S>::Identity();
+  box_pose.translation().x() = 0.05 + shape.aabb_local.max_.x() + 1e-6;
+  EXPECT_FALSE(mixed_precision_solver.shapeIntersect(
+      box, box_pose, shape, fcl::Transform3<S>::Identity()));
+  EXPECT_EQ(counters.n_float_queries, 1u);
+  EXPECT_EQ(counters.n_double_fallbacks, 1u);
+
+  // The penetration queries are always evaluated in double
+  CollisionPenetrationContactData<S> contacts;
+  mixed_precision_solver.shapeIntersect(box, box_pose, shape,
+                                        fcl::Transform3<S>::Identity(),
+                                        &contacts);
+  EXPECT_EQ(counters.n_float_queries, 1u);
+}
+
 // Callers
 GTEST_TEST(MPR_Primitive_Test, box2box_simple_test) {
   testBoxVsBoxSimple<float>();
@@ -299,6 +464,40 @@ GTEST_TEST(MPR_Primitive_Test, capsule2capsule_test) {
   // testMPRWithCapsuleInstance<double>();
 }
 
+GTEST_TEST(MPR_Primitive_Test, batch_test) {
+  testMPRBatchVsScalar<float>(fcl::Capsule<float>(0.05, 0.2));
+  testMPRBatchVsScalar<double>(fcl::Capsule<double>(0.05, 0.2));
+  testMPRBatchVsScalar<float>(fcl::Cylinder<float>(0.05, 0.2));
+  testMPRBatchVsScalar<double>(fcl::Cylinder<double>(0.05, 0.2));
+  testMPRBatchVsScalar<double>(fcl::Ellipsoid<double>(0.05, 0.1, 0.2));
+  testMPRBatchVsScalar<double>(fcl::Box<double>(0.1, 0.2, 0.05));
+}
+
+GTEST_TEST(MPR_Primitive_Test, warm_start_test) {
+  testWarmStartAlongTrajectory<float>(fcl::Capsule<float>(0.05, 0.2));
+  testWarmStartAlongTrajectory<double>(fcl::Capsule<double>(0.05, 0.2));
+  testWarmStartAlongTrajectory<double>(fcl::Cylinder<double>(0.05, 0.2));
+  testWarmStartAlongTrajectory<double>(
+      fcl::Ellipsoid<double>(0.05, 0.1, 0.2));
+  testWarmStartCacheEviction<float>();
+  testWarmStartCacheEviction<double>();
+}
+
+GTEST_TEST(MPR_Primitive_Test, mixed_precision_test) {
+  fcl::Capsule<double> capsule(0.05, 0.2);
+  fcl::Cylinder<double> cylinder(0.05, 0.2);
+  fcl::Ellipsoid<double> ellipsoid(0.05, 0.1, 0.2);
+  fcl::Cone<double> cone(0.05, 0.2);
+  capsule.computeLocalAABB();
+  cylinder.computeLocalAABB();
+  ellipsoid.computeLocalAABB();
+  cone.computeLocalAABB();
+  testMixedPrecisionVsDouble(capsule);
+  testMixedPrecisionVsDouble(cylinder);
+  testMixedPrecisionVsDouble(ellipsoid);
+  testMixedPrecisionVsDouble(cone);
+}
+
 int main(int argc, char* argv[]) {
   std::cout.precision(std::numeric_limits<float>::max_digits10 + 10);
   ::testing::InitGoogleTest(&argc, argv);
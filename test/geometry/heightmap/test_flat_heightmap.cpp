@@ -286,6 +286,211 @@ void testRegionOfInterest() {
   }
 }
 
+template <typename S>
+void testParallelXYZBufferIngestion() {
+  // Height map dims
+  std::vector<FlatHeightMap<S>> height_map_to_test;
+  generateRepresentativeHeightMapConfiguration(height_map_to_test);
+
+  // Rotate around z by pi and shift by pixels, such that a pixel center is
+  // mapped to a pixel center and the quantization is not ambiguous
+  constexpr int n_points = 300000;
+  for (auto& height_map : height_map_to_test) {
+    const float resolution_x = height_map.resolution_x();
+    const float resolution_y = height_map.resolution_y();
+    Eigen::Isometry3f tf = Eigen::Isometry3f::Identity();
+    tf.linear() =
+        Eigen::AngleAxisf(float(M_PI), Eigen::Vector3f::UnitZ()).matrix();
+    tf.translation() = Eigen::Vector3f(3 * resolution_x, -5 * resolution_y, 0);
+
+    // Points at pixel centers, some of them are out-of-range or below xOy
+    std::vector<float> xyz;
+    xyz.reserve(3 * n_points);
+    const int range_x = height_map.half_shape_x() + 8;
+    const int range_y = height_map.half_shape_y() + 8;
+    for (int i = 0; i < n_points; i++) {
+      const int pixel_x = std::rand() % (2 * range_x) - range_x;
+      const int pixel_y = std::rand() % (2 * range_y) - range_y;
+      const int height_in_mm = std::rand() % 1200 - 100;
+      xyz.push_back((pixel_x + 0.5f) * resolution_x);
+      xyz.push_back((pixel_y + 0.5f) * resolution_y);
+      xyz.push_back((height_in_mm + 0.5f) * 0.001f);
+    }
+
+    // The serial reference
+    for (const Eigen::Isometry3f* points_tf :
+         {static_cast<const Eigen::Isometry3f*>(nullptr),
+          static_cast<const Eigen::Isometry3f*>(&tf)}) {
+      auto generate_point = [&](int index, S& x, S& y, S& z) -> void {
+        Eigen::Vector3f point(xyz[3 * index], xyz[3 * index + 1],
+                              xyz[3 * index + 2]);
+        if (points_tf != nullptr) point = (*points_tf) * point;
+        x = point.x();
+        y = point.y();
+        z = point.z();
+      };
+      FlatHeightMap<S> expected_map = height_map;
+      expected_map.resetHeights();
+      expected_map.updateHeightsByPointGenerationFunctor(generate_point,
+                                                         n_points);
+      EXPECT_GT(expected_map.height_upper_bound_mm(), 0);
+
+      for (int n_threads : {1, 4, 0}) {
+        for (int by_buffer = 0; by_buffer < 2; by_buffer++) {
+          height_map.resetHeights();
+          if (by_buffer) {
+            height_map.updateHeightsByXYZBuffer(xyz.data(), n_points, points_tf,
+                                                n_threads);
+          } else {
+            height_map.updateHeightsByPointGenerationFunctor(
+                generate_point, n_points, n_threads);
+          }
+
+          EXPECT_EQ(height_map.height_upper_bound_mm(),
+                    expected_map.height_upper_bound_mm());
+          for (uint16_t y = 0; y < height_map.full_shape_y(); y++) {
+            for (uint16_t x = 0; x < height_map.full_shape_x(); x++) {
+              ASSERT_EQ(height_map.pixelHeight(Pixel{x, y}),
+                        expected_map.pixelHeight(Pixel{x, y}));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+template <typename S, typename DepthT>
+void testDepthImageIngestion(float depth_scale) {
+  // Height map dims
+  std::vector<FlatHeightMap<S>> height_map_to_test;
+  generateRepresentativeHeightMapConfiguration(height_map_to_test);
+
+  // A camera 1.2m above the map looking downward
+  PinholeCameraIntrinsic<float> intrinsic;
+  intrinsic.width = 643;
+  intrinsic.height = 480;
+  intrinsic.fx = 800.0f;
+  intrinsic.fy = 820.0f;
+  intrinsic.cx = 320.5f;
+  intrinsic.cy = 239.5f;
+  Eigen::Isometry3f camera_to_heightmap = Eigen::Isometry3f::Identity();
+  camera_to_heightmap.linear() =
+      (Eigen::AngleAxisf(0.1f, Eigen::Vector3f::UnitZ()) *
+       Eigen::AngleAxisf(float(M_PI) - 0.05f, Eigen::Vector3f::UnitX()))
+          .matrix();
+  camera_to_heightmap.translation() = Eigen::Vector3f(0.01f, -0.02f, 1.2f);
+
+  // Random depth in [0.8, 1.4] meter, some are invalid
+  std::vector<DepthT> depth_image(intrinsic.n_pixels());
+  for (auto& depth : depth_image) {
+    const float depth_in_meter = 0.8f + 0.6f * float(std::rand()) / RAND_MAX;
+    depth = static_cast<DepthT>(depth_in_meter / depth_scale);
+    if (std::rand() % 10 == 0) depth = DepthT(0);
+  }
+
+  // The reference points in heightmap frame
+  const Eigen::Matrix3f rotation = camera_to_heightmap.linear();
+  const Eigen::Vector3f translation = camera_to_heightmap.translation();
+  std::vector<float> xyz;
+  for (int row = 0; row < intrinsic.height; row++) {
+    const float ray_y = (float(row) - intrinsic.cy) / intrinsic.fy;
+    for (int col = 0; col < intrinsic.width; col++) {
+      const float depth =
+          float(depth_image[row * intrinsic.width + col]) * depth_scale;
+      if (depth <= 0.0f) continue;
+      const float ray_x = (float(col) - intrinsic.cx) / intrinsic.fx;
+      for (int i = 0; i < 3; i++) {
+        const float row_offset = ray_y * rotation(i, 1) + rotation(i, 2);
+        xyz.push_back(depth * (ray_x * rotation(i, 0) + row_offset) +
+                      translation[i]);
+      }
+    }
+  }
+
+  for (auto& height_map : height_map_to_test) {
+    FlatHeightMap<S> expected_map = height_map;
+    expected_map.resetHeights();
+    expected_map.updateHeightsByXYZBuffer(xyz.data(), xyz.size() / 3);
+    EXPECT_GT(expected_map.height_upper_bound_mm(), 0);
+    for (int n_threads : {1, 4}) {
+      height_map.resetHeights();
+      height_map.updateHeightsByDepthImage(depth_image.data(), intrinsic,
+                                           camera_to_heightmap, depth_scale,
+                                           n_threads);
+      EXPECT_EQ(height_map.height_upper_bound_mm(),
+                expected_map.height_upper_bound_mm());
+      for (uint16_t y = 0; y < height_map.full_shape_y(); y++) {
+        for (uint16_t x = 0; x < height_map.full_shape_x(); x++) {
+          ASSERT_EQ(height_map.pixelHeight(Pixel{x, y}),
+                    expected_map.pixelHeight(Pixel{x, y}));
+        }
+      }
+    }
+  }
+}
+
+template <typename S>
+void testSparseTileStorage() {
+  // 8192 x 8192 pixels, which is 128 MB if stored densely
+  FlatHeightMap<S> height_map(0.002, 4096);
+  EXPECT_EQ(height_map.allocated_bytes(), 0);
+
+  // Points in a small patch around the origin
+  constexpr int n_points = 10000;
+  std::vector<float> xyz;
+  xyz.reserve(3 * n_points);
+  for (int i = 0; i < n_points; i++) {
+    xyz.push_back((std::rand() % 200 - 100 + 0.5f) * 0.002f);
+    xyz.push_back((std::rand() % 200 - 100 + 0.5f) * 0.002f);
+    xyz.push_back((std::rand() % 1000 + 0.5f) * 0.001f);
+  }
+  for (int n_threads : {1, 4}) {
+    height_map.resetHeights();
+    height_map.updateHeightsByXYZBuffer(xyz.data(), n_points, nullptr,
+                                        n_threads);
+
+    // The patch of 200 x 200 pixels is covered by at most 5 x 5 tiles
+    const std::size_t tile_bytes =
+        HeightMapTiles::kTileSize * sizeof(uint16_t);
+    EXPECT_GT(height_map.allocated_bytes(), 0);
+    EXPECT_LE(height_map.allocated_bytes(), 25 * tile_bytes);
+
+    // The visit of non-zero heights is the same as the full visit
+    PixelSpaceROI roi;
+    roi.top_left = Pixel(4096 - 256, 4096 - 256);
+    roi.bottom_right = Pixel(4096 + 256, 4096 + 256);
+    std::size_t n_non_zero = 0;
+    height_map.visitHeightMap(
+        [&](const Pixel& pixel, const Point2D<S>& box_bottom_center,
+            uint16_t height_in_mm) -> bool {
+          (void)(pixel);
+          (void)(box_bottom_center);
+          if (height_in_mm > 0) n_non_zero++;
+          return false;
+        },
+        &roi);
+    std::size_t n_visited = 0;
+    height_map.visitNonZeroHeights(
+        [&](const Pixel& pixel, const Point2D<S>& box_bottom_center,
+            uint16_t height_in_mm) -> bool {
+          (void)(box_bottom_center);
+          EXPECT_GT(height_in_mm, 0);
+          EXPECT_EQ(height_in_mm, height_map.pixelHeight(pixel));
+          n_visited++;
+          return false;
+        },
+        &roi);
+    EXPECT_GT(n_non_zero, 0);
+    EXPECT_EQ(n_non_zero, n_visited);
+  }
+
+  // Pixels out of the patch are zero
+  EXPECT_EQ(height_map.pixelHeight(Pixel(0, 0)), 0);
+  EXPECT_EQ(height_map.pixelHeight(Pixel(8191, 8191)), 0);
+  EXPECT_EQ(height_map.pixelHeight(Pixel(4096 + 100, 4096)), 0);
+}
+
 }  // namespace heightmap
 }  // namespace fcl
 
@@ -309,6 +514,23 @@ GTEST_TEST(HeightMapTest, ROI_Test_0) {
   fcl::heightmap::testRegionOfInterest<double>();
 }
 
+GTEST_TEST(HeightMapTest, ParallelXYZBufferIngestion) {
+  fcl::heightmap::testParallelXYZBufferIngestion<float>();
+  fcl::heightmap::testParallelXYZBufferIngestion<double>();
+}
+
+GTEST_TEST(HeightMapTest, DepthImageIngestion) {
+  fcl::heightmap::testDepthImageIngestion<float, uint16_t>(0.001f);
+  fcl::heightmap::testDepthImageIngestion<double, uint16_t>(0.0005f);
+  fcl::heightmap::testDepthImageIngestion<float, float>(1.0f);
+  fcl::heightmap::testDepthImageIngestion<double, float>(1.0f);
+}
+
+GTEST_TEST(HeightMapTest, SparseTileStorage) {
+  fcl::heightmap::testSparseTileStorage<float>();
+  fcl::heightmap::testSparseTileStorage<double>();
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
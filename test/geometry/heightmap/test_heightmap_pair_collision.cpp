@@ -197,6 +197,127 @@ void heightmapPairCollisionCompareWithNaiveTest() {
   }
 }
 
+template <typename S>
+void heightmapPairBinaryCollisionWithMinHeightChannelTest() {
+  const fcl::detail::GJKSolver<S> narrowphase_solver;
+  fcl::detail::HeightMapCollisionSolver<S> solver(&narrowphase_solver);
+  const fcl::CollisionRequest<S> request{1};
+
+  std::array<S, 6> extent{-1, -1, -0.2, 1, 1, 0.2};
+  constexpr int test_n = 20;
+  for (int test_i = 0; test_i < test_n; test_i++) {
+    // The same map with and without the min-height channel
+    auto height_map = std::make_shared<LayeredHeightMap<S>>(0.06, 16);
+    updateByRandomPointCloud(*height_map);
+    auto height_map_with_min =
+        std::make_shared<LayeredHeightMap<S>>(*height_map);
+    height_map_with_min->setMinHeightChannelEnabled(true);
+    fcl::HeightMapCollisionGeometry<S> geometry(height_map);
+    fcl::HeightMapCollisionGeometry<S> geometry_with_min(height_map_with_min);
+    geometry.computeLocalAABB();
+    geometry_with_min.computeLocalAABB();
+
+    Eigen::Transform<S, 3, Eigen::Isometry> tf1, tf2;
+    test::generateRandomTransform(extent, tf1);
+    test::generateRandomTransform(extent, tf2);
+    fcl::CollisionResult<S> result, result_with_min;
+    solver.HeightMapIntersect(&geometry, &geometry, tf1, tf2, request, result);
+    solver.HeightMapIntersect(&geometry_with_min, &geometry_with_min, tf1, tf2,
+                              request, result_with_min);
+    ASSERT_EQ(result.isCollision(), result_with_min.isCollision());
+    if (!result_with_min.isCollision()) continue;
+
+    // The reported pair must collide
+    const auto& contact = result_with_min.getContact(0);
+    const FlatHeightMap<S>& bottom = height_map->bottom();
+    Box<S> box1, box2;
+    Transform3<S> box_tf_1, box_tf_2;
+    ASSERT_TRUE(bottom.pixelToBox(heightmap::decodePixel(contact.b1), box1,
+                                  box_tf_1));
+    ASSERT_TRUE(bottom.pixelToBox(heightmap::decodePixel(contact.b2), box2,
+                                  box_tf_2));
+    EXPECT_TRUE(narrowphase_solver.shapeIntersect(
+        box1, tf1 * box_tf_1, box2, tf2 * box_tf_2, nullptr));
+  }
+}
+
+template <typename S>
+void heightmapPairAlignedGridTest() {
+  const fcl::detail::GJKSolver<S> narrowphase_solver;
+  fcl::detail::HeightMapCollisionSolver<S> solver(&narrowphase_solver);
+
+  // Two maps with the same resolution but different shapes
+  auto height_map_1 = std::make_shared<LayeredHeightMap<S>>(0.06, 16);
+  auto height_map_2 = std::make_shared<LayeredHeightMap<S>>(0.06, 0.06, 8, 16);
+  updateByRandomPointCloud(*height_map_1);
+  updateByRandomPointCloud(*height_map_2);
+  fcl::HeightMapCollisionGeometry<S> geometry_1(height_map_1);
+  fcl::HeightMapCollisionGeometry<S> geometry_2(height_map_2);
+  geometry_1.computeLocalAABB();
+  geometry_2.computeLocalAABB();
+  const FlatHeightMap<S>& hm1 = height_map_1->bottom();
+  const FlatHeightMap<S>& hm2 = height_map_2->bottom();
+
+  Eigen::Transform<S, 3, Eigen::Isometry> tf1;
+  tf1.setIdentity();
+  tf1.linear() =
+      Eigen::AngleAxis<S>(S(0.3), Vector3<S>::UnitZ()).toRotationMatrix();
+  tf1.translation() = Vector3<S>(0.1, -0.2, 0.05);
+  for (int yaw_i = 0; yaw_i < 4; yaw_i++) {
+    for (const S z_offset : {S(-0.4), S(0.35)}) {
+      // The yaw of multiple of 90 degrees and the integer pixel offsets
+      Eigen::Transform<S, 3, Eigen::Isometry> tf_2_in_1;
+      tf_2_in_1.setIdentity();
+      tf_2_in_1.linear() =
+          Eigen::AngleAxis<S>(S(M_PI / 2) * yaw_i, Vector3<S>::UnitZ())
+              .toRotationMatrix();
+      tf_2_in_1.translation() = Vector3<S>(
+          S(0.06) * (3 - yaw_i), S(0.06) * (2 * yaw_i - 5), z_offset);
+      const Eigen::Transform<S, 3, Eigen::Isometry> tf2 = tf1 * tf_2_in_1;
+
+      // Each pixel of map 2 should only collide with the pixel of map 1
+      // under it, the neighbours only touch
+      std::set<std::pair<int, int>> expected_set;
+      for (uint16_t y = 0; y < hm2.full_shape_y(); y++) {
+        for (uint16_t x = 0; x < hm2.full_shape_x(); x++) {
+          const Pixel hm2_pixel(x, y);
+          Box<S> box1, box2;
+          Transform3<S> box_tf_1, box_tf_2;
+          if (!hm2.pixelToBox(hm2_pixel, box2, box_tf_2)) continue;
+          const Vector3<S> center_in_1 = tf_2_in_1 * box_tf_2.translation();
+          Pixel hm1_pixel;
+          if (!hm1.point2DToPixel({center_in_1.x(), center_in_1.y()},
+                                  hm1_pixel)) {
+            continue;
+          }
+          if (!hm1.pixelToBox(hm1_pixel, box1, box_tf_1)) continue;
+          if (narrowphase_solver.shapeIntersect(box1, tf1 * box_tf_1, box2,
+                                                tf2 * box_tf_2, nullptr)) {
+            expected_set.insert(std::make_pair(encodePixel(hm1_pixel),
+                                               encodePixel(hm2_pixel)));
+          }
+        }
+      }
+
+      const fcl::CollisionRequest<S> request{UINT_MAX};
+      fcl::CollisionResult<S> result;
+      solver.HeightMapIntersect(&geometry_1, &geometry_2, tf1, tf2, request,
+                                result);
+      std::set<std::pair<int, int>> contact_set;
+      for (const auto& contact : result.getContacts()) {
+        contact_set.insert(std::make_pair(contact.b1, contact.b2));
+      }
+      EXPECT_EQ(contact_set, expected_set);
+
+      // Binary
+      fcl::CollisionResult<S> binary_result;
+      solver.HeightMapIntersect(&geometry_1, &geometry_2, tf1, tf2,
+                                fcl::CollisionRequest<S>{1}, binary_result);
+      EXPECT_EQ(binary_result.isCollision(), !expected_set.empty());
+    }
+  }
+}
+
 }  // namespace heightmap
 }  // namespace fcl
 
@@ -205,6 +326,17 @@ GTEST_TEST(HeightMapPairCollisionTest, CompareWithNaive) {
   fcl::heightmap::heightmapPairCollisionCompareWithNaiveTest<double>();
 }
 
+GTEST_TEST(HeightMapPairCollisionTest, BinaryCollisionWithMinHeightChannel) {
+  fcl::heightmap::heightmapPairBinaryCollisionWithMinHeightChannelTest<float>();
+  fcl::heightmap::heightmapPairBinaryCollisionWithMinHeightChannelTest<
+      double>();
+}
+
+GTEST_TEST(HeightMapPairCollisionTest, AlignedGrid) {
+  fcl::heightmap::heightmapPairAlignedGridTest<float>();
+  fcl::heightmap::heightmapPairAlignedGridTest<double>();
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -210,6 +210,39 @@ void heightmapCollisionRandomTests() {
   }
 }
 
+template <typename S>
+void heightmapRotatedShapeScanlineTests() {
+  // The flat impl only visits the pixels under the OBB footprint of each
+  // row, thus the elongated shapes along a diagonal are the hard cases
+  const auto points = generateRandomPointCloud(300000);
+  auto heightMap = std::make_shared<LayeredHeightMap<S>>(0.002, 512);
+  heightMap->updateHeightsByPointCloud3D(*points);
+  auto geometry = fcl::HeightMapCollisionGeometry<S>(heightMap);
+  geometry.computeLocalAABB();
+
+  const Eigen::Transform<S, 3, Eigen::Isometry> tf1 =
+      Eigen::Transform<S, 3, Eigen::Isometry>::Identity();
+  fcl::Capsule<S> capsule(0.02, 0.8);
+  capsule.computeLocalAABB();
+  fcl::Box<S> box(0.8, 0.03, 0.05);
+  box.computeLocalAABB();
+  for (int i = 0; i < 4; i++) {
+    const S yaw = S(0.2) + S(i) * S(M_PI / 4);
+    Eigen::Transform<S, 3, Eigen::Isometry> tf2;
+    tf2.setIdentity();
+    tf2.linear() = (Eigen::AngleAxis<S>(yaw, Vector3<S>::UnitZ()) *
+                    Eigen::AngleAxis<S>(S(M_PI / 2 - 0.1), Vector3<S>::UnitY()))
+                       .toRotationMatrix();
+    tf2.translation() = Vector3<S>(S(0.01) * i, S(-0.02) * i, S(0.05));
+    heightmapCollisionRandomTestByBottomLayer<S>(geometry, capsule, tf1, tf2);
+
+    tf2.linear() = (Eigen::AngleAxis<S>(yaw, Vector3<S>::UnitZ()) *
+                    Eigen::AngleAxis<S>(S(0.3), Vector3<S>::UnitX()))
+                       .toRotationMatrix();
+    heightmapCollisionRandomTestByBottomLayer<S>(geometry, box, tf1, tf2);
+  }
+}
+
 template <typename S, typename Shape>
 fcl::CollisionResult<S> runHeightMapCollision(
     const fcl::HeightMapCollisionGeometry<S>& map, const Shape& shape,
@@ -386,6 +419,46 @@ void heightmapFullCloudCollisionTests() {
   }
 }
 
+template <typename S>
+void heightmapSmallShapeCostModelTests() {
+  const auto points = generateRandomPointCloud(300000);
+  auto heightMap =
+      std::make_shared<LayeredHeightMap<S>>(0.002, 0.001, 256, 512);
+  heightMap->updateHeightsByPointCloud3D(*points);
+
+  // Cost models that make the automatic choice always flat or traversal
+  std::vector<HeightMapShapeCollisionCostModel<S>> cost_models(3);
+  cost_models[1].traversal_node_cost = 1e6;
+  cost_models[2].flat_pixel_cost = 1e6;
+  std::vector<fcl::HeightMapCollisionGeometry<S>> hm_geometries;
+  for (const auto& cost_model : cost_models) {
+    auto geometry = fcl::HeightMapCollisionGeometry<S>(heightMap);
+    geometry.setShapeCollisionCostModel(cost_model);
+    geometry.computeLocalAABB();
+    hm_geometries.push_back(geometry);
+  }
+
+  // Small shapes, for which the traversal is seeded from lower layers
+  std::array<S, 6> extent{-0.5, -0.5, 1.6, 0.5, 0.5, 2.0};
+  for (int i = 0; i < 20; i++) {
+    Eigen::Transform<S, 3, Eigen::Isometry> tf_shape;
+    test::generateRandomTransform(extent, tf_shape);
+    const Eigen::Transform<S, 3, Eigen::Isometry> tf_hm =
+        Eigen::Transform<S, 3, Eigen::Isometry>::Identity();
+
+    fcl::Box<S> box(0.03, 0.02, 0.05);
+    box.computeLocalAABB();
+    fcl::Sphere<S> sphere(0.02);
+    sphere.computeLocalAABB();
+    for (const auto& geometry : hm_geometries) {
+      heightmapCollisionRandomTestByBottomLayer<S>(geometry, box, tf_hm,
+                                                   tf_shape);
+      heightmapCollisionRandomTestByBottomLayer<S>(geometry, sphere, tf_hm,
+                                                   tf_shape);
+    }
+  }
+}
+
 }  // namespace heightmap
 }  // namespace fcl
 
@@ -394,11 +467,21 @@ GTEST_TEST(HeightMapShapeCollision, RandomTest) {
   fcl::heightmap::heightmapCollisionRandomTests<double>();
 }
 
+GTEST_TEST(HeightMapShapeCollision, RotatedShapeScanlineTest) {
+  fcl::heightmap::heightmapRotatedShapeScanlineTests<float>();
+  fcl::heightmap::heightmapRotatedShapeScanlineTests<double>();
+}
+
 GTEST_TEST(HeightMapShapeCollision, FullCloudTest) {
   fcl::heightmap::heightmapFullCloudCollisionTests<float>();
   fcl::heightmap::heightmapFullCloudCollisionTests<double>();
 }
 
+GTEST_TEST(HeightMapShapeCollision, SmallShapeCostModelTest) {
+  fcl::heightmap::heightmapSmallShapeCostModelTests<float>();
+  fcl::heightmap::heightmapSmallShapeCostModelTests<double>();
+}
+
 int main(int argc, char* argv[]) {
   std::cout.precision(std::numeric_limits<float>::max_digits10 + 10);
   ::testing::InitGoogleTest(&argc, argv);
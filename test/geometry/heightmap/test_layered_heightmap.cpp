@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <limits>
+#include <thread>
+
+
 #include "fcl/geometry/heightmap/layered_heightmap.h"
 #include "fcl/geometry/shape/utility.h"
 
@@ -201,6 +205,274 @@ void testAABBContainment() {
   }
 }
 
+template <typename S>
+void checkPyramidConsistency(const LayeredHeightMap<S>& height_map) {
+  // Each up pixel is the max of its 2x2 grid in the down layer
+  const auto& layers = height_map.layers();
+  for (std::size_t up_i = 0; up_i + 1 < layers.size(); up_i++) {
+    const auto& up_layer = layers[up_i];
+    const auto& down_layer = layers[up_i + 1];
+    EXPECT_EQ(up_layer.height_upper_bound_mm(),
+              down_layer.height_upper_bound_mm());
+    for (uint16_t y = 0; y < up_layer.full_shape_y(); y++) {
+      for (uint16_t x = 0; x < up_layer.full_shape_x(); x++) {
+        uint16_t expected_height = 0;
+        uint16_t expected_min_height = std::numeric_limits<uint16_t>::max();
+        for (uint16_t dy = 0; dy < 2; dy++) {
+          for (uint16_t dx = 0; dx < 2; dx++) {
+            const Pixel down_pixel{static_cast<uint16_t>(2 * x + dx),
+                                   static_cast<uint16_t>(2 * y + dy)};
+            expected_height =
+                std::max(expected_height, down_layer.pixelHeight(down_pixel));
+            expected_min_height = std::min(
+                expected_min_height,
+                height_map.pixelMinHeight(up_i + 1, down_pixel));
+          }
+        }
+        ASSERT_EQ(expected_height, up_layer.pixelHeight(Pixel{x, y}));
+
+        // The min channel, which is zero if disabled
+        if (!height_map.min_height_channel_enabled()) expected_min_height = 0;
+        ASSERT_EQ(expected_min_height,
+                  height_map.pixelMinHeight(up_i, Pixel{x, y}));
+      }
+    }
+  }
+
+  // The upper bound is tight
+  uint16_t max_height_in_mm = 0;
+  const auto& bottom_layer = height_map.bottom();
+  for (uint16_t y = 0; y < bottom_layer.full_shape_y(); y++) {
+    for (uint16_t x = 0; x < bottom_layer.full_shape_x(); x++) {
+      max_height_in_mm =
+          std::max(max_height_in_mm, bottom_layer.pixelHeight(Pixel{x, y}));
+    }
+  }
+  EXPECT_EQ(max_height_in_mm, height_map.height_upper_bound_mm());
+}
+
+template <typename S>
+void testPyramidRebuild(bool enable_min_height_channel) {
+  // Height map dims
+  std::vector<LayeredHeightMap<S>> height_map_to_test;
+  generateRepresentativeHeightMapConfiguration(height_map_to_test);
+  height_map_to_test.emplace_back(LayeredHeightMap<S>(0.001, 4));
+  height_map_to_test.emplace_back(LayeredHeightMap<S>(0.001, 0.001, 2, 64));
+
+  // Random heights covering the full uint16 range
+  auto update_heightmap_random =
+      [](const Pixel& pixel, const Point2D<S>& box_bottom_center,
+         uint16_t old_height_in_mm, uint16_t& new_height_in_mm) -> bool {
+    (void)(pixel);
+    (void)(box_bottom_center);
+    (void)(old_height_in_mm);
+    new_height_in_mm = static_cast<uint16_t>(std::rand() & 0xFFFF);
+    return false;
+  };
+
+  for (auto& height_map : height_map_to_test) {
+    height_map.setMinHeightChannelEnabled(enable_min_height_channel);
+    for (int n_threads : {1, 4, 0}) {
+      height_map.setPyramidRebuildThreads(n_threads);
+      height_map.updateHeightsByBottomLayerUpdateFunctor(
+          update_heightmap_random);
+      checkPyramidConsistency(height_map);
+    }
+  }
+}
+
+template <typename S>
+void testPyramidUpdateInROI(bool enable_min_height_channel) {
+  // Height map dims
+  std::vector<LayeredHeightMap<S>> height_map_to_test;
+  generateRepresentativeHeightMapConfiguration(height_map_to_test);
+
+  auto update_heightmap_random =
+      [](const Pixel& pixel, const Point2D<S>& box_bottom_center,
+         uint16_t old_height_in_mm, uint16_t& new_height_in_mm) -> bool {
+    (void)(pixel);
+    (void)(box_bottom_center);
+    (void)(old_height_in_mm);
+    new_height_in_mm = static_cast<uint16_t>(std::rand() % 1000);
+    return false;
+  };
+  auto erase_heightmap =
+      [](const Pixel& pixel, const Point2D<S>& box_bottom_center,
+         uint16_t old_height_in_mm, uint16_t& new_height_in_mm) -> bool {
+    (void)(pixel);
+    (void)(box_bottom_center);
+    (void)(old_height_in_mm);
+    new_height_in_mm = 0;
+    return false;
+  };
+
+  constexpr int test_n = 20;
+  for (auto& height_map : height_map_to_test) {
+    height_map.setMinHeightChannelEnabled(enable_min_height_channel);
+    height_map.updateHeightsByBottomLayerUpdateFunctor(update_heightmap_random);
+    const uint16_t full_shape_x = height_map.bottom().full_shape_x();
+    const uint16_t full_shape_y = height_map.bottom().full_shape_y();
+    for (int test_i = 0; test_i < test_n; test_i++) {
+      // A random roi, which might be partially out of the map
+      PixelSpaceROI roi;
+      roi.top_left.x = static_cast<uint16_t>(std::rand() % full_shape_x);
+      roi.top_left.y = static_cast<uint16_t>(std::rand() % full_shape_y);
+      roi.bottom_right.x =
+          static_cast<uint16_t>(roi.top_left.x + std::rand() % 100);
+      roi.bottom_right.y =
+          static_cast<uint16_t>(roi.top_left.y + std::rand() % 100);
+      if (test_i % 2 == 0) {
+        height_map.updateHeightsByBottomLayerUpdateFunctor(erase_heightmap,
+                                                           &roi);
+      } else {
+        height_map.updateHeightsByBottomLayerUpdateFunctor(
+            update_heightmap_random, &roi);
+      }
+      checkPyramidConsistency(height_map);
+    }
+
+    // Erase everything, the upper bound should reduce as well
+    PixelSpaceROI full_roi;
+    full_roi.bottom_right = Pixel(full_shape_x - 1, full_shape_y - 1);
+    height_map.updateHeightsByBottomLayerUpdateFunctor(erase_heightmap,
+                                                       &full_roi);
+    checkPyramidConsistency(height_map);
+    EXPECT_EQ(height_map.height_upper_bound_mm(), 0);
+  }
+}
+
+template <typename S>
+void testSparseTileStorage() {
+  LayeredHeightMap<S> height_map(0.002, 1024);
+  height_map.setMinHeightChannelEnabled(true);
+  EXPECT_EQ(height_map.allocated_bytes(), 0);
+
+  // Heights only in a patch, which shall only allocate a few tiles
+  PixelSpaceROI patch;
+  patch.top_left = Pixel(1000, 1500);
+  patch.bottom_right = Pixel(1100, 1550);
+  auto update_heightmap_random =
+      [](const Pixel& pixel, const Point2D<S>& box_bottom_center,
+         uint16_t old_height_in_mm, uint16_t& new_height_in_mm) -> bool {
+    (void)(pixel);
+    (void)(box_bottom_center);
+    (void)(old_height_in_mm);
+    new_height_in_mm = static_cast<uint16_t>(1 + std::rand() % 1000);
+    return false;
+  };
+  auto erase_heightmap =
+      [](const Pixel& pixel, const Point2D<S>& box_bottom_center,
+         uint16_t old_height_in_mm, uint16_t& new_height_in_mm) -> bool {
+    (void)(pixel);
+    (void)(box_bottom_center);
+    (void)(old_height_in_mm);
+    new_height_in_mm = 0;
+    return false;
+  };
+
+  // Both the roi and full rebuild
+  const std::size_t tile_bytes = HeightMapTiles::kTileSize * sizeof(uint16_t);
+  height_map.updateHeightsByBottomLayerUpdateFunctor(update_heightmap_random,
+                                                     &patch);
+  checkPyramidConsistency(height_map);
+  const std::size_t bytes_after_roi_update = height_map.allocated_bytes();
+  EXPECT_LE(bytes_after_roi_update, 100 * tile_bytes);
+  height_map.setPyramidRebuildThreads(4);
+  height_map.updateHeightsByBottomLayerUpdateFunctor(
+      [](const Pixel& pixel, const Point2D<S>& box_bottom_center,
+         uint16_t old_height_in_mm, uint16_t& new_height_in_mm) -> bool {
+        (void)(pixel);
+        (void)(box_bottom_center);
+        new_height_in_mm = old_height_in_mm;
+        return false;
+      });
+  checkPyramidConsistency(height_map);
+  EXPECT_EQ(height_map.allocated_bytes(), bytes_after_roi_update);
+
+  // Erase the patch
+  height_map.updateHeightsByBottomLayerUpdateFunctor(erase_heightmap, &patch);
+  checkPyramidConsistency(height_map);
+  EXPECT_EQ(height_map.height_upper_bound_mm(), 0);
+  height_map.resetHeights();
+  EXPECT_EQ(height_map.allocated_bytes(), 0);
+}
+
+template <typename S>
+std::vector<uint16_t> collectPixelHeights(
+    const LayeredHeightMap<S>& height_map) {
+  std::vector<uint16_t> heights;
+  for (std::size_t layer_i = 0; layer_i < height_map.n_layers(); layer_i++) {
+    const auto& layer = height_map.layers()[layer_i];
+    for (uint16_t y = 0; y < layer.full_shape_y(); y++) {
+      for (uint16_t x = 0; x < layer.full_shape_x(); x++) {
+        heights.push_back(layer.pixelHeight(Pixel{x, y}));
+        heights.push_back(height_map.pixelMinHeight(layer_i, Pixel{x, y}));
+      }
+    }
+  }
+  return heights;
+}
+
+template <typename S>
+void testCopyOnWriteSnapshot() {
+  LayeredHeightMap<S> height_map(0.002, 256);
+  height_map.setMinHeightChannelEnabled(true);
+  height_map.setPyramidRebuildThreads(4);
+  auto update_heightmap_random =
+      [](const Pixel& pixel, const Point2D<S>& box_bottom_center,
+         uint16_t old_height_in_mm, uint16_t& new_height_in_mm) -> bool {
+    (void)(pixel);
+    (void)(box_bottom_center);
+    (void)(old_height_in_mm);
+    new_height_in_mm = static_cast<uint16_t>(1 + std::rand() % 1000);
+    return false;
+  };
+  height_map.updateHeightsByBottomLayerUpdateFunctor(update_heightmap_random);
+
+  // The snapshot shares every tile
+  const auto snapshot = height_map.snapshot();
+  const std::vector<uint16_t> snapshot_heights = collectPixelHeights(*snapshot);
+  const std::size_t tile_bytes = HeightMapTiles::kTileSize * sizeof(uint16_t);
+  const std::size_t n_tiles = height_map.allocated_bytes() / tile_bytes;
+  EXPECT_EQ(height_map.n_tiles_shared_with(*snapshot), n_tiles);
+
+  // Read the snapshot in another thread while updating the map
+  std::thread reader([&]() -> void {
+    for (int i = 0; i < 10; i++) {
+      EXPECT_EQ(collectPixelHeights(*snapshot), snapshot_heights);
+    }
+  });
+
+  // An update in a small roi only clones the tiles covering it, which is
+  // one tile for each layer and channel
+  PixelSpaceROI roi;
+  roi.top_left = Pixel(10, 20);
+  roi.bottom_right = Pixel(30, 40);
+  height_map.updateHeightsByBottomLayerUpdateFunctor(update_heightmap_random,
+                                                     &roi);
+  checkPyramidConsistency(height_map);
+  EXPECT_EQ(height_map.n_tiles_shared_with(*snapshot),
+            n_tiles - (2 * height_map.n_layers() - 1));
+
+  // So does the update by points, followed by the full rebuild
+  constexpr int n_points = 1000;
+  std::vector<float> xyz;
+  for (int i = 0; i < n_points; i++) {
+    xyz.push_back(0.1f + (std::rand() % 20 + 0.5f) * 0.002f);
+    xyz.push_back(0.1f + (std::rand() % 20 + 0.5f) * 0.002f);
+    xyz.push_back((std::rand() % 2000 + 0.5f) * 0.001f);
+  }
+  height_map.updateHeightsByXYZBuffer(xyz.data(), n_points);
+  checkPyramidConsistency(height_map);
+  EXPECT_GE(height_map.n_tiles_shared_with(*snapshot),
+            n_tiles - 2 * (2 * height_map.n_layers() - 1));
+  reader.join();
+
+  // The snapshot is not affected by the updates
+  EXPECT_EQ(collectPixelHeights(*snapshot), snapshot_heights);
+  checkPyramidConsistency(*snapshot);
+}
+
 }  // namespace heightmap
 }  // namespace fcl
 
@@ -214,6 +486,33 @@ GTEST_TEST(LayeredHeightMapTest, AABB_ContainmentTest) {
   fcl::heightmap::testAABBContainment<double>();
 }
 
+GTEST_TEST(LayeredHeightMapTest, PyramidRebuildTest) {
+  fcl::heightmap::testPyramidRebuild<float>(false);
+  fcl::heightmap::testPyramidRebuild<double>(false);
+}
+
+GTEST_TEST(LayeredHeightMapTest, PyramidUpdateInROITest) {
+  fcl::heightmap::testPyramidUpdateInROI<float>(false);
+  fcl::heightmap::testPyramidUpdateInROI<double>(false);
+}
+
+GTEST_TEST(LayeredHeightMapTest, MinHeightChannelTest) {
+  fcl::heightmap::testPyramidRebuild<float>(true);
+  fcl::heightmap::testPyramidRebuild<double>(true);
+  fcl::heightmap::testPyramidUpdateInROI<float>(true);
+  fcl::heightmap::testPyramidUpdateInROI<double>(true);
+}
+
+GTEST_TEST(LayeredHeightMapTest, SparseTileStorageTest) {
+  fcl::heightmap::testSparseTileStorage<float>();
+  fcl::heightmap::testSparseTileStorage<double>();
+}
+
+GTEST_TEST(LayeredHeightMapTest, CopyOnWriteSnapshotTest) {
+  fcl::heightmap::testCopyOnWriteSnapshot<float>();
+  fcl::heightmap::testCopyOnWriteSnapshot<double>();
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,153 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#include <gtest/gtest.h>
+
+#include "fcl/geometry/octree2/octree_collision_geometry.h"
+#include "fcl/geometry/octree2/octree_lod.h"
+#include "fcl/narrowphase/detail/traversal/octree2/octree2_solver.h"
+#include "test_fcl_utility.h"
+
+namespace fcl {
+
+template <typename S>
+std::vector<AABB<S>> collectLeafBoxes(
+    const Octree2CollisionGeometry<S>& geometry) {
+  std::vector<AABB<S>> boxes;
+  auto visit_fn = [&boxes](const AABB<S>& aabb) -> bool {
+    boxes.push_back(aabb);
+    return false;
+  };
+  geometry.visitLeafNodes(visit_fn);
+  return boxes;
+}
+
+template <typename S>
+void checkCoarseGeometry(const Octree2CollisionGeometry<S>& fine,
+                         const Octree2CollisionGeometry<S>& coarse,
+                         std::uint8_t max_depth) {
+  const auto& tree = *fine.raw_octree();
+  const auto fine_boxes = collectLeafBoxes(fine);
+  const auto coarse_boxes = collectLeafBoxes(coarse);
+  const S eps = 1e-4;
+
+  // The coarse boxes are not below max_depth (or the bottom voxels), and each
+  // of them contains some fine box
+  const std::uint8_t min_box_depth =
+      std::min<std::uint8_t>(max_depth, tree.n_layers() - 1);
+  const Vector3<S>& min_box_size =
+      tree.layer_metas()[min_box_depth].resolution_xyz;
+  for (const auto& coarse_box : coarse_boxes) {
+    const Vector3<S> size = coarse_box.max_ - coarse_box.min_;
+    for (auto i = 0; i < 3; i++) EXPECT_GE(size[i], min_box_size[i] - eps);
+
+    AABB<S> inflated = coarse_box;
+    inflated.expand(Vector3<S>::Constant(eps));
+    bool contains_fine = false;
+    for (const auto& fine_box : fine_boxes) {
+      if (inflated.contain(fine_box.center())) {
+        contains_fine = true;
+        break;
+      }
+    }
+    EXPECT_TRUE(contains_fine);
+  }
+
+  // The coarse geometry is conservative
+  AABB<S> coarse_local_aabb = coarse.aabb_local;
+  coarse_local_aabb.expand(Vector3<S>::Constant(eps));
+  for (const auto& fine_box : fine_boxes) {
+    bool contained = false;
+    for (const auto& coarse_box : coarse_boxes) {
+      AABB<S> inflated = coarse_box;
+      inflated.expand(Vector3<S>::Constant(eps));
+      if (inflated.contain(fine_box)) {
+        contained = true;
+        break;
+      }
+    }
+    EXPECT_TRUE(contained);
+    EXPECT_TRUE(coarse_local_aabb.contain(fine_box));
+  }
+}
+
+template <typename S>
+void randomOctreeLODTest(std::uint16_t bottom_half_shape,
+                         std::size_t test_n_points,
+                         std::size_t test_n_collision) {
+  const S scalar_resolution = 0.4;
+  const S bottom_half_size = scalar_resolution * bottom_half_shape;
+  auto fine = test::makeRandomPointsAsOctrees<S>(
+      scalar_resolution, bottom_half_shape, test_n_points);
+  const auto n_layers = fine->raw_octree()->n_layers();
+
+  // Prune part of the tree, which should be respected by the coarse one
+  AABB<S> prune_aabb;
+  prune_aabb.min_.setConstant(-0.5 * bottom_half_size);
+  prune_aabb.max_.setConstant(0.5 * bottom_half_size);
+  Transform3<S> prune_pose;
+  prune_pose.setIdentity();
+  OBB<S> prune_obb;
+  convertBV(prune_aabb, prune_pose, prune_obb);
+  auto pruned = fine->pruneBy(prune_obb, false);
+
+  Box<S> box(bottom_half_size * 0.3, bottom_half_size * 0.15,
+             bottom_half_size * 0.2);
+  const S extent_scalar = bottom_half_size * 0.3;
+  std::array<S, 6> extent{-extent_scalar, -extent_scalar, -extent_scalar,
+                          extent_scalar,  extent_scalar,  extent_scalar};
+  detail::GJKSolver<S> gjk_solver;
+  detail::CollisionSolverOctree2<S> solver(&gjk_solver);
+  CollisionRequest<S> request;
+  Transform3<S> octree_pose, box_pose;
+  for (std::uint8_t depth = 0; depth < n_layers; depth++) {
+    for (const auto& geometry : {fine, pruned}) {
+      auto coarse = geometry->coarsenTo(depth);
+      EXPECT_TRUE(coarse->is_coarse());
+      checkCoarseGeometry(*geometry, *coarse, depth);
+
+      // Coarsen a coarse geometry is the same as coarsen the original
+      auto recoarse = coarse->coarsenTo(depth);
+      EXPECT_EQ(collectLeafBoxes(*recoarse).size(),
+                collectLeafBoxes(*coarse).size());
+
+      // A collision with the original implies a collision with the coarse
+      for (std::size_t i = 0; i < test_n_collision; i++) {
+        test::generateRandomTransform(extent, octree_pose);
+        test::generateRandomTransform(extent, box_pose);
+        CollisionResult<S> fine_result, coarse_result;
+        solver.OctreeShapeIntersect(geometry.get(), box, octree_pose, box_pose,
+                                    request, fine_result);
+        solver.OctreeShapeIntersect(coarse.get(), box, octree_pose, box_pose,
+                                    request, coarse_result);
+        if (fine_result.isCollision()) {
+          EXPECT_TRUE(coarse_result.isCollision());
+        }
+      }
+    }
+  }
+
+  // Prune a coarse geometry
+  auto coarse = fine->coarsenTo(1);
+  auto coarse_pruned = coarse->pruneBy(prune_obb, false);
+  EXPECT_TRUE(coarse_pruned->is_coarse());
+  checkCoarseGeometry(*pruned, *coarse_pruned, 1);
+  auto coarse_rebuilt = coarse_pruned->rebuildByConsolidatePruneInfo();
+  EXPECT_TRUE(coarse_rebuilt->is_coarse());
+  checkCoarseGeometry(*pruned, *coarse_rebuilt, 1);
+}
+
+}  // namespace fcl
+
+GTEST_TEST(Octree2LOD, RandomLODTest) {
+  fcl::randomOctreeLODTest<float>(2, 20, 10);
+  fcl::randomOctreeLODTest<double>(2, 20, 10);
+  fcl::randomOctreeLODTest<float>(32, 1000, 10);
+  fcl::randomOctreeLODTest<double>(32, 1000, 10);
+}
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
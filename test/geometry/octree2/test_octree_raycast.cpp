@@ -0,0 +1,165 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#include <gtest/gtest.h>
+
+#include "fcl/geometry/octree2/octree_collision_geometry.h"
+#include "fcl/geometry/octree2/octree_raycast.h"
+#include "test_fcl_utility.h"
+
+namespace fcl {
+
+template <typename S>
+bool bruteForceRayAABB(const Vector3<S>& origin, const Vector3<S>& direction,
+                       S max_distance, const AABB<S>& aabb, S& t_enter) {
+  S t_0 = 0;
+  S t_1 = max_distance;
+  for (auto i = 0; i < 3; i++) {
+    if (direction[i] == S(0.0)) {
+      if (origin[i] < aabb.min_[i] || origin[i] > aabb.max_[i]) return false;
+      continue;
+    }
+    S t_a = (aabb.min_[i] - origin[i]) / direction[i];
+    S t_b = (aabb.max_[i] - origin[i]) / direction[i];
+    if (t_a > t_b) std::swap(t_a, t_b);
+    t_0 = std::max(t_0, t_a);
+    t_1 = std::min(t_1, t_b);
+    if (t_0 > t_1) return false;
+  }
+  t_enter = t_0;
+  return true;
+}
+
+template <typename S>
+bool bruteForceCastRay(const Octree2CollisionGeometry<S>& geometry,
+                       const Vector3<S>& origin, const Vector3<S>& direction,
+                       S max_distance, S& distance) {
+  const Vector3<S> normalized = direction.normalized();
+  bool hit = false;
+  distance = max_distance;
+  auto visit_fn = [&](const AABB<S>& aabb) -> bool {
+    S t_enter;
+    if (bruteForceRayAABB(origin, normalized, max_distance, aabb, t_enter) &&
+        t_enter <= distance) {
+      hit = true;
+      distance = t_enter;
+    }
+    return false;
+  };
+  geometry.visitLeafNodes(visit_fn);
+  return hit;
+}
+
+template <typename S>
+void checkRandomRays(const Octree2CollisionGeometry<S>& geometry,
+                     S bottom_half_size, std::size_t test_n_rays) {
+  const S tolerance = 1e-3 * bottom_half_size;
+  for (std::size_t i = 0; i < test_n_rays; i++) {
+    Vector3<S> origin, direction;
+    origin.setRandom();
+    origin *= 1.5 * bottom_half_size;
+    direction.setRandom();
+    const S max_distance = 4 * bottom_half_size;
+
+    typename Octree2CollisionGeometry<S>::RayHit hit;
+    const bool has_hit =
+        geometry.castRay(origin, direction, max_distance, hit);
+    S expected_distance;
+    const bool expected_hit = bruteForceCastRay(geometry, origin, direction,
+                                                max_distance, expected_distance);
+    EXPECT_EQ(has_hit, expected_hit);
+    if (has_hit && expected_hit) {
+      EXPECT_NEAR(hit.distance, expected_distance, tolerance);
+      const Vector3<S> expected_point =
+          origin + hit.distance * direction.normalized();
+      EXPECT_NEAR((hit.point - expected_point).norm(), 0, tolerance);
+      // The point is on the boundary of the box
+      AABB<S> inflated_bv = hit.voxel_bv;
+      inflated_bv.expand(Vector3<S>::Constant(tolerance));
+      EXPECT_TRUE(inflated_bv.contain(hit.point));
+    }
+  }
+}
+
+template <typename S>
+void randomOctreeRayCastTest(std::uint16_t bottom_half_shape,
+                             std::size_t test_n_points,
+                             std::size_t test_n_rays) {
+  const S scalar_resolution = 0.4;
+  const S bottom_half_size = scalar_resolution * bottom_half_shape;
+  auto octree = test::makeRandomPointsAsOctrees<S>(
+      scalar_resolution, bottom_half_shape, test_n_points);
+  checkRandomRays(*octree, bottom_half_size, test_n_rays);
+
+  // The pruned part should be invisible
+  AABB<S> prune_aabb;
+  prune_aabb.min_.setConstant(-0.5 * bottom_half_size);
+  prune_aabb.max_.setConstant(0.5 * bottom_half_size);
+  Transform3<S> prune_pose;
+  prune_pose.setIdentity();
+  OBB<S> prune_obb;
+  convertBV(prune_aabb, prune_pose, prune_obb);
+  auto pruned = octree->pruneBy(prune_obb, false);
+  checkRandomRays(*pruned, bottom_half_size, test_n_rays);
+}
+
+template <typename S>
+void planeDepthImageTest(std::uint16_t bottom_half_shape) {
+  const S scalar_resolution = 0.4;
+  const S bottom_half_size = scalar_resolution * bottom_half_shape;
+  auto plane = test::makePlane_xOy_AsOctree2(bottom_half_shape,
+                                              scalar_resolution);
+
+  // Looking downward to the plane, whose top is at z = resolution
+  PinholeCameraIntrinsic<S> intrinsic;
+  intrinsic.width = 64;
+  intrinsic.height = 48;
+  intrinsic.fx = intrinsic.fy = 100;
+  intrinsic.cx = 32;
+  intrinsic.cy = 24;
+  Transform3<S> tf_camera;
+  tf_camera.setIdentity();
+  tf_camera.linear() =
+      AngleAxis<S>(constants<S>::pi(), Vector3<S>::UnitX()).toRotationMatrix();
+  const S camera_height = 0.5 * bottom_half_size;
+  tf_camera.translation() =
+      Vector3<S>(0.5 * bottom_half_size, 0.5 * bottom_half_size, camera_height);
+
+  std::vector<S> single_thread(intrinsic.n_pixels());
+  std::vector<S> multi_thread(intrinsic.n_pixels());
+  plane->renderDepthImage(intrinsic, tf_camera, 2 * bottom_half_size,
+                          single_thread.data(), 1);
+  plane->renderDepthImage(intrinsic, tf_camera, 2 * bottom_half_size,
+                          multi_thread.data(), 4);
+  const S expected_depth = camera_height - scalar_resolution;
+  for (std::size_t i = 0; i < single_thread.size(); i++) {
+    EXPECT_EQ(single_thread[i], multi_thread[i]);
+    EXPECT_NEAR(single_thread[i], expected_depth, 1e-3 * bottom_half_size);
+  }
+
+  // Too short to reach the plane
+  plane->renderDepthImage(intrinsic, tf_camera, S(0.5) * expected_depth,
+                          multi_thread.data(), 4);
+  for (const auto depth : multi_thread) EXPECT_EQ(depth, S(0.0));
+}
+
+}  // namespace fcl
+
+GTEST_TEST(Octree2RayCast, RandomRayTest) {
+  fcl::randomOctreeRayCastTest<float>(2, 20, 100);
+  fcl::randomOctreeRayCastTest<double>(2, 20, 100);
+  fcl::randomOctreeRayCastTest<float>(64, 1000 * 10, 100);
+  fcl::randomOctreeRayCastTest<double>(64, 1000 * 10, 100);
+}
+
+GTEST_TEST(Octree2RayCast, PlaneDepthImageTest) {
+  fcl::planeDepthImageTest<float>(64);
+  fcl::planeDepthImageTest<double>(64);
+}
+
+int main(int argc, char* argv[]) {
+  std::cout.precision(std::numeric_limits<float>::max_digits10 + 10);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
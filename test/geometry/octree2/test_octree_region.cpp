@@ -0,0 +1,170 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#include <gtest/gtest.h>
+
+#include "fcl/geometry/octree2/octree_collision_geometry.h"
+#include "fcl/geometry/octree2/octree_region.h"
+#include "test_fcl_utility.h"
+
+namespace fcl {
+
+/// Expand every visited box into bottom voxels and test them one by one
+template <typename S>
+std::vector<Vector3<S>> bruteForceExtractVoxels(
+    const Octree2CollisionGeometry<S>& geometry, const OBB<S>& region) {
+  const Vector3<S>& resolution = geometry.raw_octree()->bottom_resolution_xyz();
+  std::vector<Vector3<S>> voxels;
+  auto visit_fn = [&](const AABB<S>& aabb) -> bool {
+    Vector3<S> center;
+    for (S x = aabb.min_.x() + 0.5 * resolution.x(); x < aabb.max_.x();
+         x += resolution.x()) {
+      for (S y = aabb.min_.y() + 0.5 * resolution.y(); y < aabb.max_.y();
+           y += resolution.y()) {
+        for (S z = aabb.min_.z() + 0.5 * resolution.z(); z < aabb.max_.z();
+             z += resolution.z()) {
+          center << x, y, z;
+          if (region.contain(center)) voxels.push_back(center);
+        }
+      }
+    }
+    return false;
+  };
+  geometry.visitLeafNodes(visit_fn);
+  return voxels;
+}
+
+template <typename S>
+std::vector<Vector3<S>> sortVoxels(std::vector<Vector3<S>> voxels) {
+  auto less = [](const Vector3<S>& a, const Vector3<S>& b) -> bool {
+    return std::lexicographical_compare(a.data(), a.data() + 3, b.data(),
+                                        b.data() + 3);
+  };
+  std::sort(voxels.begin(), voxels.end(), less);
+  return voxels;
+}
+
+template <typename S>
+void checkExtractedVoxels(const Octree2CollisionGeometry<S>& geometry,
+                          const OBB<S>& region) {
+  const auto expected = sortVoxels(bruteForceExtractVoxels(geometry, region));
+
+  // Query the size with an empty buffer
+  const std::size_t n_voxels =
+      geometry.extractOccupiedVoxels(region, nullptr, 0);
+  EXPECT_EQ(n_voxels, expected.size());
+
+  // A partial buffer only receives the first voxels
+  if (n_voxels > 1) {
+    std::vector<float> partial(3 * (n_voxels / 2));
+    EXPECT_EQ(geometry.extractOccupiedVoxels(region, partial.data(),
+                                             n_voxels / 2),
+              n_voxels);
+  }
+
+  std::vector<float> buffer(3 * n_voxels);
+  EXPECT_EQ(geometry.extractOccupiedVoxels(region, buffer.data(), n_voxels),
+            n_voxels);
+  std::vector<Vector3<S>> extracted;
+  for (std::size_t i = 0; i < n_voxels; i++) {
+    extracted.emplace_back(buffer[3 * i + 0], buffer[3 * i + 1],
+                           buffer[3 * i + 2]);
+  }
+  extracted = sortVoxels(extracted);
+  if (extracted.size() != expected.size()) return;
+  for (std::size_t i = 0; i < expected.size(); i++) {
+    EXPECT_NEAR((extracted[i] - expected[i]).norm(), 0, 1e-4);
+  }
+}
+
+/// A solid cube in the positive octant, which contains fully occupied nodes
+template <typename S>
+std::shared_ptr<const Octree2CollisionGeometry<S>> makeSolidCubeAsOctree2(
+    std::uint16_t bottom_half_shape, S scalar_resolution) {
+  auto point_fn = [&](int index, S& x, S& y, S& z) -> void {
+    x = (S(index % bottom_half_shape) + 0.5) * scalar_resolution;
+    y = (S((index / bottom_half_shape) % bottom_half_shape) + 0.5) *
+        scalar_resolution;
+    z = (S(index / (bottom_half_shape * bottom_half_shape)) + 0.5) *
+        scalar_resolution;
+  };
+  auto tree = std::make_shared<octree2::Octree<S>>(scalar_resolution,
+                                                   bottom_half_shape);
+  tree->rebuildTree(point_fn, bottom_half_shape * bottom_half_shape *
+                                  bottom_half_shape);
+  auto tree_geom = std::make_shared<Octree2CollisionGeometry<S>>(tree);
+  tree_geom->computeLocalAABB();
+  return tree_geom;
+}
+
+template <typename S>
+void randomOctreeRegionTest(std::uint16_t bottom_half_shape,
+                            std::size_t test_n_points,
+                            std::size_t test_n_regions) {
+  const S scalar_resolution = 0.4;
+  const S bottom_half_size = scalar_resolution * bottom_half_shape;
+  auto octree = test::makeRandomPointsAsOctrees<S>(
+      scalar_resolution, bottom_half_shape, test_n_points);
+  auto plane =
+      test::makePlane_xOy_AsOctree2<S>(bottom_half_shape, scalar_resolution);
+  auto cube = makeSolidCubeAsOctree2<S>(bottom_half_shape, scalar_resolution);
+
+  const S extent_scalar = bottom_half_size * 0.5;
+  std::array<S, 6> extent{-extent_scalar, -extent_scalar, -extent_scalar,
+                          extent_scalar,  extent_scalar,  extent_scalar};
+  Transform3<S> region_pose;
+  for (std::size_t i = 0; i < test_n_regions; i++) {
+    test::generateRandomTransform(extent, region_pose);
+    AABB<S> region_aabb;
+    region_aabb.min_.setRandom();
+    region_aabb.min_ = -region_aabb.min_.cwiseAbs() * bottom_half_size;
+    region_aabb.max_.setRandom();
+    region_aabb.max_ = region_aabb.max_.cwiseAbs() * bottom_half_size;
+    OBB<S> region;
+    convertBV(region_aabb, region_pose, region);
+    checkExtractedVoxels(*octree, region);
+    checkExtractedVoxels(*plane, region);
+    checkExtractedVoxels(*cube, region);
+
+    // The AABB overload gives the same voxels as an axis-aligned OBB
+    Transform3<S> identity;
+    identity.setIdentity();
+    OBB<S> aligned_region;
+    convertBV(region_aabb, identity, aligned_region);
+    EXPECT_EQ(cube->extractOccupiedVoxels(region_aabb, nullptr, 0),
+              cube->extractOccupiedVoxels(aligned_region, nullptr, 0));
+  }
+
+  // The pruned part should be ignored
+  AABB<S> prune_aabb;
+  prune_aabb.min_.setConstant(-0.5 * bottom_half_size);
+  prune_aabb.max_.setConstant(0.5 * bottom_half_size);
+  Transform3<S> prune_pose;
+  prune_pose.setIdentity();
+  OBB<S> prune_obb;
+  convertBV(prune_aabb, prune_pose, prune_obb);
+  auto pruned_plane = plane->pruneBy(prune_obb, false);
+  auto pruned_cube = cube->pruneBy(prune_obb, false);
+  for (std::size_t i = 0; i < test_n_regions; i++) {
+    test::generateRandomTransform(extent, region_pose);
+    OBB<S> region;
+    convertBV(prune_aabb, region_pose, region);
+    checkExtractedVoxels(*pruned_plane, region);
+    checkExtractedVoxels(*pruned_cube, region);
+  }
+}
+
+}  // namespace fcl
+
+GTEST_TEST(Octree2Region, RandomRegionTest) {
+  fcl::randomOctreeRegionTest<float>(2, 20, 20);
+  fcl::randomOctreeRegionTest<double>(2, 20, 20);
+  fcl::randomOctreeRegionTest<float>(32, 1000 * 10, 20);
+  fcl::randomOctreeRegionTest<double>(32, 1000 * 10, 20);
+}
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -171,8 +171,120 @@ void randomOctreeCollisionWithBox(std::uint16_t bottom_half_shape = 2,
   }
 }
 
+template <typename S, typename Shape>
+void randomOctreeCollisionWithSweptSphere(const Shape& shape,
+                                          std::uint16_t bottom_half_shape,
+                                          std::size_t test_n_points,
+                                          std::size_t test_n_collision,
+                                          bool use_mpr_batch = false) {
+  const S scalar_resolution = 0.4;
+  const S bottom_half_size = scalar_resolution * bottom_half_shape;
+  auto octree = test::makeRandomPointsAsOctrees<S>(
+      scalar_resolution, bottom_half_shape, test_n_points);
+  const S extent_scalar = bottom_half_size * 0.3;
+  std::array<S, 6> extent{-extent_scalar, -extent_scalar, -extent_scalar,
+                          extent_scalar,  extent_scalar,  extent_scalar};
+
+  detail::GJKSolver<S> gjk_solver;
+  gjk_solver.use_mpr_batch = use_mpr_batch;
+  detail::CollisionSolverOctree2<S> solver(&gjk_solver);
+  Transform3<S> octree_pose, shape_pose;
+  CollisionRequest<S> request;
+  request.setMaxContactCount(100000);
+  CollisionRequest<S> penetration_request = request;
+  request.disablePenetration();
+  penetration_request.useDefaultPenetration();
+  for (std::size_t i = 0; i < test_n_collision; i++) {
+    test::generateRandomTransform(extent, octree_pose);
+    test::generateRandomTransform(extent, shape_pose);
+    CollisionResult<S> result_i;
+    solver.OctreeShapeIntersect(octree.get(), shape, octree_pose, shape_pose,
+                                request, result_i);
+
+    // Verify by traverse with the generic solver
+    std::size_t n_traverse_colliding = 0;
+    auto visit_fn = [&](const AABB<S>& bv) -> bool {
+      Box<S> box_local;
+      Transform3<S> box_tf_local;
+      constructBox(bv, octree_pose, box_local, box_tf_local);
+      CollisionResult<S> box_pair_result;
+      fcl::collide(&box_local, box_tf_local, &shape, shape_pose, request,
+                   box_pair_result);
+      if (box_pair_result.isCollision()) n_traverse_colliding++;
+      return false;
+    };
+    octree->visitLeafNodes(visit_fn);
+    EXPECT_EQ(result_i.numContacts(), n_traverse_colliding);
+
+    // The penetration goes through the solver after analytic culling
+    CollisionResult<S> penetration_result_i;
+    solver.OctreeShapeIntersect(octree.get(), shape, octree_pose, shape_pose,
+                                penetration_request, penetration_result_i);
+    EXPECT_EQ(penetration_result_i.numContacts(), n_traverse_colliding);
+  }
+}
+
+template <typename S>
+void segmentAABBDistanceTest(std::size_t test_n_segments) {
+  AABB<S> box(Vector3<S>(-0.3, -0.2, -0.1), Vector3<S>(0.1, 0.2, 0.3));
+  for (std::size_t i = 0; i < test_n_segments; i++) {
+    Vector3<S> p0, p1;
+    p0.setRandom();
+    p1.setRandom();
+    if (i % 4 == 0) p1.x() = p0.x();  // Axis-parallel cases
+    const S distance_square =
+        detail::segmentAABBSquaredDistance(p0, p1, box.min_, box.max_);
+
+    // Dense sampling is an upper bound, and should be close
+    S sampled_distance_square = std::numeric_limits<S>::max();
+    const int n_samples = 2000;
+    for (int j = 0; j <= n_samples; j++) {
+      const Vector3<S> point = p0 + (p1 - p0) * (S(j) / n_samples);
+      const Vector3<S> closest =
+          point.cwiseMax(box.min_).cwiseMin(box.max_);
+      sampled_distance_square =
+          std::min(sampled_distance_square, (point - closest).squaredNorm());
+    }
+    EXPECT_LE(distance_square, sampled_distance_square + 1e-5);
+    EXPECT_NEAR(std::sqrt(distance_square), std::sqrt(sampled_distance_square),
+                2e-3);
+  }
+}
+
 }  // namespace fcl
 
+GTEST_TEST(Octree2ShapeCollision, SegmentAABBDistanceTest) {
+  fcl::segmentAABBDistanceTest<float>(100);
+  fcl::segmentAABBDistanceTest<double>(100);
+}
+
+GTEST_TEST(Octree2ShapeCollision, RandomSphereCapsuleTest) {
+  fcl::randomOctreeCollisionWithSweptSphere<float>(
+      fcl::Sphere<float>(0.6), 2, 20, 20);
+  fcl::randomOctreeCollisionWithSweptSphere<double>(
+      fcl::Sphere<double>(0.6), 2, 20, 20);
+  fcl::randomOctreeCollisionWithSweptSphere<float>(
+      fcl::Capsule<float>(0.3, 1.0), 2, 20, 20);
+  fcl::randomOctreeCollisionWithSweptSphere<double>(
+      fcl::Capsule<double>(0.3, 1.0), 2, 20, 20);
+  fcl::randomOctreeCollisionWithSweptSphere<double>(
+      fcl::Sphere<double>(3.0), 64, 1000 * 100, 10);
+  fcl::randomOctreeCollisionWithSweptSphere<double>(
+      fcl::Capsule<double>(1.5, 5.0), 64, 1000 * 100, 10);
+}
+
+GTEST_TEST(Octree2ShapeCollision, RandomBatchedShapeTest) {
+  // The leaf pairs of these shapes are evaluated in batches
+  fcl::randomOctreeCollisionWithSweptSphere<float>(
+      fcl::Cylinder<float>(0.3, 1.0), 2, 20, 20, true);
+  fcl::randomOctreeCollisionWithSweptSphere<double>(
+      fcl::Cylinder<double>(0.3, 1.0), 2, 20, 20, true);
+  fcl::randomOctreeCollisionWithSweptSphere<double>(
+      fcl::Ellipsoid<double>(0.3, 0.5, 1.0), 2, 20, 20, true);
+  fcl::randomOctreeCollisionWithSweptSphere<double>(
+      fcl::Cylinder<double>(1.5, 5.0), 64, 1000 * 100, 10, true);
+}
+
 GTEST_TEST(Octree2ShapeCollision, RandomBoxTest) {
   fcl::randomOctreeCollisionWithBox<float>(2, 20, 20);
   fcl::randomOctreeCollisionWithBox<double>(2, 20, 20);
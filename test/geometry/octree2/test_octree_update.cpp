@@ -0,0 +1,208 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#include <gtest/gtest.h>
+
+#include "fcl/geometry/octree2/octree.h"
+#include "fcl/geometry/octree2/octree_visit.h"
+#include "test_fcl_utility.h"
+
+namespace fcl {
+namespace octree2 {
+
+template <typename S>
+typename Octree<S>::PointGenerationFunc makePointGenerator(
+    const std::vector<Vector3<S>>& points) {
+  return [&points](int index, S& x, S& y, S& z) -> void {
+    x = points[index].x();
+    y = points[index].y();
+    z = points[index].z();
+  };
+}
+
+/// The number of bottom voxels counted by visiting the tree
+template <typename S>
+std::size_t countVisitedVoxels(const Octree<S>& tree) {
+  const Vector3<S>& resolution = tree.bottom_resolution_xyz();
+  const S voxel_volume = resolution.x() * resolution.y() * resolution.z();
+  S volume = 0;
+  auto visitor = [&](const AABB<S>& aabb, std::uint8_t, bool is_leaf) -> bool {
+    if (is_leaf) volume += aabb.volume();
+    return false;
+  };
+  visitOctree<S>(tree, visitor);
+  return static_cast<std::size_t>(std::round(volume / voxel_volume));
+}
+
+template <typename S>
+void checkSameOccupancy(const Octree<S>& updated, const Octree<S>& rebuilt) {
+  std::vector<OctreeVoxelKey> updated_keys, rebuilt_keys;
+  updated.collectSortedVoxelKeys(updated_keys);
+  rebuilt.collectSortedVoxelKeys(rebuilt_keys);
+  EXPECT_EQ(updated_keys, rebuilt_keys);
+  EXPECT_EQ(countVisitedVoxels(updated), rebuilt_keys.size());
+  EXPECT_EQ(countVisitedVoxels(rebuilt), rebuilt_keys.size());
+  EXPECT_NEAR((updated.leaf_points_AABB().min_ - rebuilt.leaf_points_AABB().min_)
+                  .norm(),
+              0, 1e-6);
+  EXPECT_NEAR((updated.leaf_points_AABB().max_ - rebuilt.leaf_points_AABB().max_)
+                  .norm(),
+              0, 1e-6);
+}
+
+GTEST_TEST(Octree2Update, VoxelKeyTest) {
+  OctreeVoxel voxel;
+  voxel.x() = 1;
+  voxel.y() = 0;
+  voxel.z() = 0;
+  EXPECT_EQ(encodeVoxelKey(voxel), 1u);
+  voxel.x() = 0;
+  voxel.y() = 1;
+  EXPECT_EQ(encodeVoxelKey(voxel), 2u);
+  voxel.y() = 0;
+  voxel.z() = 1;
+  EXPECT_EQ(encodeVoxelKey(voxel), 4u);
+
+  for (int i = 0; i < 1000; i++) {
+    voxel.x() = static_cast<std::uint16_t>(std::rand());
+    voxel.y() = static_cast<std::uint16_t>(std::rand());
+    voxel.z() = static_cast<std::uint16_t>(std::rand());
+    const OctreeVoxel decoded = decodeVoxelKey(encodeVoxelKey(voxel));
+    EXPECT_EQ(decoded.xyz, voxel.xyz);
+  }
+}
+
+template <typename S>
+void randomUpdateTest(std::uint16_t bottom_half_shape, std::size_t n_points,
+                      std::size_t n_changed_points) {
+  const S resolution = 0.4;
+  const S bottom_half_size = resolution * bottom_half_shape;
+  auto random_point = [&]() -> Vector3<S> {
+    Vector3<S> point;
+    point.setRandom();
+    return point * (0.99 * bottom_half_size);
+  };
+
+  // The first frame
+  std::vector<Vector3<S>> points;
+  for (std::size_t i = 0; i < n_points; i++) points.push_back(random_point());
+  Octree<S> updated(resolution, bottom_half_shape);
+  updated.rebuildTree(makePointGenerator(points), points.size());
+
+  // Consecutive frames, each removes and adds some points
+  for (int frame = 0; frame < 5; frame++) {
+    std::vector<OctreeVoxelKey> old_keys;
+    updated.collectSortedVoxelKeys(old_keys);
+    points.erase(points.begin(), points.begin() + n_changed_points);
+    for (std::size_t i = 0; i < n_changed_points; i++)
+      points.push_back(random_point());
+
+    OctreeUpdateDelta<S> delta;
+    updated.updateTree(makePointGenerator(points), points.size(), &delta);
+    Octree<S> rebuilt(resolution, bottom_half_shape);
+    rebuilt.rebuildTree(makePointGenerator(points), points.size());
+    checkSameOccupancy(updated, rebuilt);
+
+    // The delta should match the difference of the keys
+    std::vector<OctreeVoxelKey> new_keys;
+    rebuilt.collectSortedVoxelKeys(new_keys);
+    std::vector<OctreeVoxelKey> expected_added, expected_removed;
+    std::set_difference(new_keys.begin(), new_keys.end(), old_keys.begin(),
+                        old_keys.end(), std::back_inserter(expected_added));
+    std::set_difference(old_keys.begin(), old_keys.end(), new_keys.begin(),
+                        new_keys.end(), std::back_inserter(expected_removed));
+    ASSERT_EQ(delta.added_voxels.size(), expected_added.size());
+    ASSERT_EQ(delta.removed_voxels.size(), expected_removed.size());
+    for (std::size_t i = 0; i < expected_added.size(); i++)
+      EXPECT_EQ(encodeVoxelKey(delta.added_voxels[i]), expected_added[i]);
+    for (std::size_t i = 0; i < expected_removed.size(); i++)
+      EXPECT_EQ(encodeVoxelKey(delta.removed_voxels[i]), expected_removed[i]);
+    if (delta.empty()) continue;
+
+    // The changed voxels are within the changed part
+    EXPECT_EQ(delta.changed_inner_nodes.front(), 0u);
+    EXPECT_LE(delta.changed_inner_nodes.size(), updated.n_inner_nodes());
+    EXPECT_LE(delta.changed_leaf_nodes.size(),
+              delta.added_voxels.size() + delta.removed_voxels.size());
+    const S eps = 1e-4;
+    for (const auto& point : points) {
+      OctreeVoxel voxel;
+      if (!updated.computeVoxelCoordinate(point, voxel)) continue;
+      const auto key = encodeVoxelKey(voxel);
+      if (!std::binary_search(expected_added.begin(), expected_added.end(),
+                              key)) {
+        continue;
+      }
+      AABB<S> inflated = delta.changed_aabb;
+      inflated.expand(Vector3<S>::Constant(eps));
+      EXPECT_TRUE(inflated.contain(point));
+    }
+  }
+}
+
+GTEST_TEST(Octree2Update, RandomUpdateTest) {
+  randomUpdateTest<float>(2, 20, 5);
+  randomUpdateTest<double>(2, 20, 5);
+  randomUpdateTest<float>(64, 1000 * 10, 500);
+  randomUpdateTest<double>(64, 1000 * 10, 500);
+}
+
+template <typename S>
+void solidCubeUpdateTest() {
+  // A solid cube in the positive octant, whose nodes are fully occupied
+  const S resolution = 0.4;
+  const std::uint16_t bottom_half_shape = 8;
+  std::vector<Vector3<S>> points;
+  for (int x = 0; x < bottom_half_shape; x++) {
+    for (int y = 0; y < bottom_half_shape; y++) {
+      for (int z = 0; z < bottom_half_shape; z++) {
+        points.emplace_back((x + 0.5) * resolution, (y + 0.5) * resolution,
+                            (z + 0.5) * resolution);
+      }
+    }
+  }
+  Octree<S> tree(resolution, bottom_half_shape);
+  tree.rebuildTree(makePointGenerator(points), points.size());
+  EXPECT_TRUE(tree.inner_nodes_fully_occupied()[1]);
+
+  // Remove a corner then add it back
+  const Vector3<S> corner = points.back();
+  points.pop_back();
+  OctreeUpdateDelta<S> delta;
+  tree.updateTree(makePointGenerator(points), points.size(), &delta);
+  EXPECT_EQ(delta.added_voxels.size(), 0u);
+  EXPECT_EQ(delta.removed_voxels.size(), 1u);
+  EXPECT_EQ(delta.changed_leaf_nodes.size(), 1u);
+  EXPECT_EQ(countVisitedVoxels(tree), points.size());
+  EXPECT_FALSE(tree.isPointOccupied(corner));
+  for (const auto changed : delta.changed_inner_nodes)
+    EXPECT_FALSE(tree.inner_nodes_fully_occupied()[changed]);
+
+  const auto n_inner_nodes = tree.n_inner_nodes();
+  points.push_back(corner);
+  tree.updateTree(makePointGenerator(points), points.size(), &delta);
+  EXPECT_EQ(delta.added_voxels.size(), 1u);
+  EXPECT_EQ(delta.removed_voxels.size(), 0u);
+  EXPECT_EQ(tree.n_inner_nodes(), n_inner_nodes);
+  EXPECT_EQ(countVisitedVoxels(tree), points.size());
+  EXPECT_TRUE(tree.isPointOccupied(corner));
+
+  // No change
+  tree.updateTree(makePointGenerator(points), points.size(), &delta);
+  EXPECT_TRUE(delta.empty());
+  EXPECT_TRUE(delta.changed_inner_nodes.empty());
+}
+
+GTEST_TEST(Octree2Update, SolidCubeUpdateTest) {
+  solidCubeUpdateTest<float>();
+  solidCubeUpdateTest<double>();
+}
+
+}  // namespace octree2
+}  // namespace fcl
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,86 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "fcl/geometry/shape/convex.h"
+
+using namespace fcl;
+
+// The linear search over the AoS vertices, which is the one before the SoA
+template <typename S>
+int findExtremeVertexIndexAoS(const std::vector<Vector3<S>>& vertices,
+                              const Vector3<S>& v_C) {
+  int extreme_index = 0;
+  S extreme_value = v_C.dot(vertices[extreme_index]);
+  for (int i = 1; i < static_cast<int>(vertices.size()); ++i) {
+    S value = v_C.dot(vertices[i]);
+    if (value > extreme_value) {
+      extreme_index = i;
+      extreme_value = value;
+    }
+  }
+  return extreme_index;
+}
+
+template <typename S>
+void naiveSupportBenchmark(int n_vertices) {
+  // Random vertices on the unit sphere. The faces are only a single polygon,
+  // as the topology is not used by the linear search.
+  auto vertices = std::make_shared<std::vector<Vector3<S>>>();
+  auto faces = std::make_shared<std::vector<int>>();
+  faces->push_back(n_vertices);
+  for (int i = 0; i < n_vertices; i++) {
+    vertices->push_back(Vector3<S>::Random().normalized());
+    faces->push_back(i);
+  }
+  Convex<S> convex(vertices, 1, faces, false);
+
+  constexpr int test_n = 1e6;
+  std::vector<Vector3<S>> directions(test_n);
+  for (auto& direction : directions) direction.setRandom();
+
+  // The AoS search
+  int index_sum = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (const auto& direction : directions) {
+    index_sum += findExtremeVertexIndexAoS(*vertices, direction);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  auto ms_time =
+      std::chrono::duration_cast<std::chrono::milliseconds>((end - start))
+          .count();
+  std::cout << n_vertices << " vertices, AoS time in ms " << ms_time
+            << std::endl;
+
+  // The SoA search
+  int soa_index_sum = 0;
+  start = std::chrono::high_resolution_clock::now();
+  for (const auto& direction : directions) {
+    soa_index_sum += static_cast<int>(
+        &convex.findExtremeVertexNaive(direction) - vertices->data());
+  }
+  end = std::chrono::high_resolution_clock::now();
+  ms_time = std::chrono::duration_cast<std::chrono::milliseconds>((end - start))
+                .count();
+  std::cout << n_vertices << " vertices, SoA time in ms " << ms_time
+            << std::endl;
+  if (index_sum != soa_index_sum) {
+    std::cout << "The AoS and SoA results are different" << std::endl;
+  }
+}
+
+int main() {
+  std::cout << "Test with float" << std::endl;
+  for (int n_vertices : {8, 12, 20, 32}) {
+    naiveSupportBenchmark<float>(n_vertices);
+  }
+  std::cout << "Test with double" << std::endl;
+  for (int n_vertices : {8, 12, 20, 32}) {
+    naiveSupportBenchmark<double>(n_vertices);
+  }
+}
@@ -62,6 +62,11 @@ class ConvexTester {
     convex->find_extreme_via_neighbors_ = true;
     convex->initExtremeViaNeighborCache();
   }
+
+  template <typename S>
+  static bool find_extreme_via_cubemap(const Convex<S>& convex) {
+    return convex.find_extreme_via_cubemap_;
+  }
 };
 namespace {
 
@@ -803,6 +808,51 @@ class TessellatedSphere final : public Polytope<double> {
   int vertex_count() const final { return 58; }
 };
 
+// A finer tessellated unit sphere; n longitudinal wedges and n latitudinal
+// bands, each band split into triangles. Used for the large convex tests.
+class FineTessellatedSphere final : public Polytope<double> {
+ public:
+  explicit FineTessellatedSphere(int n) : Polytope<double>(1.0), n_(n) {
+    // The poles, then the rings between the bands from north to south
+    const double dphi = M_PI / n;
+    const double dtheta = 2 * M_PI / n;
+    vertices_->push_back({0, 0, 1});
+    for (int slice = 1; slice < n; ++slice) {
+      const double z = std::cos(slice * dphi);
+      const double r = std::sin(slice * dphi);
+      for (int i = 0; i < n; ++i) {
+        vertices_->emplace_back(std::cos(dtheta * i) * r,
+                                std::sin(dtheta * i) * r, z);
+      }
+    }
+    vertices_->push_back({0, 0, -1});
+
+    // The index of the ith vertex on the ring between slice and slice + 1
+    auto ring = [n](int slice, int i) { return 1 + (slice - 1) * n + i % n; };
+    const int south_pole = vertex_count() - 1;
+    for (int i = 0; i < n; ++i) {
+      this->add_face({0, ring(1, i), ring(1, i + 1)});
+      this->add_face({south_pole, ring(n - 1, i + 1), ring(n - 1, i)});
+    }
+    for (int slice = 1; slice < n - 1; ++slice) {
+      for (int i = 0; i < n; ++i) {
+        this->add_face({ring(slice, i), ring(slice + 1, i),
+                        ring(slice + 1, i + 1)});
+        this->add_face({ring(slice, i), ring(slice + 1, i + 1),
+                        ring(slice, i + 1)});
+      }
+    }
+
+    this->confirm_data();
+  }
+  // Properties of the polytope.
+  int face_count() const final { return 2 * n_ * (n_ - 1); }
+  int vertex_count() const final { return (n_ - 1) * n_ + 2; }
+
+ private:
+  int n_;
+};
+
 // Confirm that edge walking gets disabled in expected cases.
 GTEST_TEST(ConvexGeometry, UseEdgeWalkingConditions) {
     const bool throw_if_invalid{true};
@@ -824,7 +874,89 @@ GTEST_TEST(ConvexGeometry, UseEdgeWalkingConditions) {
         TessellatedSphere poly;
         Convex<double> convex = poly.MakeConvex(throw_if_invalid);
         EXPECT_TRUE(ConvexTester::find_extreme_via_neighbors(convex));
+        EXPECT_FALSE(ConvexTester::find_extreme_via_cubemap(convex));
+    }
+}
+
+// For a large convex, the support vertex seeded by the direction cube map
+// must be as extreme as the one found by linear search.
+GTEST_TEST(ConvexGeometry, SupportVertexViaCubemap) {
+  // 1562 vertices
+  FineTessellatedSphere poly(40);
+  Convex<double> convex = poly.MakeConvex(true);
+  EXPECT_TRUE(ConvexTester::find_extreme_via_neighbors(convex));
+  EXPECT_TRUE(ConvexTester::find_extreme_via_cubemap(convex));
+
+  // The copy keeps the cube map
+  const Convex<double> convex_copy(convex);
+  EXPECT_TRUE(ConvexTester::find_extreme_via_cubemap(convex_copy));
+
+  // Random directions, the axis directions and the cell boundaries
+  std::vector<Vector3d> directions;
+  std::srand(0);
+  for (int i = 0; i < 2000; ++i) {
+    directions.push_back(Vector3d::Random());
+  }
+  for (int axis = 0; axis < 3; ++axis) {
+    directions.push_back(Vector3d::Unit(axis));
+    directions.push_back(-Vector3d::Unit(axis));
+  }
+  directions.emplace_back(1, 1, 1);
+  directions.emplace_back(-1, 0.5, 0.25);
+  directions.emplace_back(0.125, -1, -0.375);
+
+  for (const Vector3d& v_C : directions) {
+    if (v_C.norm() < 1e-3) continue;
+    const double extreme_value = v_C.dot(convex.findExtremeVertexNaive(v_C));
+    EXPECT_NEAR(v_C.dot(convex.findExtremeVertex(v_C)), extreme_value,
+                1e-12);
+    EXPECT_NEAR(v_C.dot(convex_copy.findExtremeVertex(v_C)), extreme_value,
+                1e-12);
+  }
+}
+
+// The SoA (SIMD) linear search must report the first vertex that is the most
+// extreme, the same as the linear search over the vertices.
+template <typename S>
+void testSupportVertexNaiveSoA(const Polytope<S>& polytope) {
+  const Convex<S> convex = polytope.MakeConvex(false);
+  const std::vector<Vector3<S>>& vertices = convex.getVertices();
+  std::vector<Vector3<S>> directions;
+  for (int i = 0; i < 500; ++i) {
+    directions.push_back(Vector3<S>::Random());
+  }
+  for (int axis = 0; axis < 3; ++axis) {
+    directions.push_back(Vector3<S>::Unit(axis));
+    directions.push_back(-Vector3<S>::Unit(axis));
+  }
+
+  for (const Vector3<S>& v_C : directions) {
+    int expected_index = 0;
+    for (int i = 1; i < static_cast<int>(vertices.size()); ++i) {
+      if (v_C.dot(vertices[i]) > v_C.dot(vertices[expected_index])) {
+        expected_index = i;
+      }
+    }
+    const Vector3<S>& extreme = convex.findExtremeVertexNaive(v_C);
+    const S tolerance = 8 * std::numeric_limits<S>::epsilon();
+    EXPECT_NEAR(v_C.dot(extreme), v_C.dot(vertices[expected_index]),
+                tolerance);
+
+    // The ties along the axis directions are exact
+    if (v_C.cwiseAbs().sum() == S(1)) {
+      EXPECT_EQ(&extreme, &vertices[expected_index]);
     }
+  }
+}
+
+GTEST_TEST(ConvexGeometry, SupportVertexNaiveSoA) {
+  std::srand(0);
+  testSupportVertexNaiveSoA(Cube<float>(1.0f));
+  testSupportVertexNaiveSoA(Cube<double>(1.0));
+  testSupportVertexNaiveSoA(EquilateralTetrahedron<float>(2.0f));
+  testSupportVertexNaiveSoA(EquilateralTetrahedron<double>(2.0));
+  // 58 vertices, not a multiple of the SoA padding
+  testSupportVertexNaiveSoA(TessellatedSphere());
 }
 
 // TODO(SeanCurtis-TRI): Add Tetrahedron inertia unit test.
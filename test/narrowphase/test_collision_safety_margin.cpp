@@ -0,0 +1,238 @@
+//
+// Created by Wei Gao on 2026/10/18.
+//
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "fcl/geometry/bvh/BVH_model.h"
+#include "fcl/narrowphase/collision.h"
+#include "fcl/narrowphase/detail/traversal/heightmap/heightmap_solver.h"
+#include "test_fcl_utility.h"
+
+namespace fcl {
+
+template <typename S>
+CollisionRequest<S> makeMarginRequest(S margin) {
+  CollisionRequest<S> request;
+  request.setMaxContactCount(100000);
+  request.setSafetyMargin(margin);
+  return request;
+}
+
+template <typename S>
+bool collideWithMargin(const CollisionGeometry<S>* o1, const Transform3<S>& tf1,
+                       const CollisionGeometry<S>* o2, const Transform3<S>& tf2,
+                       S margin) {
+  const CollisionRequest<S> request = makeMarginRequest(margin);
+  CollisionResult<S> result;
+  return fcl::collide(o1, tf1, o2, tf2, request, result) > 0;
+}
+
+// The sorted primitive indices on o1 of the contacts
+template <typename S>
+std::vector<intptr_t> collidingPrimitives(const CollisionGeometry<S>* o1,
+                                          const Transform3<S>& tf1,
+                                          const CollisionGeometry<S>* o2,
+                                          const Transform3<S>& tf2, S margin) {
+  const CollisionRequest<S> request = makeMarginRequest(margin);
+  CollisionResult<S> result;
+  fcl::collide(o1, tf1, o2, tf2, request, result);
+  std::vector<intptr_t> primitives;
+  for (const auto& contact : result.getContacts())
+    primitives.push_back(contact.b1);
+  std::sort(primitives.begin(), primitives.end());
+  return primitives;
+}
+
+template <typename S>
+void shapePairSafetyMarginTest() {
+  const S margin = 0.1;
+  const Box<S> box(1, 1, 1);
+  const Sphere<S> sphere(0.5);
+  const Ellipsoid<S> ellipsoid(0.5, 0.3, 0.4);
+  const Cylinder<S> cylinder(0.5, 1);
+  const Halfspace<S> halfspace(Vector3<S>::UnitX(), 0);
+  const Plane<S> plane(Vector3<S>::UnitX(), 0);
+  const Transform3<S> identity = Transform3<S>::Identity();
+
+  for (const S gap : {S(0.05), S(0.15)}) {
+    // The pairs are separated by gap along x
+    const bool expected = gap < margin;
+    Transform3<S> tf = Transform3<S>::Identity();
+    tf.translation().x() = 1 + gap;
+    EXPECT_EQ(collideWithMargin<S>(&box, identity, &sphere, tf, margin),
+              expected);
+    EXPECT_EQ(collideWithMargin<S>(&sphere, tf, &box, identity, margin),
+              expected);
+    EXPECT_EQ(collideWithMargin<S>(&box, identity, &box, tf, margin),
+              expected);
+    EXPECT_EQ(collideWithMargin<S>(&sphere, identity, &cylinder, tf, margin),
+              expected);
+    EXPECT_EQ(collideWithMargin<S>(&ellipsoid, identity, &sphere, tf, margin),
+              expected);
+
+    // A box rotated by 45 degrees, whose edge is the closest to the box
+    Transform3<S> tf_rotated = Transform3<S>::Identity();
+    tf_rotated.linear() =
+        AngleAxis<S>(constants<S>::pi() / 4, Vector3<S>::UnitZ()).matrix();
+    tf_rotated.translation().x() = 0.5 + 0.5 * std::sqrt(S(2)) + gap;
+    EXPECT_EQ(collideWithMargin<S>(&box, identity, &box, tf_rotated, margin),
+              expected);
+
+    // The halfspace x <= 0 and plane x = 0
+    Transform3<S> tf_box = Transform3<S>::Identity();
+    tf_box.translation().x() = 0.5 + gap;
+    EXPECT_EQ(collideWithMargin<S>(&halfspace, identity, &box, tf_box, margin),
+              expected);
+    EXPECT_EQ(collideWithMargin<S>(&box, tf_box, &plane, identity, margin),
+              expected);
+    tf_box.translation().x() = -(0.5 + gap);
+    EXPECT_EQ(collideWithMargin<S>(&plane, identity, &box, tf_box, margin),
+              expected);
+    EXPECT_TRUE(
+        collideWithMargin<S>(&halfspace, identity, &box, tf_box, margin));
+
+    // The halfspace x >= gap and plane x = gap
+    const Halfspace<S> halfspace_gap(-Vector3<S>::UnitX(), -gap);
+    const Plane<S> plane_gap(Vector3<S>::UnitX(), gap);
+    EXPECT_EQ(collideWithMargin<S>(&halfspace, identity, &halfspace_gap,
+                                   identity, margin),
+              expected);
+    EXPECT_TRUE(collideWithMargin<S>(&halfspace, identity, &halfspace,
+                                     tf_box, margin));
+    EXPECT_EQ(collideWithMargin<S>(&plane, identity, &plane_gap, identity,
+                                   margin),
+              expected);
+    EXPECT_EQ(collideWithMargin<S>(&plane, identity, &halfspace_gap, identity,
+                                   margin),
+              expected);
+    EXPECT_EQ(collideWithMargin<S>(&halfspace_gap, identity, &plane, identity,
+                                   margin),
+              expected);
+  }
+
+  // Not colliding without margin
+  Transform3<S> tf = Transform3<S>::Identity();
+  tf.translation().x() = 1.05;
+  EXPECT_FALSE(collideWithMargin<S>(&box, identity, &sphere, tf, 0));
+
+  // The margin is ignored if the penetration is enabled
+  CollisionRequest<S> request = makeMarginRequest(margin);
+  request.useDefaultPenetration();
+  CollisionResult<S> result;
+  EXPECT_EQ(fcl::collide(&box, identity, &sphere, tf, request, result), 0);
+}
+
+// The shape within margin of a geometry should collide with the same
+// primitives as the shape inflated by margin. For a sphere the inflated
+// shape is also a sphere.
+template <typename S>
+void expectSameAsInflatedSphere(const CollisionGeometry<S>* geometry,
+                                const Transform3<S>& tf_geometry,
+                                const Transform3<S>& tf_sphere, S radius,
+                                S margin) {
+  const Sphere<S> sphere(radius);
+  const Sphere<S> inflated_sphere(radius + margin);
+  const auto with_margin = collidingPrimitives<S>(geometry, tf_geometry,
+                                                  &sphere, tf_sphere, margin);
+  const auto inflated = collidingPrimitives<S>(
+      geometry, tf_geometry, &inflated_sphere, tf_sphere, S(0));
+  EXPECT_EQ(with_margin, inflated);
+}
+
+template <typename BV>
+void bvhSafetyMarginTest() {
+  using S = typename BV::S;
+  const auto bvh = test::generateBoxBVHModel<BV>(Box<S>(1, 1, 1));
+  const S margin = 0.05;
+  std::array<S, 6> extent{-1, -1, -1, 1, 1, 1};
+  Transform3<S> tf_bvh, tf_sphere;
+  for (int i = 0; i < 100; i++) {
+    test::generateRandomTransform(extent, tf_bvh);
+    test::generateRandomTransform(extent, tf_sphere);
+    expectSameAsInflatedSphere<S>(bvh.get(), tf_bvh, tf_sphere, 0.3, margin);
+  }
+}
+
+template <typename S>
+void octreeSafetyMarginTest() {
+  const auto octree = test::makeRandomPointsAsOctrees<S>(0.05, 16, 200);
+  const S margin = 0.04;
+  std::array<S, 6> extent{-0.5, -0.5, -0.5, 0.5, 0.5, 0.5};
+  Transform3<S> tf_octree, tf_shape;
+  for (int i = 0; i < 20; i++) {
+    test::generateRandomTransform(extent, tf_octree);
+    test::generateRandomTransform(extent, tf_shape);
+    expectSameAsInflatedSphere<S>(octree.get(), tf_octree, tf_shape, 0.1,
+                                  margin);
+
+    // The box goes through the leaf GJK, compare with the leaf voxels
+    const Box<S> box(0.2, 0.1, 0.15);
+    const auto with_margin = collidingPrimitives<S>(
+        octree.get(), tf_octree, &box, tf_shape, margin);
+    detail::GJKSolver<S> solver;
+    std::size_t n_voxels_within_margin = 0;
+    octree->visitLeafNodes([&](const AABB<S>& bv) -> bool {
+      Box<S> voxel;
+      Transform3<S> tf_voxel;
+      constructBox(bv, tf_octree, voxel, tf_voxel);
+      if (solver.shapeIntersectWithMargin(voxel, tf_voxel, box, tf_shape,
+                                          margin))
+        n_voxels_within_margin++;
+      return false;
+    });
+    EXPECT_EQ(with_margin.size(), n_voxels_within_margin);
+  }
+}
+
+template <typename S>
+void heightmapSafetyMarginTest() {
+  auto points = std::make_shared<heightmap::PointCloud>();
+  for (int i = 0; i < 10000; i++) {
+    const Eigen::Vector3f point = Eigen::Vector3f::Random();
+    points->push_back(0.5f * point[0], 0.5f * point[1],
+                      0.15f * (point[2] + 1));
+  }
+  auto layered_heightmap =
+      std::make_shared<heightmap::LayeredHeightMap<S>>(0.01, 64);
+  layered_heightmap->updateHeightsByPointCloud3D(*points);
+  HeightMapCollisionGeometry<S> geometry(layered_heightmap);
+  geometry.computeLocalAABB();
+
+  const S margin = 0.03;
+  std::array<S, 6> extent{-0.4, -0.4, 0, 0.4, 0.4, 0.4};
+  Transform3<S> tf_shape;
+  for (int i = 0; i < 50; i++) {
+    test::generateRandomTransform(extent, tf_shape);
+    expectSameAsInflatedSphere<S>(&geometry, Transform3<S>::Identity(),
+                                  tf_shape, 0.1, margin);
+  }
+}
+
+GTEST_TEST(CollisionSafetyMarginTest, ShapePair) {
+  shapePairSafetyMarginTest<double>();
+  shapePairSafetyMarginTest<float>();
+}
+
+GTEST_TEST(CollisionSafetyMarginTest, BVH) {
+  bvhSafetyMarginTest<AABB<double>>();
+  bvhSafetyMarginTest<OBBRSS<double>>();
+}
+
+GTEST_TEST(CollisionSafetyMarginTest, Octree) {
+  octreeSafetyMarginTest<double>();
+}
+
+GTEST_TEST(CollisionSafetyMarginTest, HeightMap) {
+  heightmapSafetyMarginTest<double>();
+}
+
+}  // namespace fcl
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}